@@ -710,6 +710,11 @@ _adg_do_edit(DemoPart *part)
 
     _adg_part_lock(part);
 
+    adg_model_begin_update(ADG_MODEL(part->body));
+    adg_model_begin_update(ADG_MODEL(part->hole));
+    adg_model_begin_update(ADG_MODEL(part->axis));
+    adg_model_begin_update(ADG_MODEL(part->edges));
+
     adg_model_reset(ADG_MODEL(part->body));
     adg_model_reset(ADG_MODEL(part->hole));
     adg_model_reset(ADG_MODEL(part->axis));
@@ -725,7 +730,12 @@ _adg_do_edit(DemoPart *part)
     adg_model_changed(ADG_MODEL(part->axis));
     adg_model_changed(ADG_MODEL(part->edges));
 
-    gtk_widget_queue_draw(GTK_WIDGET(part->area));
+    adg_model_end_update(ADG_MODEL(part->edges));
+    adg_model_end_update(ADG_MODEL(part->axis));
+    adg_model_end_update(ADG_MODEL(part->hole));
+    adg_model_end_update(ADG_MODEL(part->body));
+
+    adg_gtk_area_queue_damage(part->area);
 }
 
 static void
@@ -54,6 +54,7 @@
 #include "adg-internal.h"
 #include "adg-entity.h"
 #include "adg-container.h"
+#include "adg-container-private.h"
 
 #include "adg-alignment.h"
 #include "adg-alignment-private.h"
@@ -266,7 +267,7 @@ _adg_arrange(AdgEntity *entity)
 {
     AdgAlignmentPrivate *data;
     const CpmlExtents *extents;
-    CpmlExtents new_extents;
+    CpmlExtents new_extents, *floating_extents;
     cairo_matrix_t ctm, ctm_inverted, old_map;
 
     if (_ADG_OLD_ENTITY_CLASS->arrange == NULL)
@@ -310,6 +311,11 @@ _adg_arrange(AdgEntity *entity)
     new_extents.org.x += data->shift.x;
     new_extents.org.y += data->shift.y;
     adg_entity_set_extents(entity, &new_extents);
+
+    /* The floating children are rendered with the same shift */
+    floating_extents = _adg_container_get_floating_extents((AdgContainer *) entity);
+    floating_extents->org.x += data->shift.x;
+    floating_extents->org.y += data->shift.y;
 }
 
 static void
@@ -25,6 +25,11 @@
  * Contains parameters on how to draw arrows, providing a way to register a
  * custom rendering callback.
  *
+ * The arrow shape does not depend on the marker size, that is applied
+ * by the local map, so all the arrows with the same angle share the
+ * same model. That model is built once and must not be modified: use
+ * adg_marker_set_model() to give a custom model to a specific arrow.
+ *
  * <note><para>
  * By default, the #AdgEntity:local-mix property is set to #ADG_MIX_PARENT
  * on #AdgArrow entities.
@@ -73,6 +78,10 @@ static void             _adg_arrange            (AdgEntity      *entity);
 static void             _adg_render             (AdgEntity      *entity,
                                                  cairo_t        *cr);
 static AdgModel *       _adg_create_model       (AdgMarker      *marker);
+static AdgPath *        _adg_build_model        (gdouble         angle);
+
+static GHashTable *     _adg_models = NULL;
+static GMutex           _adg_models_mutex;
 
 
 static void
@@ -138,6 +147,8 @@ _adg_set_property(GObject *object, guint prop_id,
     switch (prop_id) {
     case PROP_ANGLE:
         data->angle = cpml_angle(g_value_get_double(value));
+        /* Pick the model of the new angle on the next arrange */
+        adg_marker_set_model((AdgMarker *) object, NULL);
         break;
     default:
         G_OBJECT_WARN_INVALID_PROPERTY_ID(object, prop_id, pspec);
@@ -274,11 +285,44 @@ _adg_create_model(AdgMarker *marker)
 {
     AdgArrowPrivate *data;
     AdgPath *path;
-    CpmlPair p1, p2;
+    gdouble *key;
 
     data = adg_arrow_get_instance_private((AdgArrow *) marker);
+
+    g_mutex_lock(&_adg_models_mutex);
+
+    if (_adg_models == NULL)
+        _adg_models = g_hash_table_new_full(g_double_hash, g_double_equal,
+                                            g_free, g_object_unref);
+
+    path = g_hash_table_lookup(_adg_models, &data->angle);
+    if (path == NULL) {
+        path = _adg_build_model(data->angle);
+
+        /* Fill the caches now: from here on the model is only read,
+         * possibly by different threads at the same time */
+        adg_trail_get_cairo_path((AdgTrail *) path);
+        adg_trail_get_extents((AdgTrail *) path);
+
+        key = g_new(gdouble, 1);
+        *key = data->angle;
+        g_hash_table_insert(_adg_models, key, path);
+    }
+
+    g_object_ref(path);
+    g_mutex_unlock(&_adg_models_mutex);
+
+    return (AdgModel *) path;
+}
+
+static AdgPath *
+_adg_build_model(gdouble angle)
+{
+    AdgPath *path;
+    CpmlPair p1, p2;
+
     path = adg_path_new();
-    cpml_vector_from_angle(&p1, data->angle / 2);
+    cpml_vector_from_angle(&p1, angle / 2);
     p2.x = p1.x;
     p2.y = -p1.y;
 
@@ -287,5 +331,5 @@ _adg_create_model(AdgMarker *marker)
     adg_path_line_to(path, &p2);
     adg_path_close(path);
 
-    return (AdgModel *) path;
+    return path;
 }
@@ -30,12 +30,14 @@ struct _AdgCanvasPrivate {
     CpmlPair       size;
     gdouble        factor;
     gchar        **scales;
+    gdouble       *factors;
     AdgDress       background_dress;
     AdgDress       frame_dress;
     AdgTitleBlock *title_block;
     gdouble        top_margin, right_margin, bottom_margin, left_margin;
     gboolean       has_frame;
     gdouble        top_padding, right_padding, bottom_padding, left_padding;
+    GArray        *damage;
 };
 
 G_END_DECLS
@@ -31,6 +31,13 @@
  * border and paddings. This approach clearly follows the block model
  * of the CSS specification.
  *
+ * Independent canvases can be exported concurrently from different
+ * threads, as long as they do not share any entity or explicitely set
+ * style and every thread enabled its private fallback styles with
+ * adg_dress_switch_thread_fallbacks(). adg_canvas_export_batch()
+ * takes care of all of this and exports many canvases at once on a
+ * pool of worker threads.
+ *
  * The paddings specify the distance between the entities contained
  * by the canvas and the border. The margins specify the distance
  * between the canvas border and the media extents.
@@ -117,6 +124,20 @@
 #define _ADG_OLD_OBJECT_CLASS  ((GObjectClass *) adg_canvas_parent_class)
 #define _ADG_OLD_ENTITY_CLASS  ((AdgEntityClass *) adg_canvas_parent_class)
 
+/* Maximum number of damaged areas tracked separately: when this
+ * limit is exceeded, all the damaged areas are merged into one */
+#define _ADG_MAX_DAMAGE        32
+
+
+typedef struct _AdgExportJob AdgExportJob;
+
+struct _AdgExportJob {
+    AdgCanvas              *canvas;
+    cairo_surface_type_t    type;
+    const gchar            *file;
+    GError                 *error;
+};
+
 
 G_DEFINE_TYPE_WITH_PRIVATE(AdgCanvas, adg_canvas, ADG_TYPE_CONTAINER)
 
@@ -155,8 +176,26 @@ static void             _adg_invalidate         (AdgEntity      *entity);
 static void             _adg_arrange            (AdgEntity      *entity);
 static void             _adg_render             (AdgEntity      *entity,
                                                  cairo_t        *cr);
+static void             _adg_arrange_scale      (AdgCanvas      *canvas,
+                                                 gdouble         factor);
+static void             _adg_append_extents     (AdgEntity      *entity,
+                                                 GArray         *array);
+static gint             _adg_predict_scale      (AdgCanvas      *canvas,
+                                                 const gdouble  *factors,
+                                                 gint            n_scales);
+static gboolean         _adg_scale_fits         (AdgCanvas      *canvas,
+                                                 gint            n,
+                                                 CpmlExtents    *extents);
+static gint             _adg_find_scale         (AdgCanvas      *canvas,
+                                                 gint            from,
+                                                 gint            to,
+                                                 gint           *n_last,
+                                                 CpmlExtents    *extents);
+static gdouble *        _adg_parse_scales       (gchar         **scales);
 static void             _adg_apply_paddings     (AdgCanvas      *canvas,
                                                  CpmlExtents    *extents);
+static void             _adg_export_job         (gpointer        job_data,
+                                                 gpointer        user_data);
 static void             _adg_update_margin      (AdgCanvas      *canvas,
                                                  gdouble        *margin,
                                                  gdouble        *side,
@@ -322,6 +361,7 @@ adg_canvas_init(AdgCanvas *canvas)
     data->size.y = 0;
     data->factor = 1;
     data->scales = g_strdupv((gchar **) scales);
+    data->factors = _adg_parse_scales(data->scales);
     data->background_dress = ADG_DRESS_COLOR_BACKGROUND;
     data->frame_dress = ADG_DRESS_LINE_FRAME;
     data->title_block = NULL;
@@ -334,6 +374,7 @@ adg_canvas_init(AdgCanvas *canvas)
     data->right_padding = 15;
     data->bottom_padding = 15;
     data->left_padding = 15;
+    data->damage = g_array_new(FALSE, FALSE, sizeof(CpmlExtents));
 }
 
 static void
@@ -352,6 +393,14 @@ _adg_dispose(GObject *object)
         data->scales = NULL;
     }
 
+    g_free(data->factors);
+    data->factors = NULL;
+
+    if (data->damage != NULL) {
+        g_array_free(data->damage, TRUE);
+        data->damage = NULL;
+    }
+
     if (_ADG_OLD_OBJECT_CLASS->dispose)
         _ADG_OLD_OBJECT_CLASS->dispose(object);
 }
@@ -435,7 +484,9 @@ _adg_set_property(GObject *object, guint prop_id,
         break;
     case PROP_SCALES:
         g_strfreev(data->scales);
+        g_free(data->factors);
         data->scales = g_value_dup_boxed(value);
+        data->factors = _adg_parse_scales(data->scales);
         break;
     case PROP_BACKGROUND_DRESS:
         data->background_dress = g_value_get_enum(value);
@@ -745,18 +796,30 @@ adg_canvas_get_scales(AdgCanvas *canvas)
  * The paddings are taken into account while computing the drawing
  * extents.
  *
+ * To avoid arranging the whole drawing for every scale, the extents
+ * of the children of @canvas are computed only with the smallest and
+ * the greatest scale and interpolated for the other ones: the model
+ * geometry scales linearly while the annotations keep their size, so
+ * the extents of every child are expected to be a linear function of
+ * the scale. The scanning then starts from the first scale predicted
+ * to fit and, as children that are not linear (e.g. containers with
+ * fixed size annotations) can make the prediction wrong, steps back
+ * while the previous scales fit too, so the selected scale is the
+ * same a scan of every scale in order would select.
+ *
  * Since: 1.0
  **/
 void
 adg_canvas_autoscale(AdgCanvas *canvas)
 {
     AdgCanvasPrivate *data;
-    gchar **p_scale;
+    gint n, n_scales, n_start, n_fit, n_last, n_end;
+    const gdouble *factors;
     AdgEntity *entity;
-    cairo_matrix_t map;
     CpmlExtents extents;
     AdgTitleBlock *title_block;
     CpmlPair delta;
+    cairo_matrix_t transform;
 
     g_return_if_fail(ADG_IS_CANVAS(canvas));
     g_return_if_fail(_ADG_OLD_ENTITY_CLASS->arrange != NULL);
@@ -769,47 +832,61 @@ adg_canvas_autoscale(AdgCanvas *canvas)
      * signal does not invalidate the global matrix: let's do it right now */
     adg_entity_global_changed(entity);
 
-    for (p_scale = data->scales; p_scale != NULL && *p_scale != NULL; ++p_scale) {
-        const gchar *scale = *p_scale;
-        gdouble factor = adg_scale_factor(scale);
-        if (factor <= 0)
-            continue;
+    n_scales = data->scales != NULL ? g_strv_length(data->scales) : 0;
+    factors = data->factors;
+    n_last = -1;
+    extents.is_defined = 0;
 
-        cairo_matrix_init_scale(&map, factor, factor);
-        adg_entity_set_local_map(entity, &map);
-        adg_entity_local_changed(entity);
+    n_start = _adg_predict_scale(canvas, factors, n_scales);
+    n_fit = _adg_find_scale(canvas, n_start, n_scales, &n_last, &extents);
 
-        /* Arrange the entities inside the canvas, but not the canvas itself,
-         * just to get the bounding box of the drawing without the paper */
-        _ADG_OLD_ENTITY_CLASS->arrange(entity);
-        cpml_extents_copy(&extents, adg_entity_get_extents(entity));
+    if (n_fit > 0 && n_fit == n_start) {
+        /* The prediction could have skipped some fitting scale:
+         * step back while the previous valid scales fit too */
+        for (n = n_fit - 1; n >= 0; --n) {
+            if (factors[n] <= 0)
+                continue;
 
-        /* Just in case @canvas is empty */
-        if (! extents.is_defined)
-            return;
+            n_last = n;
+            if (! _adg_scale_fits(canvas, n, &extents))
+                break;
 
-        _adg_apply_paddings(canvas, &extents);
+            n_fit = n;
+        }
+    } else if (n_fit < 0 && n_start > 0 && extents.is_defined) {
+        /* Nothing fits from the predicted scale on: check the
+         * previous scales before giving up on the last one */
+        n_end = n_last;
+        n_fit = _adg_find_scale(canvas, 0, n_start, &n_last, &extents);
+        if (n_fit < 0) {
+            n_last = n_end;
+            _adg_scale_fits(canvas, n_last, &extents);
+        }
+    }
+
+    /* Leave the drawing arranged at the selected scale */
+    if (n_fit >= 0 && n_last != n_fit) {
+        n_last = n_fit;
+        _adg_scale_fits(canvas, n_last, &extents);
+    }
 
-        if (title_block != NULL)
-            adg_title_block_set_scale(title_block, scale);
+    /* Just in case @canvas is empty or there are no valid scales */
+    if (n_last < 0 || ! extents.is_defined)
+        return;
 
-        /* Bail out if paper size is not specified or invalid */
-        if (data->size.x <= 0 || data->size.y <= 0)
-            break;
+    if (title_block != NULL)
+        adg_title_block_set_scale(title_block, data->scales[n_last]);
 
-        /* If the drawing extents are fully contained inside the paper size,
-         * center the drawing in the paper and bail out */
+    /* If the drawing extents are fully contained inside the paper size,
+     * center the drawing in the paper */
+    if (n_fit >= 0) {
         delta.x = data->size.x - extents.size.x;
         delta.y = data->size.y - extents.size.y;
-        if (delta.x >= 0 && delta.y >= 0) {
-            cairo_matrix_t transform;
-            cairo_matrix_init_translate(&transform,
-                                        delta.x / 2 - extents.org.x,
-                                        delta.y / 2 - extents.org.y);
-            adg_entity_transform_local_map(entity, &transform,
-                                           ADG_TRANSFORM_AFTER);
-            break;
-        }
+        cairo_matrix_init_translate(&transform,
+                                    delta.x / 2 - extents.org.x,
+                                    delta.y / 2 - extents.org.y);
+        adg_entity_transform_local_map(entity, &transform,
+                                       ADG_TRANSFORM_AFTER);
     }
 }
 
@@ -1434,6 +1511,119 @@ adg_canvas_get_paddings(AdgCanvas *canvas,
     }
 }
 
+/**
+ * adg_canvas_add_damage:
+ * @canvas: an #AdgCanvas
+ * @extents: the damaged area
+ *
+ * <note><para>
+ * This function is only useful in entity implementations.
+ * </para></note>
+ *
+ * Marks the @extents area of @canvas as damaged, that is the
+ * portion of the drawing that must be repainted to be up to date.
+ * @extents must be expressed in the same space of the extents
+ * returned by adg_entity_get_extents().
+ *
+ * #AdgEntity automatically calls this function on its canvas with
+ * the old extents when invalidated and with the new extents when
+ * arranged again, so it is seldom required to call it directly.
+ *
+ * Since: 1.0
+ **/
+void
+adg_canvas_add_damage(AdgCanvas *canvas, const CpmlExtents *extents)
+{
+    AdgCanvasPrivate *data;
+    CpmlExtents *damage;
+    guint n;
+
+    g_return_if_fail(ADG_IS_CANVAS(canvas));
+    g_return_if_fail(extents != NULL);
+
+    data = adg_canvas_get_instance_private(canvas);
+
+    if (data->damage == NULL || ! extents->is_defined)
+        return;
+
+    damage = (CpmlExtents *) data->damage->data;
+
+    /* Skip areas already damaged */
+    for (n = 0; n < data->damage->len; ++n)
+        if (cpml_extents_is_inside(&damage[n], extents))
+            return;
+
+    if (data->damage->len < _ADG_MAX_DAMAGE) {
+        g_array_append_val(data->damage, *extents);
+        return;
+    }
+
+    /* Too many areas: collapse them into a single one */
+    for (n = 1; n < data->damage->len; ++n)
+        cpml_extents_add(&damage[0], &damage[n]);
+    cpml_extents_add(&damage[0], extents);
+    g_array_set_size(data->damage, 1);
+}
+
+/**
+ * adg_canvas_get_damage:
+ * @canvas: an #AdgCanvas
+ * @n_damage: (out): where to store the number of damaged areas
+ *
+ * Gets the areas of @canvas damaged since the last call to
+ * adg_canvas_reset_damage(). The returned array is owned by
+ * @canvas and should not be modified or freed.
+ *
+ * The damaged areas are tracked by invalidating and arranging
+ * the entities, so adg_entity_arrange() should be called on
+ * @canvas before this function to get the new extents of the
+ * invalidated entities.
+ *
+ * Returns: (array length=n_damage): the damaged areas or <constant>NULL</constant> if nothing has been damaged or on errors.
+ *
+ * Since: 1.0
+ **/
+const CpmlExtents *
+adg_canvas_get_damage(AdgCanvas *canvas, guint *n_damage)
+{
+    AdgCanvasPrivate *data;
+
+    g_return_val_if_fail(ADG_IS_CANVAS(canvas), NULL);
+    g_return_val_if_fail(n_damage != NULL, NULL);
+
+    data = adg_canvas_get_instance_private(canvas);
+
+    if (data->damage == NULL || data->damage->len == 0) {
+        *n_damage = 0;
+        return NULL;
+    }
+
+    *n_damage = data->damage->len;
+    return (const CpmlExtents *) data->damage->data;
+}
+
+/**
+ * adg_canvas_reset_damage:
+ * @canvas: an #AdgCanvas
+ *
+ * Clears all the damaged areas of @canvas. This is usually called
+ * after the damaged areas have been repainted.
+ *
+ * Since: 1.0
+ **/
+void
+adg_canvas_reset_damage(AdgCanvas *canvas)
+{
+    AdgCanvasPrivate *data;
+
+    g_return_if_fail(ADG_IS_CANVAS(canvas));
+
+    data = adg_canvas_get_instance_private(canvas);
+
+    if (data->damage != NULL)
+        g_array_set_size(data->damage, 0);
+}
+
 
 static void
 _adg_global_changed(AdgEntity *entity)
@@ -1596,6 +1786,192 @@ _adg_render(AdgEntity *entity, cairo_t *cr)
         _ADG_OLD_ENTITY_CLASS->render(entity, cr);
 }
 
+static void
+_adg_arrange_scale(AdgCanvas *canvas, gdouble factor)
+{
+    AdgEntity *entity = (AdgEntity *) canvas;
+    cairo_matrix_t map;
+
+    cairo_matrix_init_scale(&map, factor, factor);
+    adg_entity_set_local_map(entity, &map);
+    adg_entity_local_changed(entity);
+    _ADG_OLD_ENTITY_CLASS->arrange(entity);
+}
+
+static void
+_adg_append_extents(AdgEntity *entity, GArray *array)
+{
+    /* Floating entities are not included in the canvas extents but
+     * they are appended anyway (as undefined) to keep the indexes */
+    if (adg_entity_has_floating(entity)) {
+        CpmlExtents extents = { 0 };
+        g_array_append_val(array, extents);
+    } else {
+        g_array_append_vals(array, adg_entity_get_extents(entity), 1);
+    }
+}
+
+/* Returns the index of the first scale expected to fit the paper, as
+ * predicted by interpolating the extents of the children arranged at
+ * the minimum and maximum scale. If no scale fits, the index of the
+ * last valid scale is returned. 0 is returned when the prediction is
+ * not possible, e.g. when there are too few scales or the paper size
+ * is not defined */
+static gint
+_adg_predict_scale(AdgCanvas *canvas, const gdouble *factors, gint n_scales)
+{
+    AdgCanvasPrivate *data;
+    GArray *min_array, *max_array;
+    const CpmlExtents *min_extents, *max_extents;
+    CpmlExtents extents, child;
+    gint n, n_min, n_max, n_valid, n_last, result;
+    gdouble t;
+    guint k;
+
+    data = adg_canvas_get_instance_private(canvas);
+    if (data->size.x <= 0 || data->size.y <= 0)
+        return 0;
+
+    n_min = n_max = n_last = -1;
+    n_valid = 0;
+    for (n = 0; n < n_scales; ++n) {
+        if (factors[n] <= 0)
+            continue;
+        if (n_min < 0 || factors[n] < factors[n_min])
+            n_min = n;
+        if (n_max < 0 || factors[n] > factors[n_max])
+            n_max = n;
+        n_last = n;
+        ++n_valid;
+    }
+
+    /* With less than three scales there is nothing to gain */
+    if (n_valid < 3 || factors[n_min] == factors[n_max])
+        return 0;
+
+    min_array = g_array_new(FALSE, FALSE, sizeof(CpmlExtents));
+    max_array = g_array_new(FALSE, FALSE, sizeof(CpmlExtents));
+
+    _adg_arrange_scale(canvas, factors[n_min]);
+    adg_container_foreach((AdgContainer *) canvas,
+                          G_CALLBACK(_adg_append_extents), min_array);
+    _adg_arrange_scale(canvas, factors[n_max]);
+    adg_container_foreach((AdgContainer *) canvas,
+                          G_CALLBACK(_adg_append_extents), max_array);
+
+    result = min_array->len == max_array->len ? n_last : 0;
+
+    for (n = 0; result > 0 && n < n_scales; ++n) {
+        if (factors[n] <= 0)
+            continue;
+
+        t = (factors[n] - factors[n_min]) / (factors[n_max] - factors[n_min]);
+        extents.is_defined = 0;
+
+        for (k = 0; k < min_array->len; ++k) {
+            min_extents = &g_array_index(min_array, CpmlExtents, k);
+            max_extents = &g_array_index(max_array, CpmlExtents, k);
+
+            /* A child that appears or disappears cannot be predicted */
+            if (min_extents->is_defined != max_extents->is_defined) {
+                result = 0;
+                break;
+            }
+
+            if (! min_extents->is_defined)
+                continue;
+
+            child.is_defined = 1;
+            child.org.x = min_extents->org.x + (max_extents->org.x - min_extents->org.x) * t;
+            child.org.y = min_extents->org.y + (max_extents->org.y - min_extents->org.y) * t;
+            child.size.x = min_extents->size.x + (max_extents->size.x - min_extents->size.x) * t;
+            child.size.y = min_extents->size.y + (max_extents->size.y - min_extents->size.y) * t;
+            cpml_extents_add(&extents, &child);
+        }
+
+        /* Let the real arrange deal with empty canvas */
+        if (! extents.is_defined)
+            result = 0;
+
+        if (result == 0)
+            break;
+
+        _adg_apply_paddings(canvas, &extents);
+        if (extents.size.x <= data->size.x && extents.size.y <= data->size.y) {
+            result = n;
+            break;
+        }
+    }
+
+    g_array_free(min_array, TRUE);
+    g_array_free(max_array, TRUE);
+
+    return result;
+}
+
+/* Arranges @canvas at the @n scale and checks if the drawing, paddings
+ * included, can be entirely contained into the paper. The extents of
+ * the drawing are returned in @extents */
+static gboolean
+_adg_scale_fits(AdgCanvas *canvas, gint n, CpmlExtents *extents)
+{
+    AdgCanvasPrivate *data = adg_canvas_get_instance_private(canvas);
+
+    /* Arrange the entities inside the canvas, but not the canvas itself,
+     * just to get the bounding box of the drawing without the paper */
+    _adg_arrange_scale(canvas, data->factors[n]);
+    cpml_extents_copy(extents, adg_entity_get_extents((AdgEntity *) canvas));
+    if (! extents->is_defined)
+        return FALSE;
+
+    _adg_apply_paddings(canvas, extents);
+
+    return data->size.x > 0 && data->size.y > 0 &&
+           extents->size.x <= data->size.x && extents->size.y <= data->size.y;
+}
+
+/* Returns the index of the first scale in the [from, to) range that
+ * fits the paper or -1 if none fits. In both cases @n_last is set to
+ * the last scale arranged and @extents to the drawing extents */
+static gint
+_adg_find_scale(AdgCanvas *canvas, gint from, gint to,
+                gint *n_last, CpmlExtents *extents)
+{
+    AdgCanvasPrivate *data = adg_canvas_get_instance_private(canvas);
+    gint n;
+
+    for (n = from; n < to; ++n) {
+        if (data->factors[n] <= 0)
+            continue;
+
+        *n_last = n;
+        if (_adg_scale_fits(canvas, n, extents))
+            return n;
+
+        /* Bail out if @canvas is empty or the paper size is invalid */
+        if (! extents->is_defined || data->size.x <= 0 || data->size.y <= 0)
+            break;
+    }
+
+    return -1;
+}
+
+static gdouble *
+_adg_parse_scales(gchar **scales)
+{
+    gdouble *factors;
+    guint n, n_scales;
+
+    /* Parse the scales only once, when they are set, so autoscaling
+     * does not need to go through the strings anymore */
+    n_scales = scales != NULL ? g_strv_length(scales) : 0;
+    factors = g_new(gdouble, n_scales + 1);
+    for (n = 0; n < n_scales; ++n)
+        factors[n] = adg_scale_factor(scales[n]);
+
+    return factors;
+}
+
 static void
 _adg_apply_paddings(AdgCanvas *canvas, CpmlExtents *extents)
 {
@@ -1606,6 +1982,23 @@ _adg_apply_paddings(AdgCanvas *canvas, CpmlExtents *extents)
     extents->size.y += data->top_padding + data->bottom_padding;
 }
 
+static void
+_adg_export_job(gpointer job_data, gpointer user_data)
+{
+    AdgExportJob *job = (AdgExportJob *) job_data;
+
+    /* Worker threads must not touch the shared fallback styles. The
+     * pool is exclusive, so the clones are kept alive across the jobs
+     * of the same worker and are released when the worker exits. */
+    adg_dress_switch_thread_fallbacks(TRUE);
+
+    if (! adg_canvas_export(job->canvas, job->type, job->file, &job->error) &&
+        job->error == NULL) {
+        g_set_error(&job->error, ADG_CANVAS_ERROR, ADG_CANVAS_ERROR_CAIRO,
+                    "unable to export to '%s'", job->file);
+    }
+}
+
 
 /**
  * adg_canvas_export:
@@ -1710,6 +2103,94 @@ adg_canvas_export(AdgCanvas *canvas, cairo_surface_type_t type,
     return TRUE;
 }
 
+/**
+ * adg_canvas_export_batch:
+ * @canvases: (array length=n_canvases): the canvases to export
+ * @files: (array length=n_canvases): the destination file of every canvas
+ * @n_canvases: number of items in @canvases and @files
+ * @type: (type gint): the export format
+ * @max_threads: maximum number of worker threads or <constant>0</constant>
+ *               to use one thread per available processor
+ * @gerror: (allow-none): return location for errors
+ *
+ * Exports every canvas in @canvases to the matching file in @files,
+ * as adg_canvas_export() does, spreading the work on a pool of at
+ * most @max_threads threads. The function returns only when all the
+ * canvases have been exported.
+ *
+ * The canvases must be independent, that is no entity, model or
+ * style explicitely set with adg_entity_set_style() can be shared
+ * between two of them, and they must not be modified until this
+ * function returns. The fallback styles are not an issue: every
+ * worker uses its own clones (see adg_dress_switch_thread_fallbacks()).
+ *
+ * All the exports are attempted even when some of them fail. In that
+ * case the error of the first failed canvas (in @canvases order)
+ * is reported in @gerror.
+ *
+ * Returns: <constant>TRUE</constant> if all the canvases have been exported, <constant>FALSE</constant> otherwise.
+ *
+ * Since: 1.0
+ **/
+gboolean
+adg_canvas_export_batch(AdgCanvas **canvases, const gchar **files,
+                        guint n_canvases, cairo_surface_type_t type,
+                        gint max_threads, GError **gerror)
+{
+    AdgExportJob *jobs, *job;
+    GThreadPool *pool;
+    gboolean result;
+    guint n;
+
+    g_return_val_if_fail(canvases != NULL || n_canvases == 0, FALSE);
+    g_return_val_if_fail(files != NULL || n_canvases == 0, FALSE);
+    g_return_val_if_fail(gerror == NULL || *gerror == NULL, FALSE);
+
+    for (n = 0; n < n_canvases; ++n) {
+        g_return_val_if_fail(ADG_IS_CANVAS(canvases[n]), FALSE);
+        g_return_val_if_fail(files[n] != NULL, FALSE);
+    }
+
+    if (max_threads <= 0)
+        max_threads = g_get_num_processors();
+
+    pool = g_thread_pool_new(_adg_export_job, NULL,
+                             MIN((guint) max_threads, MAX(n_canvases, 1)),
+                             TRUE, gerror);
+    if (pool == NULL)
+        return FALSE;
+
+    jobs = g_new0(AdgExportJob, n_canvases);
+    for (n = 0; n < n_canvases; ++n) {
+        job = &jobs[n];
+        job->canvas = canvases[n];
+        job->type = type;
+        job->file = files[n];
+        job->error = NULL;
+        g_thread_pool_push(pool, job, NULL);
+    }
+
+    /* Wait for all the pending jobs to be completed */
+    g_thread_pool_free(pool, FALSE, TRUE);
+
+    result = TRUE;
+    for (n = 0; n < n_canvases; ++n) {
+        job = &jobs[n];
+        if (job->error == NULL)
+            continue;
+
+        if (result)
+            g_propagate_error(gerror, job->error);
+        else
+            g_error_free(job->error);
+
+        result = FALSE;
+    }
+
+    g_free(jobs);
+    return result;
+}
+
 
 #if GTK3_ENABLED || GTK2_ENABLED
 #include <gtk/gtk.h>
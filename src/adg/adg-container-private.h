@@ -24,12 +24,30 @@
 
 G_BEGIN_DECLS
 
+typedef struct _AdgContainerNode AdgContainerNode;
 typedef struct _AdgContainerPrivate AdgContainerPrivate;
 
+struct _AdgContainerNode {
+    CpmlExtents  extents;
+    gboolean     partial;
+    AdgEntity   *entity;
+    guint        order;
+    guint        left, right;
+};
+
 struct _AdgContainerPrivate {
-    GSList      *children;
+    GPtrArray   *children;
+    guint        n_iterators;
+    gboolean     has_holes;
+    GArray      *index;
+    gboolean     index_dirty;
+    CpmlExtents  floating_extents;
 };
 
+
+CpmlExtents *   _adg_container_get_floating_extents
+                                                (AdgContainer   *container);
+
 G_END_DECLS
 
 
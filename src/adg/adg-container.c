@@ -32,6 +32,19 @@
  * when destroyed and it will be able to update its children when an entity
  * is destroyed.
  *
+ * The children are stored in a contiguous array in insertion order.
+ * adg_container_foreach() and the adg_container_propagate() family
+ * walk this array directly, without copying it: children added
+ * during a traversal are not visited by that traversal while children
+ * removed during a traversal are skipped.
+ *
+ * The extents of the children are kept in a bounding volume hierarchy,
+ * rebuilt when children are added or removed and refitted on every
+ * arrange. The rendering uses it to skip the children outside the
+ * clipping area and adg_container_query_extents() or
+ * adg_container_query_pair() use it to find the children in a given
+ * area without scanning all of them.
+ *
  * Since: 1.0
  **/
 
@@ -51,8 +64,11 @@
  * @add:      signal that adds a new entity to the container.
  * @remove:   signal that removes a specific entity from the container.
  *
- * #AdgContainer effectively stores a #GSList of children into its
+ * #AdgContainer effectively stores an array of children into its
  * private data and keeps a reference to every child it owns.
+ * Overriding @children is still supported but it disables the
+ * allocation-free traversal of adg_container_foreach() and
+ * adg_container_propagate_valist().
  *
  * Since: 1.0
  **/
@@ -62,6 +78,7 @@
 
 #include "adg-container.h"
 #include "adg-container-private.h"
+#include "adg-entity-private.h"
 
 
 #define _ADG_PARENT_OBJECT_CLASS  ((GObjectClass *) adg_container_parent_class)
@@ -83,6 +100,7 @@ enum {
 
 
 static void             _adg_dispose            (GObject        *object);
+static void             _adg_finalize           (GObject        *object);
 static void             _adg_set_property       (GObject        *object,
                                                  guint           prop_id,
                                                  const GValue   *value,
@@ -94,15 +112,38 @@ static void             _adg_invalidate         (AdgEntity      *entity);
 static void             _adg_arrange            (AdgEntity      *entity);
 static void             _adg_add_extents        (AdgEntity      *entity,
                                                  CpmlExtents    *extents);
+static void             _adg_add_floating_extents
+                                                (AdgEntity      *entity,
+                                                 CpmlExtents    *extents);
 static void             _adg_render             (AdgEntity      *entity,
                                                  cairo_t        *cr);
 static GSList *         _adg_children           (AdgContainer   *container);
+static void             _adg_children_lock      (AdgContainer   *container);
+static void             _adg_children_unlock    (AdgContainer   *container);
+static gboolean         _adg_children_drop      (AdgContainer   *container,
+                                                 AdgEntity      *entity);
 static void             _adg_add                (AdgContainer   *container,
                                                  AdgEntity      *entity);
 static void             _adg_remove             (AdgContainer   *container,
                                                  AdgEntity      *entity);
 static void             _adg_remove_from_list   (gpointer        container,
                                                  GObject        *entity);
+static gboolean         _adg_has_floating_extents
+                                                (AdgEntity      *entity);
+static void             _adg_index_reset        (AdgContainer   *container);
+static void             _adg_index_build        (AdgContainer   *container);
+static guint            _adg_index_split        (GArray         *index,
+                                                 AdgContainerNode *leaves,
+                                                 guint           n_leaves);
+static void             _adg_index_refit        (AdgContainer   *container);
+static GSList *         _adg_index_query        (AdgContainer   *container,
+                                                 const CpmlExtents *extents,
+                                                 gboolean        partial);
+static void             _adg_index_lookup       (GArray         *index,
+                                                 guint           n,
+                                                 const CpmlExtents *extents,
+                                                 gboolean        partial,
+                                                 GPtrArray      *hits);
 
 static guint            _adg_signals[LAST_SIGNAL] = { 0 };
 
@@ -118,6 +159,7 @@ adg_container_class_init(AdgContainerClass *klass)
     entity_class = (AdgEntityClass *) klass;
 
     gobject_class->dispose = _adg_dispose;
+    gobject_class->finalize = _adg_finalize;
     gobject_class->set_property = _adg_set_property;
 
     entity_class->destroy = _adg_destroy;
@@ -178,7 +220,12 @@ static void
 adg_container_init(AdgContainer *container)
 {
     AdgContainerPrivate *data = adg_container_get_instance_private(container);
-    data->children = NULL;
+    data->children = g_ptr_array_new();
+    data->n_iterators = 0;
+    data->has_holes = FALSE;
+    data->index = g_array_new(FALSE, FALSE, sizeof(AdgContainerNode));
+    data->index_dirty = TRUE;
+    data->floating_extents.is_defined = 0;
 }
 
 static void
@@ -186,18 +233,37 @@ _adg_dispose(GObject *object)
 {
     AdgContainer *container = (AdgContainer *) object;
     AdgContainerPrivate *data = adg_container_get_instance_private(container);
+    AdgEntity *entity;
+    guint n;
 
     /* Remove all the children from the container: these will emit
      * a "remove" signal for every child and will drop all the
      * references from the children to this container (and, obviously,
      * from the container to the children). */
-    while (data->children != NULL)
-        adg_container_remove(container, (AdgEntity *) data->children->data);
+    _adg_children_lock(container);
+    for (n = data->children->len; n > 0; --n) {
+        entity = g_ptr_array_index(data->children, n - 1);
+        if (entity != NULL)
+            adg_container_remove(container, entity);
+    }
+    _adg_children_unlock(container);
 
     if (_ADG_PARENT_OBJECT_CLASS->dispose)
         _ADG_PARENT_OBJECT_CLASS->dispose(object);
 }
 
+static void
+_adg_finalize(GObject *object)
+{
+    AdgContainerPrivate *data = adg_container_get_instance_private((AdgContainer *) object);
+
+    g_ptr_array_free(data->children, TRUE);
+    g_array_free(data->index, TRUE);
+
+    if (_ADG_PARENT_OBJECT_CLASS->finalize)
+        _ADG_PARENT_OBJECT_CLASS->finalize(object);
+}
+
 static void
 _adg_set_property(GObject *object,
                   guint prop_id, const GValue *value, GParamSpec *pspec)
@@ -325,8 +391,10 @@ adg_container_children(AdgContainer *container)
  * @callback: (scope call): a callback
  * @user_data: callback user data
  *
- * Invokes @callback on each child of @container.
- * The callback should be declared as:
+ * Invokes @callback on each child of @container, from the most
+ * recently added child to the oldest one. @callback can add or
+ * remove children: the added ones will not be visited while the
+ * removed ones are skipped. The callback should be declared as:
  *
  * <informalexample><programlisting language="C">
  * void callback(AdgEntity *entity, gpointer user_data);
@@ -338,19 +406,97 @@ void
 adg_container_foreach(AdgContainer *container,
                       GCallback callback, gpointer user_data)
 {
+    AdgContainerPrivate *data;
     GSList *children;
+    AdgEntity *entity;
+    guint n;
 
     g_return_if_fail(ADG_IS_CONTAINER(container));
     g_return_if_fail(callback != NULL);
 
-    children = adg_container_children(container);
+    if (ADG_CONTAINER_GET_CLASS(container)->children != _adg_children) {
+        /* Custom children implementation: iterate over a snapshot */
+        children = adg_container_children(container);
 
-    while (children != NULL) {
-        if (children->data != NULL)
-            ((void (*) (gpointer, gpointer)) callback) (children->data, user_data);
+        while (children != NULL) {
+            if (children->data != NULL)
+                ((void (*) (gpointer, gpointer)) callback) (children->data, user_data);
 
-        children = g_slist_delete_link(children, children);
+            children = g_slist_delete_link(children, children);
+        }
+        return;
+    }
+
+    data = adg_container_get_instance_private(container);
+
+    _adg_children_lock(container);
+    for (n = data->children->len; n > 0; --n) {
+        entity = g_ptr_array_index(data->children, n - 1);
+        if (entity != NULL)
+            ((void (*) (gpointer, gpointer)) callback) (entity, user_data);
     }
+    _adg_children_unlock(container);
+}
+
+/**
+ * adg_container_query_extents:
+ * @container: an #AdgContainer
+ * @extents: the area to check
+ *
+ * Gets the children of @container whose extents intersect @extents.
+ * The lookup is performed on the extents computed by the last
+ * arrange of @container, so call adg_entity_arrange() before if the
+ * children could have been changed in the meantime. Children with
+ * undefined extents are never returned.
+ *
+ * @extents must be expressed in the same space of the children
+ * extents, that is the global space of @container. This function
+ * does not descend into nested containers.
+ *
+ * The returned list has the same order of adg_container_children()
+ * and must be freed with g_slist_free() when no longer used.
+ *
+ * Returns: (element-type AdgEntity) (transfer container): a newly allocated #GSList of #AdgEntity or <constant>NULL</constant> on no children found or errors
+ *
+ * Since: 1.0
+ **/
+GSList *
+adg_container_query_extents(AdgContainer *container, const CpmlExtents *extents)
+{
+    g_return_val_if_fail(ADG_IS_CONTAINER(container), NULL);
+    g_return_val_if_fail(extents != NULL, NULL);
+
+    return _adg_index_query(container, extents, FALSE);
+}
+
+/**
+ * adg_container_query_pair:
+ * @container: an #AdgContainer
+ * @pair: the point to check
+ *
+ * Gets the children of @container whose extents contain @pair. This is
+ * a convenient wrapper around adg_container_query_extents() that can be
+ * used to implement hit-testing, e.g. to find the entities under the
+ * mouse pointer.
+ *
+ * Returns: (element-type AdgEntity) (transfer container): a newly allocated #GSList of #AdgEntity or <constant>NULL</constant> on no children found or errors
+ *
+ * Since: 1.0
+ **/
+GSList *
+adg_container_query_pair(AdgContainer *container, const CpmlPair *pair)
+{
+    CpmlExtents extents;
+
+    g_return_val_if_fail(ADG_IS_CONTAINER(container), NULL);
+    g_return_val_if_fail(pair != NULL, NULL);
+
+    extents.is_defined = 1;
+    cpml_pair_copy(&extents.org, pair);
+    extents.size.x = 0;
+    extents.size.y = 0;
+
+    return _adg_index_query(container, &extents, FALSE);
 }
 
 /**
@@ -424,7 +570,9 @@ adg_container_propagate_by_name(AdgContainer *container,
  *            type), this trailing pointer should be omitted
  *
  * Emits the specified signal to all the children of @container
- * using g_signal_emit_valist() calls.
+ * using g_signal_emit_valist() calls. The children are visited
+ * in the same order and with the same rules of
+ * adg_container_foreach().
  *
  * Since: 1.0
  **/
@@ -432,28 +580,61 @@ void
 adg_container_propagate_valist(AdgContainer *container,
                                guint signal_id, GQuark detail, va_list var_args)
 {
+    AdgContainerPrivate *data;
     GSList *children;
+    AdgEntity *entity;
     va_list var_copy;
+    guint n;
 
     g_return_if_fail(ADG_IS_CONTAINER(container));
 
-    children = adg_container_children(container);
+    if (ADG_CONTAINER_GET_CLASS(container)->children != _adg_children) {
+        /* Custom children implementation: iterate over a snapshot */
+        children = adg_container_children(container);
 
-    while (children != NULL) {
-        if (children->data != NULL) {
-            G_VA_COPY(var_copy, var_args);
-            g_signal_emit_valist(children->data, signal_id, detail, var_copy);
+        while (children != NULL) {
+            if (children->data != NULL) {
+                G_VA_COPY(var_copy, var_args);
+                g_signal_emit_valist(children->data, signal_id, detail, var_copy);
+                va_end(var_copy);
+            }
+
+            children = g_slist_delete_link(children, children);
         }
+        return;
+    }
 
-        children = g_slist_delete_link(children, children);
+    data = adg_container_get_instance_private(container);
+
+    _adg_children_lock(container);
+    for (n = data->children->len; n > 0; --n) {
+        entity = g_ptr_array_index(data->children, n - 1);
+        if (entity != NULL) {
+            G_VA_COPY(var_copy, var_args);
+            g_signal_emit_valist(entity, signal_id, detail, var_copy);
+            va_end(var_copy);
+        }
     }
+    _adg_children_unlock(container);
+}
+
+
+/* Gets the extents of the floating descendants of @container, not
+ * included in its extents but rendered anyway. Descendants of nested
+ * containers are included, even if they are not floating themselves. */
+CpmlExtents *
+_adg_container_get_floating_extents(AdgContainer *container)
+{
+    AdgContainerPrivate *data = adg_container_get_instance_private(container);
+    return &data->floating_extents;
 }
 
 
 static void
 _adg_destroy(AdgEntity *entity)
 {
-    adg_container_propagate_by_name((AdgContainer *) entity, "destroy");
+    adg_container_foreach((AdgContainer *) entity,
+                          G_CALLBACK(adg_entity_destroy), NULL);
 
     if (_ADG_PARENT_ENTITY_CLASS->destroy)
         _ADG_PARENT_ENTITY_CLASS->destroy(entity);
@@ -465,7 +646,8 @@ _adg_global_changed(AdgEntity *entity)
     if (_ADG_PARENT_ENTITY_CLASS->global_changed)
         _ADG_PARENT_ENTITY_CLASS->global_changed(entity);
 
-    adg_container_propagate_by_name((AdgContainer *) entity, "global-changed");
+    adg_container_foreach((AdgContainer *) entity,
+                          G_CALLBACK(adg_entity_global_changed), NULL);
 }
 
 static void
@@ -474,24 +656,39 @@ _adg_local_changed(AdgEntity *entity)
     if (_ADG_PARENT_ENTITY_CLASS->local_changed)
         _ADG_PARENT_ENTITY_CLASS->local_changed(entity);
 
-    adg_container_propagate_by_name((AdgContainer *) entity, "local-changed");
+    adg_container_foreach((AdgContainer *) entity,
+                          G_CALLBACK(adg_entity_local_changed), NULL);
 }
 
 static void
 _adg_invalidate(AdgEntity *entity)
 {
-    adg_container_propagate_by_name((AdgContainer *) entity, "invalidate");
+    AdgContainer *container = (AdgContainer *) entity;
+    AdgContainerPrivate *data = adg_container_get_instance_private(container);
+
+    data->floating_extents.is_defined = 0;
+    adg_container_foreach(container, G_CALLBACK(adg_entity_invalidate), NULL);
 }
 
 static void
 _adg_arrange(AdgEntity *entity)
 {
     AdgContainer *container = (AdgContainer *) entity;
+    AdgContainerPrivate *data = adg_container_get_instance_private(container);
     CpmlExtents extents = { 0 };
 
-    adg_container_propagate_by_name(container, "arrange", NULL);
+    adg_container_foreach(container, G_CALLBACK(adg_entity_arrange), NULL);
     adg_container_foreach(container, G_CALLBACK(_adg_add_extents), &extents);
     adg_entity_set_extents(entity, &extents);
+
+    data->floating_extents.is_defined = 0;
+    adg_container_foreach(container, G_CALLBACK(_adg_add_floating_extents),
+                          &data->floating_extents);
+
+    if (data->index_dirty)
+        _adg_index_build(container);
+    else
+        _adg_index_refit(container);
 }
 
 static void
@@ -502,20 +699,129 @@ _adg_add_extents(AdgEntity *entity, CpmlExtents *extents)
     }
 }
 
+static void
+_adg_add_floating_extents(AdgEntity *entity, CpmlExtents *extents)
+{
+    if (adg_entity_has_floating(entity))
+        cpml_extents_add(extents, adg_entity_get_extents(entity));
+
+    if (ADG_IS_CONTAINER(entity))
+        cpml_extents_add(extents,
+                         _adg_container_get_floating_extents((AdgContainer *) entity));
+}
+
 static void
 _adg_render(AdgEntity *entity, cairo_t *cr)
 {
-    adg_container_propagate_by_name((AdgContainer *) entity, "render", cr);
+    AdgContainer *container = (AdgContainer *) entity;
+    CpmlExtents clip, area;
+    GSList *children;
+    AdgEntity *child;
+    gdouble x2, y2;
+
+    cairo_clip_extents(cr, &clip.org.x, &clip.org.y, &x2, &y2);
+    clip.is_defined = 1;
+    clip.size.x = x2 - clip.org.x;
+    clip.size.y = y2 - clip.org.y;
+
+    /* Adding the margin to the clipping area is the same as adding
+     * it to the extents of every child, as done by AdgEntity */
+    area.is_defined = 1;
+    area.org.x = clip.org.x - _ADG_RENDER_MARGIN;
+    area.org.y = clip.org.y - _ADG_RENDER_MARGIN;
+    area.size.x = clip.size.x + _ADG_RENDER_MARGIN * 2;
+    area.size.y = clip.size.y + _ADG_RENDER_MARGIN * 2;
+
+    /* This is the only place where the children are culled: the ones
+     * with undefined extents are always rendered, the ones with
+     * floating descendants are returned anyway by the index and
+     * checked here on their whole rendering extents */
+    children = _adg_index_query(container, &area, TRUE);
+
+    while (children != NULL) {
+        child = children->data;
+        if (! _adg_has_floating_extents(child) ||
+            _adg_entity_is_visible(child, &clip))
+            adg_entity_render(child, cr);
+        children = g_slist_delete_link(children, children);
+    }
 }
 
 
 static GSList *
 _adg_children(AdgContainer *container)
+{
+    AdgContainerPrivate *data = adg_container_get_instance_private(container);
+    GSList *children;
+    AdgEntity *entity;
+    guint n;
+
+    /* Prepending from the oldest child gives the newest one first */
+    children = NULL;
+    for (n = 0; n < data->children->len; ++n) {
+        entity = g_ptr_array_index(data->children, n);
+        if (entity != NULL)
+            children = g_slist_prepend(children, entity);
+    }
+
+    return children;
+}
+
+static void
+_adg_children_lock(AdgContainer *container)
 {
     AdgContainerPrivate *data = adg_container_get_instance_private(container);
 
-    /* The NULL case is already managed by GLib */
-    return g_slist_copy(data->children);
+    /* While locked, the children array can only grow: removed
+     * children leave a NULL hole instead of shifting the others */
+    ++data->n_iterators;
+}
+
+static void
+_adg_children_unlock(AdgContainer *container)
+{
+    AdgContainerPrivate *data = adg_container_get_instance_private(container);
+    gpointer *children;
+    guint n, len;
+
+    --data->n_iterators;
+    if (data->n_iterators > 0 || ! data->has_holes)
+        return;
+
+    /* Compact the array by removing the holes, keeping the order */
+    children = data->children->pdata;
+    len = 0;
+    for (n = 0; n < data->children->len; ++n) {
+        if (children[n] != NULL)
+            children[len++] = children[n];
+    }
+
+    g_ptr_array_set_size(data->children, len);
+    data->has_holes = FALSE;
+}
+
+static gboolean
+_adg_children_drop(AdgContainer *container, AdgEntity *entity)
+{
+    AdgContainerPrivate *data = adg_container_get_instance_private(container);
+    guint n;
+
+    for (n = 0; n < data->children->len; ++n) {
+        if (g_ptr_array_index(data->children, n) != entity)
+            continue;
+
+        if (data->n_iterators > 0) {
+            g_ptr_array_index(data->children, n) = NULL;
+            data->has_holes = TRUE;
+        } else {
+            g_ptr_array_remove_index(data->children, n);
+        }
+
+        _adg_index_reset(container);
+        return TRUE;
+    }
+
+    return FALSE;
 }
 
 static void
@@ -536,7 +842,8 @@ _adg_add(AdgContainer *container, AdgEntity *entity)
     }
 
     data = adg_container_get_instance_private(container);
-    data->children = g_slist_prepend(data->children, entity);
+    g_ptr_array_add(data->children, entity);
+    _adg_index_reset(container);
 
     g_object_ref_sink(entity);
     adg_entity_set_parent(entity, (AdgEntity *) container);
@@ -546,17 +853,13 @@ _adg_add(AdgContainer *container, AdgEntity *entity)
 static void
 _adg_remove_from_list(gpointer container, GObject *entity)
 {
-    AdgContainerPrivate *data = adg_container_get_instance_private((AdgContainer *) container);
-    data->children = g_slist_remove(data->children, entity);
+    _adg_children_drop((AdgContainer *) container, (AdgEntity *) entity);
 }
 
 static void
 _adg_remove(AdgContainer *container, AdgEntity *entity)
 {
-    AdgContainerPrivate *data = adg_container_get_instance_private(container);
-    GSList *node = g_slist_find(data->children, entity);
-
-    if (node == NULL) {
+    if (! _adg_children_drop(container, entity)) {
         g_warning(_("Attempting to remove an entity with type %s from a "
                     "container of type %s, but the entity is not present"),
                   g_type_name(G_OBJECT_TYPE(entity)),
@@ -565,7 +868,224 @@ _adg_remove(AdgContainer *container, AdgEntity *entity)
     }
 
     g_object_weak_unref((GObject *) entity, _adg_remove_from_list, container);
-    data->children = g_slist_delete_link(data->children, node);
     adg_entity_set_parent(entity, NULL);
     g_object_unref(entity);
 }
+
+static gboolean
+_adg_has_floating_extents(AdgEntity *entity)
+{
+    return ADG_IS_CONTAINER(entity) &&
+        _adg_container_get_floating_extents((AdgContainer *) entity)->is_defined;
+}
+
+static void
+_adg_index_reset(AdgContainer *container)
+{
+    AdgContainerPrivate *data = adg_container_get_instance_private(container);
+
+    /* The index could refer to disposed entities: drop it now */
+    g_array_set_size(data->index, 0);
+    data->index_dirty = TRUE;
+}
+
+static gint
+_adg_compare_center(gconstpointer p1, gconstpointer p2, gpointer user_data)
+{
+    const CpmlExtents *extents1 = &((const AdgContainerNode *) p1)->extents;
+    const CpmlExtents *extents2 = &((const AdgContainerNode *) p2)->extents;
+    gdouble center1, center2;
+
+    if (GPOINTER_TO_INT(user_data) == 0) {
+        center1 = extents1->org.x * 2 + extents1->size.x;
+        center2 = extents2->org.x * 2 + extents2->size.x;
+    } else {
+        center1 = extents1->org.y * 2 + extents1->size.y;
+        center2 = extents2->org.y * 2 + extents2->size.y;
+    }
+
+    return center1 < center2 ? -1 : center1 > center2 ? 1 : 0;
+}
+
+static void
+_adg_index_build(AdgContainer *container)
+{
+    AdgContainerPrivate *data = adg_container_get_instance_private(container);
+    AdgContainerNode *leaves, *leaf;
+    AdgEntity *entity;
+    guint n, n_leaves;
+
+    leaves = g_new0(AdgContainerNode, data->children->len);
+    leaf = leaves;
+
+    /* The leaves are ordered from the newest child to the oldest one */
+    for (n = data->children->len; n > 0; --n) {
+        entity = g_ptr_array_index(data->children, n - 1);
+        if (entity == NULL)
+            continue;
+
+        leaf->entity = entity;
+        leaf->order = leaf - leaves;
+        cpml_extents_copy(&leaf->extents, adg_entity_get_extents(leaf->entity));
+        if (! leaf->extents.is_defined) {
+            /* Sort undefined extents as if they were in the origin */
+            leaf->extents.org.x = leaf->extents.org.y = 0;
+            leaf->extents.size.x = leaf->extents.size.y = 0;
+        }
+
+        ++leaf;
+    }
+
+    n_leaves = leaf - leaves;
+    g_array_set_size(data->index, 0);
+    if (n_leaves > 0)
+        _adg_index_split(data->index, leaves, n_leaves);
+
+    g_free(leaves);
+    data->index_dirty = FALSE;
+
+    _adg_index_refit(container);
+}
+
+static guint
+_adg_index_split(GArray *index, AdgContainerNode *leaves, guint n_leaves)
+{
+    AdgContainerNode *node;
+    CpmlExtents centers;
+    CpmlPair center;
+    guint n, pos;
+
+    pos = index->len;
+
+    if (n_leaves == 1) {
+        g_array_append_val(index, leaves[0]);
+        return pos;
+    }
+
+    /* Split the leaves in two halves along the widest axis */
+    centers.is_defined = 0;
+    for (n = 0; n < n_leaves; ++n) {
+        center.x = leaves[n].extents.org.x + leaves[n].extents.size.x / 2;
+        center.y = leaves[n].extents.org.y + leaves[n].extents.size.y / 2;
+        cpml_extents_pair_add(&centers, &center);
+    }
+
+    g_qsort_with_data(leaves, n_leaves, sizeof(AdgContainerNode),
+                      _adg_compare_center,
+                      GINT_TO_POINTER(centers.size.x >= centers.size.y ? 0 : 1));
+
+    g_array_set_size(index, pos + 1);
+    node = &g_array_index(index, AdgContainerNode, pos);
+    node->entity = NULL;
+
+    n = n_leaves / 2;
+    node->left = _adg_index_split(index, leaves, n);
+    node = &g_array_index(index, AdgContainerNode, pos);
+    node->right = _adg_index_split(index, leaves + n, n_leaves - n);
+
+    return pos;
+}
+
+static void
+_adg_index_refit(AdgContainer *container)
+{
+    AdgContainerPrivate *data = adg_container_get_instance_private(container);
+    AdgContainerNode *node, *left, *right;
+    const CpmlExtents *extents;
+    guint n;
+
+    /* Parents precede their children, so a backward scan
+     * updates the children before their parent */
+    for (n = data->index->len; n > 0; --n) {
+        node = &g_array_index(data->index, AdgContainerNode, n - 1);
+
+        if (node->entity != NULL) {
+            extents = adg_entity_get_extents(node->entity);
+            cpml_extents_copy(&node->extents, extents);
+            node->partial = ! extents->is_defined ||
+                            _adg_has_floating_extents(node->entity);
+        } else {
+            left = &g_array_index(data->index, AdgContainerNode, node->left);
+            right = &g_array_index(data->index, AdgContainerNode, node->right);
+            node->extents.is_defined = 0;
+            cpml_extents_add(&node->extents, &left->extents);
+            cpml_extents_add(&node->extents, &right->extents);
+            node->partial = left->partial || right->partial;
+        }
+    }
+}
+
+static gint
+_adg_compare_order(gconstpointer p1, gconstpointer p2)
+{
+    const AdgContainerNode *node1 = *(const AdgContainerNode **) p1;
+    const AdgContainerNode *node2 = *(const AdgContainerNode **) p2;
+
+    return (gint) node1->order - (gint) node2->order;
+}
+
+static GSList *
+_adg_index_query(AdgContainer *container,
+                 const CpmlExtents *extents, gboolean partial)
+{
+    AdgContainerPrivate *data = adg_container_get_instance_private(container);
+    const CpmlExtents *child_extents;
+    AdgContainerNode *node;
+    GPtrArray *hits;
+    AdgEntity *child;
+    GSList *result;
+    guint n;
+
+    result = NULL;
+
+    if (data->index_dirty) {
+        /* Not arranged yet: fallback to a linear scan, from the
+         * oldest child so the result starts with the newest one */
+        for (n = 0; n < data->children->len; ++n) {
+            child = g_ptr_array_index(data->children, n);
+            if (child == NULL)
+                continue;
+
+            child_extents = adg_entity_get_extents(child);
+            if ((partial && (! child_extents->is_defined ||
+                             _adg_has_floating_extents(child))) ||
+                cpml_extents_is_intersecting(child_extents, extents))
+                result = g_slist_prepend(result, child);
+        }
+
+        return result;
+    }
+
+    if (data->index->len == 0)
+        return NULL;
+
+    hits = g_ptr_array_new();
+    _adg_index_lookup(data->index, 0, extents, partial, hits);
+    g_ptr_array_sort(hits, _adg_compare_order);
+
+    for (n = hits->len; n > 0; --n) {
+        node = g_ptr_array_index(hits, n - 1);
+        result = g_slist_prepend(result, node->entity);
+    }
+
+    g_ptr_array_free(hits, TRUE);
+    return result;
+}
+
+static void
+_adg_index_lookup(GArray *index, guint n, const CpmlExtents *extents,
+                  gboolean partial, GPtrArray *hits)
+{
+    AdgContainerNode *node = &g_array_index(index, AdgContainerNode, n);
+
+    if (! cpml_extents_is_intersecting(&node->extents, extents) &&
+        ! (partial && node->partial))
+        return;
+
+    if (node->entity != NULL) {
+        g_ptr_array_add(hits, node);
+    } else {
+        _adg_index_lookup(index, node->left, extents, partial, hits);
+        _adg_index_lookup(index, node->right, extents, partial, hits);
+    }
+}
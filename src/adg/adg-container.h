@@ -73,6 +73,10 @@ void            adg_container_remove            (AdgContainer    *container,
 void            adg_container_foreach           (AdgContainer    *container,
                                                  GCallback        callback,
                                                  gpointer         user_data);
+GSList *        adg_container_query_extents     (AdgContainer    *container,
+                                                 const CpmlExtents *extents);
+GSList *        adg_container_query_pair        (AdgContainer    *container,
+                                                 const CpmlPair  *pair);
 void            adg_container_propagate         (AdgContainer    *container,
                                                  guint            signal_id,
                                                  GQuark           detail,
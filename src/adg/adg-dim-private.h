@@ -25,7 +25,6 @@
 G_BEGIN_DECLS
 
 typedef struct _AdgDimPrivate AdgDimPrivate;
-typedef struct _AdgDimReplaceData AdgDimReplaceData;
 
 struct _AdgDimPrivate {
     AdgDress             dim_dress;
@@ -54,16 +53,6 @@ struct _AdgDimPrivate {
     }                    geometry;
 };
 
-struct _AdgDimReplaceData {
-    AdgDimStyle         *dim_style;
-    gdouble              value;
-    const gchar         *format;
-    const gchar         *argument;
-    AdgThreeState        valorized;
-    /* Just for conveniency */
-    GRegex              *regex;
-};
-
 G_END_DECLS
 
 
@@ -55,6 +55,10 @@ struct _AdgDimStylePrivate {
     gchar               *number_tag;
     gint                 decimals;
     gint                 rounding;
+
+    /* Compiled number-format, rebuilt whenever it is set */
+    GArray              *number_ops;
+    gint                 number_depth;
 };
 
 G_END_DECLS
@@ -84,6 +84,33 @@
 
 #define VALID_FORMATS "aieDdMmSs"
 
+/* A convenience macro for ORing two AdgThreeState values */
+#define OR_3S(a,b) ( \
+    ((a) == ADG_THREE_STATE_ON ||      (b) == ADG_THREE_STATE_ON)      ? ADG_THREE_STATE_ON : \
+    ((a) == ADG_THREE_STATE_UNKNOWN && (b) == ADG_THREE_STATE_UNKNOWN) ? ADG_THREE_STATE_UNKNOWN : \
+                                                                         ADG_THREE_STATE_OFF )
+
+
+typedef enum {
+    NUMBER_LITERAL,
+    NUMBER_VALUE,
+    NUMBER_GROUP_BEGIN,
+    NUMBER_GROUP_END
+} AdgNumberOpType;
+
+typedef struct {
+    AdgNumberOpType type;
+    const gchar    *literal;
+    gsize           length;
+    gchar          *directive;
+    gchar           argument;
+} AdgNumberOp;
+
+typedef struct {
+    gsize           mark;
+    AdgThreeState   valorized;
+} AdgNumberGroup;
+
 
 G_DEFINE_TYPE_WITH_PRIVATE(AdgDimStyle, adg_dim_style, ADG_TYPE_STYLE)
 
@@ -129,6 +156,14 @@ static AdgMarker *      _adg_marker_new         (const AdgMarkerData
 static void             _adg_marker_data_set    (AdgMarkerData  *marker_data,
                                                  AdgMarker      *marker);
 static void             _adg_marker_data_unset  (AdgMarkerData  *marker_data);
+static void             _adg_number_ops_build   (AdgDimStylePrivate
+                                                                *data);
+static void             _adg_number_ops_append  (GArray         *ops,
+                                                 AdgNumberOpType type,
+                                                 const gchar    *literal,
+                                                 gsize           length);
+static void             _adg_number_ops_free    (AdgDimStylePrivate
+                                                                *data);
 
 
 static void
@@ -316,6 +351,9 @@ adg_dim_style_init(AdgDimStyle *dim_style)
     data->number_tag = g_strdup("<>");
     data->decimals = 2;
     data->rounding = 6;
+    data->number_ops = NULL;
+    data->number_depth = 0;
+    _adg_number_ops_build(data);
 }
 
 static void
@@ -334,6 +372,8 @@ _adg_finalize(GObject *object)
 
     g_free(data->number_tag);
     data->number_tag = NULL;
+
+    _adg_number_ops_free(data);
 }
 
 static void
@@ -453,12 +493,14 @@ _adg_set_property(GObject *object, guint prop_id,
     case PROP_NUMBER_FORMAT:
         g_free(data->number_format);
         data->number_format = g_value_dup_string(value);
+        _adg_number_ops_build(data);
         break;
     case PROP_NUMBER_ARGUMENTS: {
         const gchar *arguments = g_value_get_string(value);
         g_return_if_fail(arguments == NULL || strspn(arguments, VALID_FORMATS) == strlen(arguments));
         g_free(data->number_arguments);
         data->number_arguments = g_strdup(arguments);
+        _adg_number_ops_build(data);
         break;
     }
     case PROP_NUMBER_TAG:
@@ -1395,6 +1437,105 @@ adg_dim_style_convert(AdgDimStyle *dim_style, gdouble *value, gchar format)
     return TRUE;
 }
 
+/**
+ * adg_dim_style_format:
+ * @dim_style: an #AdgDimStyle object
+ * @value: the value to format
+ *
+ * Formats @value according to the #AdgDimStyle:number-format and
+ * #AdgDimStyle:number-arguments properties of @dim_style. See
+ * adg_dim_style_set_number_format() for details on the syntax.
+ *
+ * The format is parsed when @dim_style is created and whenever
+ * #AdgDimStyle:number-format or #AdgDimStyle:number-arguments
+ * change, so formatting many values with the same style is cheap.
+ *
+ * Returns: (transfer full): the formatted text or <constant>NULL</constant> on errors.
+ *
+ * Since: 1.0
+ **/
+gchar *
+adg_dim_style_format(AdgDimStyle *dim_style, gdouble value)
+{
+    AdgDimStylePrivate *data;
+    const GArray *ops;
+    const AdgNumberOp *op;
+    AdgNumberGroup *groups, *group;
+    GString *result;
+    gdouble converted;
+    gchar buffer[256];
+    gchar *src, *dst;
+    guint n;
+
+    g_return_val_if_fail(ADG_IS_DIM_STYLE(dim_style), NULL);
+
+    data = adg_dim_style_get_instance_private(dim_style);
+
+    if (data->number_format == NULL)
+        return NULL;
+
+    if (data->number_arguments == NULL)
+        return g_strdup(data->number_format);
+
+    /* Unbalanced parenthesis in the format string */
+    ops = data->number_ops;
+    g_return_val_if_fail(data->number_depth >= 0, NULL);
+
+    result = g_string_sized_new(strlen(data->number_format) + 32);
+    groups = g_newa(AdgNumberGroup, data->number_depth + 1);
+    group = groups;
+    group->mark = 0;
+    group->valorized = ADG_THREE_STATE_UNKNOWN;
+
+    for (n = 0; n < ops->len; ++n) {
+        op = &g_array_index(ops, AdgNumberOp, n);
+
+        switch (op->type) {
+
+        case NUMBER_LITERAL:
+            g_string_append_len(result, op->literal, op->length);
+            break;
+
+        case NUMBER_VALUE:
+            /* On conversion errors (e.g. not enough arguments)
+             * adg_dim_style_convert() already complained */
+            converted = value;
+            if (! adg_dim_style_convert(dim_style, &converted, op->argument))
+                break;
+
+            g_ascii_formatd(buffer, sizeof(buffer), op->directive, converted);
+            g_string_append(result, buffer);
+            group->valorized = OR_3S(group->valorized, converted != 0 ?
+                                     ADG_THREE_STATE_ON : ADG_THREE_STATE_OFF);
+            break;
+
+        case NUMBER_GROUP_BEGIN:
+            ++ group;
+            group->mark = result->len;
+            group->valorized = ADG_THREE_STATE_UNKNOWN;
+            break;
+
+        case NUMBER_GROUP_END:
+            /* A group where all the values are 0 disappears */
+            if (group->valorized == ADG_THREE_STATE_OFF)
+                g_string_truncate(result, group->mark);
+            -- group;
+            group->valorized = OR_3S(group->valorized, (group + 1)->valorized);
+            break;
+        }
+    }
+
+    /* Substitute the escape sequences ("\%", "\(" and "\)") in place */
+    for (src = dst = result->str; *src != '\0'; ++src, ++dst) {
+        if (src[0] == '\\' && (src[1] == '%' || src[1] == '(' || src[1] == ')'))
+            ++ src;
+        *dst = *src;
+    }
+    g_string_truncate(result, dst - result->str);
+
+    return g_string_free(result, FALSE);
+}
+
 
 static AdgStyle *
 _adg_clone(AdgStyle *style)
@@ -1476,6 +1617,121 @@ _adg_marker_data_set(AdgMarkerData *marker_data, AdgMarker *marker)
     }
 }
 
+/* The ops are compiled whenever the format or the arguments change,
+ * so adg_dim_style_format() never writes to the style: the same
+ * style can be used concurrently by different threads. */
+static void
+_adg_number_ops_build(AdgDimStylePrivate *data)
+{
+    const gchar *format, *argument, *literal, *p, *end;
+    AdgNumberOp *op;
+    GArray *ops;
+    gint depth;
+
+    _adg_number_ops_free(data);
+
+    if (data->number_format == NULL || data->number_arguments == NULL)
+        return;
+
+    format = data->number_format;
+    argument = data->number_arguments;
+    ops = g_array_new(FALSE, FALSE, sizeof(AdgNumberOp));
+    data->number_ops = ops;
+    data->number_depth = 0;
+    depth = 0;
+    literal = format;
+
+    for (p = format; *p != '\0'; ++p) {
+        /* Escaped characters are left as they are */
+        if (p > format && *(p-1) == '\\')
+            continue;
+
+        if (*p == '(' || *p == ')') {
+            _adg_number_ops_append(ops, NUMBER_LITERAL, literal, p - literal);
+            literal = p + 1;
+
+            if (*p == '(') {
+                _adg_number_ops_append(ops, NUMBER_GROUP_BEGIN, NULL, 0);
+                ++ depth;
+                data->number_depth = MAX(data->number_depth, depth);
+            } else if (depth > 0) {
+                _adg_number_ops_append(ops, NUMBER_GROUP_END, NULL, 0);
+                -- depth;
+            } else {
+                /* Too many closing parenthesis */
+                depth = -1;
+                break;
+            }
+        } else if (*p == '%') {
+            /* A directive spans up to the first conversion specifier
+             * inside the same group and on the same line */
+            for (end = p + 1; *end != '\0'; ++end) {
+                if (*end == '\n' || strchr("eEfFgG", *end) != NULL ||
+                    ((*end == '(' || *end == ')') && *(end-1) != '\\'))
+                    break;
+            }
+
+            if (*end == '\0' || strchr("eEfFgG", *end) == NULL)
+                continue;
+
+            _adg_number_ops_append(ops, NUMBER_LITERAL, literal, p - literal);
+            _adg_number_ops_append(ops, NUMBER_VALUE, NULL, 0);
+            op = &g_array_index(ops, AdgNumberOp, ops->len - 1);
+            op->directive = g_strndup(p, end - p + 1);
+
+            /* Arguments are consumed in order of appearance */
+            op->argument = *argument;
+            if (*argument != '\0')
+                ++ argument;
+
+            p = end;
+            literal = p + 1;
+        }
+    }
+
+    if (depth != 0) {
+        /* Unbalanced parenthesis: flag the format as invalid */
+        data->number_depth = -1;
+    } else {
+        _adg_number_ops_append(ops, NUMBER_LITERAL, literal, strlen(literal));
+    }
+}
+
+static void
+_adg_number_ops_append(GArray *ops, AdgNumberOpType type,
+                       const gchar *literal, gsize length)
+{
+    AdgNumberOp op;
+
+    /* Skip empty literals */
+    if (type == NUMBER_LITERAL && length == 0)
+        return;
+
+    op.type = type;
+    op.literal = literal;
+    op.length = length;
+    op.directive = NULL;
+    op.argument = '\0';
+
+    g_array_append_val(ops, op);
+}
+
+static void
+_adg_number_ops_free(AdgDimStylePrivate *data)
+{
+    guint n;
+
+    if (data->number_ops == NULL)
+        return;
+
+    for (n = 0; n < data->number_ops->len; ++n)
+        g_free(g_array_index(data->number_ops, AdgNumberOp, n).directive);
+
+    g_array_free(data->number_ops, TRUE);
+    data->number_ops = NULL;
+    data->number_depth = 0;
+}
+
 static void
 _adg_marker_data_unset(AdgMarkerData *marker_data)
 {
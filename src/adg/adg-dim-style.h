@@ -117,6 +117,8 @@ gint            adg_dim_style_get_rounding      (AdgDimStyle    *dim_style);
 gboolean        adg_dim_style_convert           (AdgDimStyle    *dim_style,
                                                  gdouble        *value,
                                                  gchar           format);
+gchar *         adg_dim_style_format            (AdgDimStyle    *dim_style,
+                                                 gdouble         value);
 
 G_END_DECLS
 
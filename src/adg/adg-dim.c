@@ -81,12 +81,6 @@
 #define _ADG_OLD_OBJECT_CLASS  ((GObjectClass *) adg_dim_parent_class)
 #define _ADG_OLD_ENTITY_CLASS  ((AdgEntityClass *) adg_dim_parent_class)
 
-/* A convenience macro for ORing two AdgThreeState values */
-#define OR_3S(a,b) ( \
-    ((a) == ADG_THREE_STATE_ON ||      (b) == ADG_THREE_STATE_ON)      ? ADG_THREE_STATE_ON : \
-    ((a) == ADG_THREE_STATE_UNKNOWN && (b) == ADG_THREE_STATE_UNKNOWN) ? ADG_THREE_STATE_UNKNOWN : \
-                                                                         ADG_THREE_STATE_OFF )
-
 
 G_DEFINE_ABSTRACT_TYPE_WITH_PRIVATE(AdgDim, adg_dim, ADG_TYPE_ENTITY)
 
@@ -132,10 +126,6 @@ static gboolean _adg_set_min            (AdgDim             *dim,
                                          const gchar        *min);
 static gboolean _adg_set_max            (AdgDim             *dim,
                                          const gchar        *max);
-static gboolean _adg_replace            (const GMatchInfo   *match_info,
-                                         GString            *result,
-                                         gpointer            user_data);
-static gchar *  _adg_text_expand        (AdgDimReplaceData  *data);
 
 
 static void
@@ -1004,11 +994,6 @@ gchar *
 adg_dim_get_text(AdgDim *dim, gdouble value)
 {
     AdgDimStyle *dim_style;
-    const gchar *format;
-    const gchar *arguments;
-    AdgDimReplaceData data;
-    gchar *raw, *result;
-    GRegex *regex;
 
     g_return_val_if_fail(ADG_IS_DIM(dim), NULL);
 
@@ -1018,40 +1003,7 @@ adg_dim_get_text(AdgDim *dim, gdouble value)
                                                      adg_dim_get_dim_dress(dim));
     }
 
-    format = adg_dim_style_get_number_format(dim_style);
-    if (format == NULL) {
-        return NULL;
-    }
-
-    arguments = adg_dim_style_get_number_arguments(dim_style);
-    if (arguments == NULL) {
-        return g_strdup(format);
-    }
-
-    /* Expand the values */
-    data.dim_style = dim_style;
-    data.value = value;
-    data.format = format;
-    data.argument = arguments;
-    data.regex = g_regex_new("(?<!\\\\)%.*[eEfFgG]", G_REGEX_UNGREEDY, 0, NULL);
-    raw = _adg_text_expand(&data);
-    g_regex_unref(data.regex);
-
-    /* Check that all format string has been parsed, otherwise there are
-     * likely too many close parenthesis */
-    if (*data.format != '\0') {
-        g_free(raw);
-        g_return_val_if_reached(NULL);
-        return NULL;
-    }
-
-    /* Substitute the escape sequences ("\%", "\(" and "\)") */
-    regex = g_regex_new("\\\\([%()])", G_REGEX_UNGREEDY, 0, NULL);
-    result = g_regex_replace(regex, raw, -1, 0, "\\1", 0, NULL);
-    g_free(raw);
-    g_regex_unref(regex);
-
-    return result;
+    return adg_dim_style_format(dim_style, value);
 }
 
 /**
@@ -1723,122 +1675,3 @@ _adg_set_max(AdgDim *dim, const gchar *max)
 
     return TRUE;
 }
-
-static gboolean
-_adg_replace(const GMatchInfo *match_info, GString *result, gpointer user_data)
-{
-    AdgDimReplaceData *data;
-    gdouble value;
-    gchar *format;
-    gchar buffer[256];
-
-    data = (AdgDimReplaceData *) user_data;
-    value = data->value;
-
-    if (! adg_dim_style_convert(data->dim_style, &value, *data->argument)) {
-        /* Conversion failed: invalid argument? */
-        g_return_val_if_reached(TRUE);
-        return TRUE;
-    }
-
-    format = g_match_info_fetch(match_info, 0);
-
-    /* This should never happen */
-    g_return_val_if_fail(format != NULL, TRUE);
-
-    /* Consume the recently used argument */
-    ++ data->argument;
-
-    g_ascii_formatd(buffer, 256, format, value);
-    g_free(format);
-    g_string_append(result, buffer);
-
-    /* Set the valorized flag */
-    if (value != 0) {
-        data->valorized = ADG_THREE_STATE_ON;
-    } else if (data->valorized == ADG_THREE_STATE_UNKNOWN) {
-        data->valorized = ADG_THREE_STATE_OFF;
-    }
-
-    return FALSE;
-}
-
-static gchar *
-_adg_text_expand(AdgDimReplaceData *data)
-{
-    GString *result;
-    const gchar *bog, *eog;
-    gchar *string;
-    AdgThreeState valorized;
-    gssize len;
-
-    valorized = ADG_THREE_STATE_UNKNOWN;
-    result = g_string_new("");
-    eog = adg_unescaped_strchr(data->format, ')');
-
-    /* Expand eventual groups found in the same nesting level */
-    while ((bog = adg_unescaped_strchr(data->format, '(')) != NULL) {
-        /* If eog precedes bog, it means that bog is in another nest */
-        if (eog != NULL && eog < bog) {
-            break;
-        }
-
-        len = bog - data->format;
-
-        /* Parse template before the bog */
-        data->valorized = ADG_THREE_STATE_UNKNOWN;
-        string = g_regex_replace_eval(data->regex,
-                                      data->format, len, 0,
-                                      0,
-                                      _adg_replace, data,
-                                      NULL);
-        valorized = OR_3S(valorized, data->valorized);
-
-        data->format += len+1;
-        g_string_append(result, string);
-        g_free(string);
-
-        /* Recursively expand the group */
-        string = _adg_text_expand(data);
-        valorized = OR_3S(valorized, data->valorized);
-
-        g_string_append(result, string);
-        g_free(string);
-
-        /* Ensure there is a matching closing parenthesis */
-        if (*data->format != ')') {
-            g_string_free(result, TRUE);
-            g_return_val_if_reached(NULL);
-            return NULL;
-        }
-
-        /* Skip the closing parenthesis */
-        ++ data->format;
-        eog = adg_unescaped_strchr(data->format, ')');
-    }
-
-    /* Expand until closing parenthesis (End Of Group) or '\0' */
-    len = eog == NULL ? strlen(data->format) : (eog - data->format);
-    data->valorized = ADG_THREE_STATE_UNKNOWN;
-    string = g_regex_replace_eval(data->regex,
-                                  data->format, len, 0,
-                                  0,
-                                  _adg_replace, data,
-                                  NULL);
-
-    data->format += len;
-    g_string_append(result, string);
-    g_free(string);
-
-    /* Store the final valorized state */
-    valorized = OR_3S(valorized, data->valorized);
-    data->valorized = valorized;
-
-    /* Drop the result only if we are inside a group */
-    if (*data->format && valorized == ADG_THREE_STATE_OFF) {
-        g_string_free(result, TRUE);
-        return g_strdup("");
-    }
-
-    return g_string_free(result, FALSE);
-}
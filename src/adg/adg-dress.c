@@ -139,6 +139,13 @@
  * An index representing a virtual #AdgStyle. The ADG comes equipped
  * with some built-in dress.
  *
+ * The fallback styles are shared by default by every thread. As styles
+ * cache their resources (scaled fonts, pango layouts, compiled formats)
+ * while arranging and rendering, a thread working on its own canvas
+ * concurrently with other threads should call
+ * adg_dress_switch_thread_fallbacks() first: see its documentation
+ * for details.
+ *
  * Since: 1.0
  **/
 
@@ -180,16 +187,36 @@
 
 #include "adg-dress.h"
 #include "adg-dress-private.h"
+#include "adg-entity-private.h"
 
 #define MM  *2.83464566927
 
 
+typedef struct _AdgDressThread AdgDressThread;
+
+struct _AdgDressThread {
+    gint        generation;
+    GPtrArray  *fallbacks;
+};
+
+
 static GArray *         _adg_data_array             (void);
 static void             _adg_data_register          (AdgDress    dress,
                                                      AdgStyle   *fallback,
                                                      GType       ancestor_type);
 static void             _adg_data_register_builtins (void);
 static AdgDressPrivate *_adg_data_lookup            (AdgDress    dress);
+static void             _adg_thread_reset           (AdgDressThread *thread);
+static void             _adg_thread_free            (gpointer    user_data);
+static AdgStyle *       _adg_thread_lookup          (AdgDressThread *thread,
+                                                     AdgDress    dress);
+
+
+static GRecMutex        _adg_data_mutex;
+static GArray *         _adg_data = NULL;
+static gint             _adg_data_ready = 0;
+static gint             _adg_generation = 1;
+static GPrivate         _adg_thread = G_PRIVATE_INIT(_adg_thread_free);
 
 
 /**
@@ -330,8 +357,12 @@ adg_dress_set_fallback(AdgDress dress, AdgStyle *fallback)
 
     g_return_if_fail(data != NULL);
 
-    if (data->fallback == fallback)
+    g_rec_mutex_lock(&_adg_data_mutex);
+
+    if (data->fallback == fallback) {
+        g_rec_mutex_unlock(&_adg_data_mutex);
         return;
+    }
 
     /* Check if the new fallback style is compatible with this dress */
     if (fallback != NULL && !adg_dress_style_is_compatible(dress, fallback)) {
@@ -339,6 +370,7 @@ adg_dress_set_fallback(AdgDress dress, AdgStyle *fallback)
                   G_STRLOC, adg_dress_get_name(dress), dress,
                   g_type_name(data->ancestor_type),
                   g_type_name(G_TYPE_FROM_INSTANCE(fallback)));
+        g_rec_mutex_unlock(&_adg_data_mutex);
         return;
     }
 
@@ -349,6 +381,12 @@ adg_dress_set_fallback(AdgDress dress, AdgStyle *fallback)
 
     if (data->fallback != NULL)
         g_object_ref(data->fallback);
+
+    /* Outdate the private fallbacks of every thread and the
+     * renderings recorded with the old fallback */
+    g_atomic_int_inc(&_adg_generation);
+    _adg_entity_outdate_recordings();
+    g_rec_mutex_unlock(&_adg_data_mutex);
 }
 
 /**
@@ -359,6 +397,9 @@ adg_dress_set_fallback(AdgDress dress, AdgStyle *fallback)
  * are raised if the dress is not found. The returned style
  * is owned by dress and should not be freed or modified.
  *
+ * If adg_dress_switch_thread_fallbacks() has been enabled in the
+ * calling thread, the private clone of that thread is returned.
+ *
  * Returns: (transfer none): the requested #AdgStyle derived instance or <constant>NULL</constant> if not set.
  *
  * Since: 1.0
@@ -366,10 +407,74 @@ adg_dress_set_fallback(AdgDress dress, AdgStyle *fallback)
 AdgStyle *
 adg_dress_get_fallback(AdgDress dress)
 {
-    AdgDressPrivate *data = _adg_data_lookup(dress);
+    AdgDressThread *thread;
+    AdgDressPrivate *data;
+
+    thread = g_private_get(&_adg_thread);
+    if (thread != NULL)
+        return _adg_thread_lookup(thread, dress);
+
+    data = _adg_data_lookup(dress);
     return data != NULL ? data->fallback : NULL;
 }
 
+/**
+ * adg_dress_switch_thread_fallbacks:
+ * @state: the new state
+ *
+ * Enables (if @state is <constant>TRUE</constant>) or disables the
+ * private fallback styles of the calling thread. When enabled, any
+ * adg_dress_get_fallback() call from this thread returns a clone of
+ * the global fallback style that is never seen by other threads.
+ * The clones are created lazily and are refreshed whenever a fallback
+ * is changed by adg_dress_set_fallback(). They are released when the
+ * feature is disabled or the thread exits.
+ *
+ * This is the only requirement to arrange and render independent
+ * canvas trees in different threads at the same time: styles keep
+ * caches that are not protected by locks, so they must not be
+ * shared between threads. Styles explicitely set on entities with
+ * adg_entity_set_style() are not involved, so they must not be
+ * shared by canvases arranged concurrently.
+ * adg_canvas_export_batch() enables this feature on its workers.
+ *
+ * Since: 1.0
+ **/
+void
+adg_dress_switch_thread_fallbacks(gboolean state)
+{
+    AdgDressThread *thread;
+
+    if (! state) {
+        g_private_replace(&_adg_thread, NULL);
+        return;
+    }
+
+    if (g_private_get(&_adg_thread) != NULL)
+        return;
+
+    thread = g_new(AdgDressThread, 1);
+    thread->generation = 0;
+    thread->fallbacks = NULL;
+    g_private_set(&_adg_thread, thread);
+}
+
+/**
+ * adg_dress_has_thread_fallbacks:
+ *
+ * Checks whether the calling thread is using private fallback styles.
+ * See adg_dress_switch_thread_fallbacks() for details.
+ *
+ * Returns: <constant>TRUE</constant> if the private fallbacks are enabled, <constant>FALSE</constant> otherwise.
+ *
+ * Since: 1.0
+ **/
+gboolean
+adg_dress_has_thread_fallbacks(void)
+{
+    return g_private_get(&_adg_thread) != NULL;
+}
+
 /**
  * adg_dress_style_is_compatible:
  * @dress:                  an #AdgDress
@@ -398,27 +503,33 @@ adg_dress_style_is_compatible(AdgDress dress, AdgStyle *style)
 static GArray *
 _adg_data_array(void)
 {
-    /* The following register keeps track of the metadata bound to every
+    /* The _adg_data register keeps track of the metadata bound to every
      * #AdgDress value, such as the fallback style and the ancestor type.
      *
      * The AdgDress value is cohincident with the index of its metadata
      * inside this register, that is if %ADG_DRESS_COLOR_BACKGROUND is 2,
      * array->data[2] will contain its metadata.
+     *
+     * The mutex is recursive because registering the builtins creates
+     * styles that look up the (partially filled) register again.
      */
-    static GArray *array = NULL;
-
-    if (G_UNLIKELY(array == NULL)) {
-        array = g_array_new(FALSE, FALSE, sizeof(AdgDressPrivate));
-        _adg_data_register_builtins();
+    if (G_UNLIKELY(! g_atomic_int_get(&_adg_data_ready))) {
+        g_rec_mutex_lock(&_adg_data_mutex);
+        if (_adg_data == NULL) {
+            _adg_data = g_array_new(FALSE, FALSE, sizeof(AdgDressPrivate));
+            _adg_data_register_builtins();
+            g_atomic_int_set(&_adg_data_ready, 1);
+        }
+        g_rec_mutex_unlock(&_adg_data_mutex);
     }
 
-    return array;
+    return _adg_data;
 }
 
 static void
 _adg_data_register(AdgDress dress, AdgStyle *fallback, GType ancestor_type)
 {
-    GArray         *array = _adg_data_array();
+    GArray         *array = _adg_data;
     AdgDressPrivate data;
 
     data.fallback = fallback;
@@ -648,3 +759,70 @@ _adg_data_lookup(AdgDress dress)
 
     return ((AdgDressPrivate *) array->data) + dress;
 }
+
+static void
+_adg_thread_reset(AdgDressThread *thread)
+{
+    AdgStyle *style;
+    guint n;
+
+    if (thread->fallbacks == NULL)
+        return;
+
+    for (n = 0; n < thread->fallbacks->len; ++n) {
+        style = g_ptr_array_index(thread->fallbacks, n);
+        if (style != NULL)
+            g_object_unref(style);
+    }
+
+    g_ptr_array_free(thread->fallbacks, TRUE);
+    thread->fallbacks = NULL;
+}
+
+static void
+_adg_thread_free(gpointer user_data)
+{
+    AdgDressThread *thread = (AdgDressThread *) user_data;
+
+    _adg_thread_reset(thread);
+    g_free(thread);
+}
+
+static AdgStyle *
+_adg_thread_lookup(AdgDressThread *thread, AdgDress dress)
+{
+    if (thread->generation != g_atomic_int_get(&_adg_generation)) {
+        GArray *array = _adg_data_array();
+        AdgDressPrivate *data;
+        AdgStyle *clone;
+        guint n;
+
+        _adg_thread_reset(thread);
+
+        g_rec_mutex_lock(&_adg_data_mutex);
+
+        /* Update the generation in advance, so any nested lookup
+         * performed while cloning does not start over again */
+        thread->generation = g_atomic_int_get(&_adg_generation);
+        thread->fallbacks = g_ptr_array_sized_new(array->len);
+
+        /* Setting the properties of the new clones cannot change
+         * anything already rendered, so do not outdate the recordings */
+        _adg_entity_freeze_recordings();
+
+        for (n = 0; n < array->len; ++n) {
+            data = ((AdgDressPrivate *) array->data) + n;
+            clone = data->fallback != NULL ? adg_style_clone(data->fallback) : NULL;
+            g_ptr_array_add(thread->fallbacks, clone);
+        }
+
+        _adg_entity_thaw_recordings();
+
+        g_rec_mutex_unlock(&_adg_data_mutex);
+    }
+
+    if (thread->fallbacks == NULL || dress >= thread->fallbacks->len)
+        return NULL;
+
+    return g_ptr_array_index(thread->fallbacks, dress);
+}
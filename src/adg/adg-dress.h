@@ -42,6 +42,9 @@ GType           adg_dress_get_ancestor_type     (AdgDress        dress);
 void            adg_dress_set_fallback          (AdgDress        dress,
                                                  AdgStyle       *fallback);
 AdgStyle *      adg_dress_get_fallback          (AdgDress        dress);
+void            adg_dress_switch_thread_fallbacks
+                                                (gboolean        state);
+gboolean        adg_dress_has_thread_fallbacks  (void);
 gboolean        adg_dress_style_is_compatible   (AdgDress        dress,
                                                  AdgStyle       *style);
 
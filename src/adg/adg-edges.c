@@ -86,11 +86,14 @@ static void             _adg_clear              (AdgModel       *model);
 static cairo_path_t *   _adg_get_cairo_path     (AdgTrail       *trail);
 static void             _adg_unset_source       (AdgEdges       *edges);
 static void             _adg_clear_cairo_path   (AdgEdges       *edges);
-static GSList *         _adg_get_vertices       (GSList         *vertices,
+static void             _adg_get_vertices       (GArray         *vertices,
                                                  CpmlSegment    *segment,
                                                  gdouble         threshold);
-static GSList *         _adg_optimize_vertices  (GSList         *vertices);
-static GArray *         _adg_path_build         (const GSList   *vertices);
+static void             _adg_optimize_vertices  (GArray         *vertices);
+static gint             _adg_compare_x          (gconstpointer   a,
+                                                 gconstpointer   b,
+                                                 gpointer        user_data);
+static GArray *         _adg_path_build         (const GArray   *vertices);
 static void             _adg_path_transform     (GArray         *path_data,
                                                  const cairo_matrix_t*map);
 
@@ -417,7 +420,7 @@ _adg_get_cairo_path(AdgTrail *trail)
     AdgEdgesPrivate *data;
     gdouble threshold;
     CpmlSegment segment;
-    GSList *vertices;
+    GArray *vertices;
     cairo_matrix_t map;
 
     edges = (AdgEdges *) trail;
@@ -430,7 +433,7 @@ _adg_get_cairo_path(AdgTrail *trail)
     _adg_clear_cairo_path((AdgEdges *) trail);
 
     if (data->source != NULL) {
-        gint n;
+        guint n;
 
         /* The threshold is squared because the _adg_get_vertices()
          * function uses cpml_pair_squared_distance() against the
@@ -438,22 +441,22 @@ _adg_get_cairo_path(AdgTrail *trail)
         threshold = sin(data->critical_angle);
         threshold *= threshold * 2;
 
-        vertices = NULL;
+        vertices = g_array_new(FALSE, FALSE, sizeof(CpmlPair));
         for (n = 1; adg_trail_put_segment(data->source, n, &segment); ++ n) {
-            vertices = _adg_get_vertices(vertices, &segment, threshold);
+            _adg_get_vertices(vertices, &segment, threshold);
         }
 
         /* Rotate all the vertices so the axis will always be on y=0:
          * this is mainly needed to not complicate the _adg_path_build()
          * code which assumes the y=0 axis is in effect */
         cairo_matrix_init_rotate(&map, -data->axis_angle);
-        g_slist_foreach(vertices, (GFunc) cpml_pair_transform, &map);
+        for (n = 0; n < vertices->len; ++ n)
+            cpml_pair_transform(&g_array_index(vertices, CpmlPair, n), &map);
 
-        vertices = _adg_optimize_vertices(vertices);
+        _adg_optimize_vertices(vertices);
         data->cairo.array = _adg_path_build(vertices);
 
-        g_slist_foreach(vertices, (GFunc) g_free, NULL);
-        g_slist_free(vertices);
+        g_array_free(vertices, TRUE);
 
         /* Reapply the inverse of the previous transformation to
          * move the vertices to their original positions */
@@ -492,21 +495,19 @@ _adg_clear_cairo_path(AdgEdges *edges)
 
 /**
  * _adg_get_vertices:
- * @vertices: a #GSList
+ * @vertices: a #GArray of #CpmlPair
  * @segment: a #CpmlSegment
  * @threshold: a theshold value
  *
- * Collects a list of #CpmlPair corners where the angle has a minimum
- * threshold incidence of @threshold. The threshold is considered as
- * the squared distance between the two unit vectors, the one before
- * and the one after every corner.
- *
- * Returns: the original #GSList with new vertices appended.
+ * Appends to @vertices the #CpmlPair corners where the angle has a
+ * minimum threshold incidence of @threshold. The threshold is
+ * considered as the squared distance between the two unit vectors,
+ * the one before and the one after every corner.
  *
  * Since: 1.0
  **/
-static GSList *
-_adg_get_vertices(GSList *vertices, CpmlSegment *segment, gdouble threshold)
+static void
+_adg_get_vertices(GArray *vertices, CpmlSegment *segment, gdouble threshold)
 {
     CpmlPrimitive primitive;
     CpmlVector old, new;
@@ -529,58 +530,78 @@ _adg_get_vertices(GSList *vertices, CpmlSegment *segment, gdouble threshold)
         if (new.x == 0 ||
             cpml_pair_squared_distance(&old, &new) > threshold) {
             cpml_primitive_put_pair_at(&primitive, 0, &pair);
-            vertices = g_slist_append(vertices, cpml_pair_dup(&pair));
+            g_array_append_val(vertices, pair);
         }
 
         cpml_primitive_put_vector_at(&primitive, 1, &old);
     } while (cpml_primitive_next(&primitive));
-
-    return vertices;
 }
 
 /* Removes adjacent vertices lying on the same edge */
-static GSList *
-_adg_optimize_vertices(GSList *vertices)
+static void
+_adg_optimize_vertices(GArray *vertices)
 {
-    GSList *vertex, *old_vertex;
     CpmlPair *pair, *old_pair;
+    guint n, last;
 
-    /* Check for empty list */
-    if (vertices == NULL)
-        return vertices;
+    /* Check for empty array */
+    if (vertices->len == 0)
+        return;
 
-    old_vertex = vertices;
+    /* Compact the array in place: last is the index of the
+     * last preserved vertex */
+    last = 0;
 
-    while ((vertex = old_vertex->next) != NULL) {
-        pair = vertex->data;
-        old_pair = old_vertex->data;
+    for (n = 1; n < vertices->len; ++ n) {
+        pair = &g_array_index(vertices, CpmlPair, n);
+        old_pair = &g_array_index(vertices, CpmlPair, last);
 
         if (pair->x != old_pair->x) {
-            old_vertex = vertex;
+            ++ last;
+        } else if (old_pair->y < pair->y) {
+            /* Preserve the old vertex and drop the current one */
             continue;
         }
 
-        if (old_pair->y < pair->y) {
-            /* Preserve the old vertex and remove the current one */
-            g_free(pair);
-            vertices = g_slist_delete_link(vertices, vertex);
-        } else {
-            /* Preserve the current vertex and remove the old one */
-            g_free(old_pair);
-            vertices = g_slist_delete_link(vertices, old_vertex);
-            old_vertex = vertex;
-        }
+        /* Preserve the current vertex, dropping the old one if
+         * they are on the same edge */
+        g_array_index(vertices, CpmlPair, last) = *pair;
     }
 
-    return vertices;
+    g_array_set_size(vertices, last + 1);
+}
+
+/* Orders the indices of the vertices by x and, on equal x,
+ * by position, so the result is the same as a stable sort */
+static gint
+_adg_compare_x(gconstpointer a, gconstpointer b, gpointer user_data)
+{
+    const GArray *vertices;
+    guint n1, n2;
+    gdouble x1, x2;
+
+    vertices = user_data;
+    n1 = *(const guint *) a;
+    n2 = *(const guint *) b;
+    x1 = g_array_index(vertices, CpmlPair, n1).x;
+    x2 = g_array_index(vertices, CpmlPair, n2).x;
+
+    if (x1 < x2)
+        return -1;
+    if (x1 > x2)
+        return 1;
+
+    return n1 < n2 ? -1 : n1 > n2 ? 1 : 0;
 }
 
 static GArray *
-_adg_path_build(const GSList *vertices)
+_adg_path_build(const GArray *vertices)
 {
     cairo_path_data_t line[4];
     GArray *array;
-    const GSList *vertex, *vertex2;
+    guint *sorted;
+    gint *opposite;
+    guint n;
     const CpmlPair *pair, *pair2;
 
     line[0].header.type = CPML_MOVE;
@@ -589,29 +610,47 @@ _adg_path_build(const GSList *vertices)
     line[2].header.length = 2;
 
     array = g_array_new(FALSE, FALSE, sizeof(cairo_path_data_t));
-    vertex = vertices;
-
-    while (vertex != NULL) {
-        pair = vertex->data;
-        vertex = vertex->next;
-        vertex2 = vertex;
-
-        while (vertex2 != NULL) {
-            pair2 = vertex2->data;
-
-            if (pair->x == pair2->x) {
-                /* Opposite vertex found: append a line in the path
-                 * and quit from this loop */
-                cpml_pair_to_cairo(pair, &line[1]);
-                cpml_pair_to_cairo(pair2, &line[3]);
-                array = g_array_append_vals(array, line, G_N_ELEMENTS(line));
-                break;
-            }
-
-            vertex2 = vertex2->next;
-        }
+    if (vertices->len == 0)
+        return array;
+
+    /* Sort the vertex indices by x: the opposite of every vertex is
+     * the first one following it with the same x, that is the next
+     * index of the sorted array, if it has the same x */
+    sorted = g_new(guint, vertices->len);
+    opposite = g_new(gint, vertices->len);
+
+    for (n = 0; n < vertices->len; ++ n)
+        sorted[n] = n;
+
+    g_qsort_with_data(sorted, vertices->len, sizeof(guint),
+                      _adg_compare_x, (gpointer) vertices);
+
+    for (n = 0; n < vertices->len; ++ n) {
+        pair = &g_array_index(vertices, CpmlPair, sorted[n]);
+        pair2 = n + 1 < vertices->len ?
+            &g_array_index(vertices, CpmlPair, sorted[n + 1]) : NULL;
+
+        if (pair2 != NULL && pair->x == pair2->x)
+            opposite[sorted[n]] = sorted[n + 1];
+        else
+            opposite[sorted[n]] = -1;
     }
 
+    /* Append the lines in the original order of the vertices */
+    for (n = 0; n < vertices->len; ++ n) {
+        if (opposite[n] < 0)
+            continue;
+
+        pair = &g_array_index(vertices, CpmlPair, n);
+        pair2 = &g_array_index(vertices, CpmlPair, opposite[n]);
+        cpml_pair_to_cairo(pair, &line[1]);
+        cpml_pair_to_cairo(pair2, &line[3]);
+        array = g_array_append_vals(array, line, G_N_ELEMENTS(line));
+    }
+
+    g_free(opposite);
+    g_free(sorted);
+
     return array;
 }
 
@@ -24,6 +24,10 @@
 
 G_BEGIN_DECLS
 
+/* Room (in global units) to add around the extents to take into
+ * account line thickness, caps and joins, not included in them */
+#define _ADG_RENDER_MARGIN      10.
+
 typedef struct _AdgEntityPrivate AdgEntityPrivate;
 
 struct _AdgEntityPrivate {
@@ -33,6 +37,8 @@ struct _AdgEntityPrivate {
     cairo_matrix_t       local_map;
     AdgMix               local_mix;
     GHashTable          *hash_styles;
+    GPtrArray           *cached_styles;
+    gint                 styles_generation;
 
     struct {
         gboolean         is_defined;
@@ -45,8 +51,29 @@ struct _AdgEntityPrivate {
     }                    local;
 
     CpmlExtents          extents;
+    gboolean             damaged;
+    gboolean             cache;
+
+    struct {
+        cairo_surface_t *surface;
+        cairo_matrix_t   ctm;
+        gint             styles_generation;
+        gint             generation;
+        gboolean         show_extents;
+    }                    recording;
 };
 
+
+void            _adg_entity_render_extents      (AdgEntity      *entity,
+                                                 CpmlExtents    *extents);
+gboolean        _adg_entity_is_visible          (AdgEntity      *entity,
+                                                 const CpmlExtents *clip);
+void            _adg_entity_outdate_recordings  (void);
+void            _adg_entity_freeze_recordings   (void);
+void            _adg_entity_thaw_recordings     (void);
+gint            _adg_entity_get_render_generation
+                                                (void);
+
 G_END_DECLS
 
 
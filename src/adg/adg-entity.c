@@ -95,16 +95,23 @@
 #include "adg-cairo-fallback.h"
 
 #include "adg-entity-private.h"
+#include "adg-container-private.h"
 
 
 #define _ADG_OLD_OBJECT_CLASS  ((GObjectClass *) adg_entity_parent_class)
 
+/* Placeholder cached in place of the fallback style, that is never
+ * cached because it can be changed at any time and it can be
+ * different in every thread (see adg_dress_switch_thread_fallbacks()) */
+#define _ADG_FALLBACK_STYLE    ((AdgStyle *) &_adg_styles_generation)
+
 
 G_DEFINE_ABSTRACT_TYPE_WITH_PRIVATE(AdgEntity, adg_entity, G_TYPE_INITIALLY_UNOWNED)
 
 enum {
     PROP_0,
     PROP_FLOATING,
+    PROP_CACHE,
     PROP_PARENT,
     PROP_GLOBAL_MAP,
     PROP_LOCAL_MAP,
@@ -135,14 +142,32 @@ static void             _adg_set_property       (GObject         *object,
 static void             _adg_destroy            (AdgEntity       *entity);
 static void             _adg_set_parent         (AdgEntity       *entity,
                                                  AdgEntity       *parent);
+static AdgStyle *       _adg_cached_style       (AdgEntity       *entity,
+                                                 AdgDress         dress);
 static void             _adg_global_changed     (AdgEntity       *entity);
 static void             _adg_local_changed      (AdgEntity       *entity);
 static void             _adg_real_invalidate    (AdgEntity       *entity);
 static void             _adg_real_arrange       (AdgEntity       *entity);
 static void             _adg_real_render        (AdgEntity       *entity,
                                                  cairo_t         *cr);
+static gboolean         _adg_damage             (AdgEntity       *entity);
+static void             _adg_render_cached      (AdgEntity       *entity,
+                                                 cairo_t         *cr);
+static void             _adg_set_cache          (AdgEntity       *entity,
+                                                 gboolean         state);
+static void             _adg_clear_recording    (AdgEntity       *entity);
+static gboolean         _adg_is_direct          (AdgEntity       *entity,
+                                                 guint            signal);
+static void             _adg_emit_global_changed(AdgEntity       *entity);
+static void             _adg_emit_local_changed (AdgEntity       *entity);
+static void             _adg_emit_arrange       (AdgEntity       *entity);
 static guint            _adg_signals[LAST_SIGNAL] = { 0 };
-static gboolean         _adg_show_extents = FALSE;
+static gint            _adg_show_extents = FALSE;
+static gint            _adg_direct_dispatch = FALSE;
+static gint            _adg_styles_generation = 1;
+static gint            _adg_recordings_generation = 1;
+static gint            _adg_n_caches = 0;
+static GPrivate         _adg_frozen_recordings = G_PRIVATE_INIT(NULL);
 
 
 static void
@@ -173,6 +198,12 @@ adg_entity_class_init(AdgEntityClass *klass)
                                  FALSE, G_PARAM_READWRITE);
     g_object_class_install_property(gobject_class, PROP_FLOATING, param);
 
+    param = g_param_spec_boolean("cache",
+                                 P_("Render Cache"),
+                                 P_("Whether the rendering of this entity and of its children should be recorded and replayed until the entity is invalidated"),
+                                 FALSE, G_PARAM_READWRITE);
+    g_object_class_install_property(gobject_class, PROP_CACHE, param);
+
     param = g_param_spec_object("parent",
                                 P_("Parent Entity"),
                                 P_("The parent entity of this entity or NULL if this is a top-level entity"),
@@ -354,11 +385,16 @@ adg_entity_init(AdgEntity *entity)
     cairo_matrix_init_identity(&data->local_map);
     data->local_mix = ADG_MIX_ANCESTORS;
     data->hash_styles = NULL;
+    data->cached_styles = NULL;
+    data->styles_generation = 0;
     data->global.is_defined = FALSE;
     adg_matrix_copy(&data->global.matrix, adg_matrix_null());
     data->local.is_defined = FALSE;
     adg_matrix_copy(&data->local.matrix, adg_matrix_null());
     data->extents.is_defined = FALSE;
+    data->damaged = TRUE;
+    data->cache = FALSE;
+    data->recording.surface = NULL;
 }
 
 static void
@@ -374,8 +410,17 @@ _adg_dispose(GObject *object)
     if (data->hash_styles != NULL) {
         g_hash_table_destroy(data->hash_styles);
         data->hash_styles = NULL;
+        g_atomic_int_inc(&_adg_styles_generation);
+    }
+
+    if (data->cached_styles != NULL) {
+        g_ptr_array_free(data->cached_styles, TRUE);
+        data->cached_styles = NULL;
     }
 
+    _adg_clear_recording(entity);
+    _adg_set_cache(entity, FALSE);
+
     if (_ADG_OLD_OBJECT_CLASS->dispose)
         _ADG_OLD_OBJECT_CLASS->dispose(object);
 }
@@ -391,6 +436,9 @@ _adg_get_property(GObject *object, guint prop_id,
     case PROP_FLOATING:
         g_value_set_boolean(value, data->floating);
         break;
+    case PROP_CACHE:
+        g_value_set_boolean(value, data->cache);
+        break;
     case PROP_PARENT:
         g_value_set_object(value, data->parent);
         break;
@@ -419,6 +467,10 @@ _adg_set_property(GObject *object, guint prop_id,
     case PROP_FLOATING:
         data->floating = g_value_get_boolean(value);
         break;
+    case PROP_CACHE:
+        _adg_clear_recording((AdgEntity *) object);
+        _adg_set_cache((AdgEntity *) object, g_value_get_boolean(value));
+        break;
     case PROP_PARENT:
         _adg_set_parent((AdgEntity *) object,
                         (AdgEntity *) g_value_get_object(value));
@@ -455,7 +507,35 @@ _adg_set_property(GObject *object, guint prop_id,
 void
 adg_switch_extents(gboolean state)
 {
-    _adg_show_extents = state;
+    g_atomic_int_set(&_adg_show_extents, state);
+    _adg_entity_outdate_recordings();
+}
+
+/**
+ * adg_switch_direct_dispatch:
+ * @state: new direct dispatch state
+ *
+ * Enables (if @state is <constant>TRUE</constant>) or disables the
+ * direct dispatch of the #AdgEntity::global-changed,
+ * #AdgEntity::local-changed, #AdgEntity::invalidate,
+ * #AdgEntity::arrange and #AdgEntity::render signals.
+ *
+ * When enabled, adg_entity_arrange() and friends call the default
+ * handlers directly, skipping the signal emission, if no handler is
+ * connected to that signal on the involved entity. Entities with
+ * connected handlers still emit the signal, so the observable
+ * behavior does not change. The only exception are the emission
+ * hooks (see g_signal_add_emission_hook()) that are not invoked on
+ * entities without handlers.
+ *
+ * This is disabled by default.
+ *
+ * Since: 1.0
+ **/
+void
+adg_switch_direct_dispatch(gboolean state)
+{
+    g_atomic_int_set(&_adg_direct_dispatch, state);
 }
 
 /**
@@ -530,6 +610,60 @@ adg_entity_has_floating(AdgEntity *entity)
     return data->floating;
 }
 
+/**
+ * adg_entity_switch_cache:
+ * @entity: an #AdgEntity
+ * @new_state: the new cache state
+ *
+ * Enables or disables the render cache of @entity.
+ *
+ * When enabled, the first rendering of @entity (children included)
+ * is recorded on a cairo recording surface that will be replayed
+ * by the subsequent adg_entity_render() calls. The recording is
+ * dropped whenever @entity or any of its descendants is invalidated
+ * or changes its matrices, when the transformation of the cairo
+ * context changes (a plain translation simply moves the replayed
+ * recording) or when any style is modified, that is when a
+ * style property is changed, a style is invalidated, a different
+ * style is bound to an entity or a fallback style is replaced.
+ *
+ * This is useful for static and expensive entities, such as the
+ * title block, that would otherwise be rendered from scratch on
+ * every frame. The rendering is recorded on a brand new context, so
+ * the cached entity should not depend on the state (e.g. the source)
+ * of the cairo context it is rendered to.
+ *
+ * Since: 1.0
+ **/
+void
+adg_entity_switch_cache(AdgEntity *entity, gboolean new_state)
+{
+    g_return_if_fail(ADG_IS_ENTITY(entity));
+    g_object_set(entity, "cache", new_state, NULL);
+}
+
+/**
+ * adg_entity_has_cache:
+ * @entity: an #AdgEntity
+ *
+ * Checks if @entity has the render cache enabled. See
+ * adg_entity_switch_cache() for details.
+ *
+ * Returns: the current state of the cache flag.
+ *
+ * Since: 1.0
+ **/
+gboolean
+adg_entity_has_cache(AdgEntity *entity)
+{
+    AdgEntityPrivate *data;
+
+    g_return_val_if_fail(ADG_IS_ENTITY(entity), FALSE);
+
+    data = adg_entity_get_instance_private(entity);
+    return data->cache;
+}
+
 /**
  * adg_entity_get_canvas:
  * @entity: an #AdgEntity
@@ -958,6 +1092,7 @@ adg_entity_set_style(AdgEntity *entity, AdgDress dress, AdgStyle *style)
 
     if (style == NULL) {
         g_hash_table_remove(data->hash_styles, p_dress);
+        g_atomic_int_inc(&_adg_styles_generation);
         return;
     }
 
@@ -973,6 +1108,7 @@ adg_entity_set_style(AdgEntity *entity, AdgDress dress, AdgStyle *style)
 
     g_object_ref(style);
     g_hash_table_replace(data->hash_styles, p_dress, style);
+    g_atomic_int_inc(&_adg_styles_generation);
 }
 
 /**
@@ -1023,6 +1159,13 @@ adg_entity_get_style(AdgEntity *entity, AdgDress dress)
  * <listitem>returns the main style with adg_dress_get_fallback().</listitem>
  * </orderedlist>
  *
+ * The result of the first two steps is cached by every entity, so
+ * this function does not walk the hierarchy on every call. The cache
+ * is invalidated whenever a style is overriden with
+ * adg_entity_set_style() or an entity is reparented. The fallback
+ * style is not cached, so changing it with adg_dress_set_fallback()
+ * is immediately effective.
+ *
  * The returned object is owned by @entity and should not be
  * freed or modified.
  *
@@ -1037,16 +1180,9 @@ adg_entity_style(AdgEntity *entity, AdgDress dress)
 
     g_return_val_if_fail(ADG_IS_ENTITY(entity), NULL);
 
-    style = adg_entity_get_style(entity, dress);
-
-    if (style == NULL) {
-        AdgEntityPrivate *data = adg_entity_get_instance_private(entity);
-
-        if (data->parent != NULL)
-            style = adg_entity_style(data->parent, dress);
-        else
-            style = adg_dress_get_fallback(dress);
-    }
+    style = _adg_cached_style(entity, dress);
+    if (style == _ADG_FALLBACK_STYLE)
+        style = adg_dress_get_fallback(dress);
 
     return style;
 }
@@ -1090,7 +1226,7 @@ adg_entity_global_changed(AdgEntity *entity)
 {
     g_return_if_fail(ADG_IS_ENTITY(entity));
 
-    g_signal_emit(entity, _adg_signals[GLOBAL_CHANGED], 0);
+    _adg_emit_global_changed(entity);
 }
 
 /**
@@ -1107,7 +1243,7 @@ adg_entity_local_changed(AdgEntity *entity)
 {
     g_return_if_fail(ADG_IS_ENTITY(entity));
 
-    g_signal_emit(entity, _adg_signals[LOCAL_CHANGED], 0);
+    _adg_emit_local_changed(entity);
 }
 
 /**
@@ -1126,7 +1262,10 @@ adg_entity_invalidate(AdgEntity *entity)
 {
     g_return_if_fail(ADG_IS_ENTITY(entity));
 
-    g_signal_emit(entity, _adg_signals[INVALIDATE], 0);
+    if (_adg_is_direct(entity, INVALIDATE))
+        _adg_real_invalidate(entity);
+    else
+        g_signal_emit(entity, _adg_signals[INVALIDATE], 0);
 }
 
 /**
@@ -1144,7 +1283,7 @@ adg_entity_arrange(AdgEntity *entity)
 {
     g_return_if_fail(ADG_IS_ENTITY(entity));
 
-    g_signal_emit(entity, _adg_signals[ARRANGE], 0);
+    _adg_emit_arrange(entity);
 }
 
 /**
@@ -1162,7 +1301,10 @@ adg_entity_render(AdgEntity *entity, cairo_t *cr)
 {
     g_return_if_fail(ADG_IS_ENTITY(entity));
 
-    g_signal_emit(entity, _adg_signals[RENDER], 0, cr);
+    if (_adg_is_direct(entity, RENDER))
+        _adg_real_render(entity, cr);
+    else
+        g_signal_emit(entity, _adg_signals[RENDER], 0, cr);
 }
 
 /**
@@ -1184,7 +1326,9 @@ adg_entity_render(AdgEntity *entity, cairo_t *cr)
  * </programlisting></informalexample>
  *
  * This function takes care of the dependencies between @entity and
- * the eventual models bound to the old and new points.
+ * the eventual named pairs bound to the old and new points: @entity
+ * will be invalidated only when one of those named pairs changes (see
+ * adg_model_add_pair_dependency()).
  *
  * @old_point can be <constant>NULL</constant>, in which case a
  * clone of @new_point will be returned. Also @new_point can
@@ -1210,13 +1354,16 @@ adg_entity_point(AdgEntity *entity, AdgPoint *old_point, const AdgPoint *new_poi
         old_model = old_point != NULL ? adg_point_get_model(old_point) : NULL;
         new_model = new_point != NULL ? adg_point_get_model(new_point) : NULL;
 
-        if (new_model != old_model) {
-            /* Handle model-entity dependencies */
-            if (new_model != NULL)
-                adg_model_add_dependency(new_model, entity);
-            if (old_model != NULL)
-                adg_model_remove_dependency(old_model, entity);
-        }
+        /* Handle the dependencies on the named pairs: adg_point_equal()
+         * already ensured the model or the name is different */
+        if (new_model != NULL)
+            adg_model_add_pair_dependency(new_model,
+                                          adg_point_get_name(new_point),
+                                          entity);
+        if (old_model != NULL)
+            adg_model_remove_pair_dependency(old_model,
+                                             adg_point_get_name(old_point),
+                                             entity);
 
         if (new_point != NULL)
             point = adg_point_dup(new_point);
@@ -1228,6 +1375,82 @@ adg_entity_point(AdgEntity *entity, AdgPoint *old_point, const AdgPoint *new_poi
 }
 
 
+/* Gets the area that could be painted by @entity: its extents, the
+ * extents of its floating descendants (if @entity is a container)
+ * and a margin around them for the line thickness, caps and joins */
+void
+_adg_entity_render_extents(AdgEntity *entity, CpmlExtents *extents)
+{
+    AdgEntityPrivate *data = adg_entity_get_instance_private(entity);
+
+    cpml_extents_copy(extents, &data->extents);
+
+    /* Floating children are not included in the container extents
+     * but they are rendered together with the container */
+    if (ADG_IS_CONTAINER(entity))
+        cpml_extents_add(extents,
+                         _adg_container_get_floating_extents((AdgContainer *) entity));
+
+    if (! extents->is_defined)
+        return;
+
+    extents->org.x -= _ADG_RENDER_MARGIN;
+    extents->org.y -= _ADG_RENDER_MARGIN;
+    extents->size.x += _ADG_RENDER_MARGIN * 2;
+    extents->size.y += _ADG_RENDER_MARGIN * 2;
+}
+
+/* Checks if @entity could paint something inside @clip, expressed in
+ * global space. Entities without extents are always visible. */
+gboolean
+_adg_entity_is_visible(AdgEntity *entity, const CpmlExtents *clip)
+{
+    CpmlExtents extents;
+
+    _adg_entity_render_extents(entity, &extents);
+
+    return ! extents.is_defined || cpml_extents_is_intersecting(clip, &extents);
+}
+
+/* Drops the render cache of every entity: called whenever the same
+ * style could render differently, e.g. after a property change */
+void
+_adg_entity_outdate_recordings(void)
+{
+    if (g_private_get(&_adg_frozen_recordings) == NULL)
+        g_atomic_int_inc(&_adg_recordings_generation);
+}
+
+/* Ignores _adg_entity_outdate_recordings() in the calling thread until
+ * the matching _adg_entity_thaw_recordings(): useful while building
+ * styles that cannot have been used by any entity yet */
+void
+_adg_entity_freeze_recordings(void)
+{
+    gint n_freezes = GPOINTER_TO_INT(g_private_get(&_adg_frozen_recordings));
+    g_private_set(&_adg_frozen_recordings, GINT_TO_POINTER(n_freezes + 1));
+}
+
+void
+_adg_entity_thaw_recordings(void)
+{
+    gint n_freezes = GPOINTER_TO_INT(g_private_get(&_adg_frozen_recordings));
+    g_return_if_fail(n_freezes > 0);
+    g_private_set(&_adg_frozen_recordings, GINT_TO_POINTER(n_freezes - 1));
+}
+
+/* Gets a value that changes whenever an entity could render differently
+ * without being invalidated, e.g. after binding or changing a style:
+ * renderings retained outside the entities must be dropped then */
+gint
+_adg_entity_get_render_generation(void)
+{
+    /* Both counters only increase, so their sum changes with any of them */
+    return g_atomic_int_get(&_adg_styles_generation) +
+        g_atomic_int_get(&_adg_recordings_generation);
+}
+
+
 static void
 _adg_destroy(AdgEntity *entity)
 {
@@ -1243,13 +1466,66 @@ _adg_set_parent(AdgEntity *entity, AdgEntity *parent)
     AdgEntityPrivate *data = adg_entity_get_instance_private(entity);
     AdgEntity *old_parent = data->parent;
 
+    /* Both the old and the new ancestors must render entity again */
+    _adg_clear_recording(entity);
+
     data->parent = parent;
     data->global.is_defined = FALSE;
     data->local.is_defined = FALSE;
 
+    /* The resolved styles of the whole subtree could be changed */
+    g_atomic_int_inc(&_adg_styles_generation);
+
     g_signal_emit(entity, _adg_signals[PARENT_SET], 0, old_parent);
 }
 
+/* Gets the style resolved by the first two steps of adg_entity_style()
+ * or _ADG_FALLBACK_STYLE if the fallback style must be used */
+static AdgStyle *
+_adg_cached_style(AdgEntity *entity, AdgDress dress)
+{
+    AdgEntityPrivate *data;
+    gint generation;
+    AdgStyle *style;
+
+    data = adg_entity_get_instance_private(entity);
+    generation = g_atomic_int_get(&_adg_styles_generation);
+
+    if (data->cached_styles == NULL) {
+        data->cached_styles = g_ptr_array_new();
+    } else if (data->styles_generation != generation) {
+        g_ptr_array_set_size(data->cached_styles, 0);
+    }
+    data->styles_generation = generation;
+
+    if (dress <= ADG_DRESS_UNDEFINED)
+        return NULL;
+
+    if ((guint) dress >= data->cached_styles->len) {
+        /* Do not grow the cache for unregistered dresses */
+        if (adg_dress_get_ancestor_type(dress) == 0)
+            return NULL;
+        g_ptr_array_set_size(data->cached_styles, dress + 1);
+    }
+
+    style = g_ptr_array_index(data->cached_styles, dress);
+    if (style != NULL)
+        return style;
+
+    style = adg_entity_get_style(entity, dress);
+    if (style == NULL) {
+        if (data->parent != NULL)
+            style = _adg_cached_style(data->parent, dress);
+        else
+            style = _ADG_FALLBACK_STYLE;
+    }
+
+    if (style != NULL)
+        g_ptr_array_index(data->cached_styles, dress) = style;
+
+    return style;
+}
+
 static void
 _adg_global_changed(AdgEntity *entity)
 {
@@ -1257,6 +1533,8 @@ _adg_global_changed(AdgEntity *entity)
     const cairo_matrix_t *map = &data->global_map;
     cairo_matrix_t *matrix = &data->global.matrix;
 
+    _adg_clear_recording(entity);
+
     if (data->parent) {
         adg_matrix_copy(matrix, adg_entity_get_global_matrix(data->parent));
         adg_matrix_transform(matrix, map, ADG_TRANSFORM_BEFORE);
@@ -1272,6 +1550,8 @@ _adg_local_changed(AdgEntity *entity)
     const cairo_matrix_t *map = &data->local_map;
     cairo_matrix_t *matrix = &data->local.matrix;
 
+    _adg_clear_recording(entity);
+
     switch (data->local_mix) {
     case ADG_MIX_DISABLED:
         adg_matrix_copy(matrix, adg_matrix_identity());
@@ -1334,7 +1614,12 @@ _adg_real_invalidate(AdgEntity *entity)
     if (klass->invalidate)
         klass->invalidate(entity);
 
+    /* The area covered by the old extents must be repainted */
+    _adg_damage(entity);
+    _adg_clear_recording(entity);
+
     data->extents.is_defined = FALSE;
+    data->damaged = TRUE;
 }
 
 static void
@@ -1346,13 +1631,13 @@ _adg_real_arrange(AdgEntity *entity)
     /* Update the global matrix, if required */
     if (!data->global.is_defined) {
         data->global.is_defined = TRUE;
-        g_signal_emit(entity, _adg_signals[GLOBAL_CHANGED], 0);
+        _adg_emit_global_changed(entity);
     }
 
     /* Update the local matrix, if required */
     if (!data->local.is_defined) {
         data->local.is_defined = TRUE;
-        g_signal_emit(entity, _adg_signals[LOCAL_CHANGED], 0);
+        _adg_emit_local_changed(entity);
     }
 
     /* The arrange() method must be defined */
@@ -1364,12 +1649,17 @@ _adg_real_arrange(AdgEntity *entity)
     }
 
     klass->arrange(entity);
+
+    /* The area covered by the new extents must be repainted too */
+    if (data->damaged && _adg_damage(entity))
+        data->damaged = FALSE;
 }
 
 static void
 _adg_real_render(AdgEntity *entity, cairo_t *cr)
 {
     AdgEntityClass *klass = ADG_ENTITY_GET_CLASS(entity);
+    AdgEntityPrivate *data = adg_entity_get_instance_private(entity);
 
     /* The render method must be defined */
     if (klass->render == NULL) {
@@ -1379,14 +1669,33 @@ _adg_real_render(AdgEntity *entity, cairo_t *cr)
     }
 
     /* Before the rendering, the entity should be arranged */
-    g_signal_emit(entity, _adg_signals[ARRANGE], 0);
+    _adg_emit_arrange(entity);
+
+    /* Skip the whole subtree if it does not cross the clipping area:
+     * toplevel entities are always rendered because they can draw
+     * outside their extents (e.g. the margins of a canvas), while the
+     * children of a container are already culled by their parent */
+    if (data->parent != NULL && ! ADG_IS_CONTAINER(data->parent)) {
+        CpmlExtents clip;
+        gdouble x2, y2;
+
+        cairo_clip_extents(cr, &clip.org.x, &clip.org.y, &x2, &y2);
+        clip.is_defined = 1;
+        clip.size.x = x2 - clip.org.x;
+        clip.size.y = y2 - clip.org.y;
+
+        if (! _adg_entity_is_visible(entity, &clip))
+            return;
+    }
 
     cairo_save(cr);
-    klass->render(entity, cr);
+    if (data->cache)
+        _adg_render_cached(entity, cr);
+    else
+        klass->render(entity, cr);
     cairo_restore(cr);
 
-    if (_adg_show_extents) {
-        AdgEntityPrivate *data = adg_entity_get_instance_private(entity);
+    if (g_atomic_int_get(&_adg_show_extents)) {
         CpmlExtents *extents = &data->extents;
 
         if (extents->is_defined) {
@@ -1399,3 +1708,166 @@ _adg_real_render(AdgEntity *entity, cairo_t *cr)
         }
     }
 }
+
+static gboolean
+_adg_damage(AdgEntity *entity)
+{
+    AdgCanvas *canvas = adg_entity_get_canvas(entity);
+    CpmlExtents extents;
+
+    /* Damages make sense only inside a canvas */
+    if (canvas == NULL)
+        return FALSE;
+
+    _adg_entity_render_extents(entity, &extents);
+    adg_canvas_add_damage(canvas, &extents);
+    return TRUE;
+}
+
+static void
+_adg_render_cached(AdgEntity *entity, cairo_t *cr)
+{
+#ifdef CAIRO_HAS_RECORDING_SURFACE
+    AdgEntityClass *klass = ADG_ENTITY_GET_CLASS(entity);
+    AdgEntityPrivate *data = adg_entity_get_instance_private(entity);
+    gint styles_generation = g_atomic_int_get(&_adg_styles_generation);
+    gint generation = g_atomic_int_get(&_adg_recordings_generation);
+    gboolean show_extents = g_atomic_int_get(&_adg_show_extents);
+    cairo_matrix_t ctm;
+    gdouble x0, y0;
+    cairo_surface_t *surface;
+    cairo_t *recorder;
+
+    /* Record without translation, so the same recording can be
+     * replayed when only the position changes (e.g. tiles or scroll) */
+    cairo_get_matrix(cr, &ctm);
+    x0 = ctm.x0;
+    y0 = ctm.y0;
+    ctm.x0 = 0;
+    ctm.y0 = 0;
+
+    /* The changes of the subtree are tracked by _adg_clear_recording():
+     * here only the changes coming from outside are checked */
+    if (data->recording.surface != NULL &&
+        (data->recording.styles_generation != styles_generation ||
+         data->recording.generation != generation ||
+         data->recording.show_extents != show_extents ||
+         ! adg_matrix_equal(&data->recording.ctm, &ctm))) {
+        cairo_surface_destroy(data->recording.surface);
+        data->recording.surface = NULL;
+    }
+
+    if (data->recording.surface == NULL) {
+        /* Rendering the children can clear the recording of their
+         * ancestors (e.g. when arranged for the first time), so the
+         * new surface is stored only after the recording is done */
+        surface = cairo_recording_surface_create(CAIRO_CONTENT_COLOR_ALPHA,
+                                                 NULL);
+        recorder = cairo_create(surface);
+        cairo_set_matrix(recorder, &ctm);
+        klass->render(entity, recorder);
+        cairo_destroy(recorder);
+
+        /* Styles changed while recording (e.g. a lazily built
+         * pattern) are already included in the recording */
+        generation = g_atomic_int_get(&_adg_recordings_generation);
+
+        data->recording.surface = surface;
+        adg_matrix_copy(&data->recording.ctm, &ctm);
+        data->recording.styles_generation = styles_generation;
+        data->recording.generation = generation;
+        data->recording.show_extents = show_extents;
+    }
+
+    /* The recording is expressed in device space, without translation */
+    cairo_identity_matrix(cr);
+    cairo_set_source_surface(cr, data->recording.surface, x0, y0);
+    cairo_paint(cr);
+#else
+    ADG_ENTITY_GET_CLASS(entity)->render(entity, cr);
+#endif
+}
+
+static void
+_adg_set_cache(AdgEntity *entity, gboolean state)
+{
+    AdgEntityPrivate *data = adg_entity_get_instance_private(entity);
+
+    state = state != FALSE;
+    if (data->cache == state)
+        return;
+
+    data->cache = state;
+    if (state)
+        g_atomic_int_inc(&_adg_n_caches);
+    else
+        g_atomic_int_add(&_adg_n_caches, -1);
+}
+
+/* Drops the render cache of entity and of all its ancestors,
+ * as their recordings include the rendering of entity */
+static void
+_adg_clear_recording(AdgEntity *entity)
+{
+    AdgEntityPrivate *data;
+
+    /* Nothing to clear if no entity has the cache enabled */
+    if (g_atomic_int_get(&_adg_n_caches) == 0)
+        return;
+
+    for (; entity != NULL; entity = data->parent) {
+        data = adg_entity_get_instance_private(entity);
+        if (data->recording.surface != NULL) {
+            cairo_surface_destroy(data->recording.surface);
+            data->recording.surface = NULL;
+        }
+    }
+}
+
+/* Checks if the default handler of signal (an index of _adg_signals)
+ * can be called directly, skipping the GSignal machinery */
+static gboolean
+_adg_is_direct(AdgEntity *entity, guint signal)
+{
+    return g_atomic_int_get(&_adg_direct_dispatch) &&
+           ! g_signal_has_handler_pending(entity, _adg_signals[signal], 0, TRUE);
+}
+
+static void
+_adg_emit_global_changed(AdgEntity *entity)
+{
+    AdgEntityClass *klass;
+
+    if (! _adg_is_direct(entity, GLOBAL_CHANGED)) {
+        g_signal_emit(entity, _adg_signals[GLOBAL_CHANGED], 0);
+        return;
+    }
+
+    klass = ADG_ENTITY_GET_CLASS(entity);
+    if (klass->global_changed)
+        klass->global_changed(entity);
+}
+
+static void
+_adg_emit_local_changed(AdgEntity *entity)
+{
+    AdgEntityClass *klass;
+
+    if (! _adg_is_direct(entity, LOCAL_CHANGED)) {
+        g_signal_emit(entity, _adg_signals[LOCAL_CHANGED], 0);
+        return;
+    }
+
+    klass = ADG_ENTITY_GET_CLASS(entity);
+    if (klass->local_changed)
+        klass->local_changed(entity);
+}
+
+static void
+_adg_emit_arrange(AdgEntity *entity)
+{
+    if (_adg_is_direct(entity, ARRANGE))
+        _adg_real_arrange(entity);
+    else
+        g_signal_emit(entity, _adg_signals[ARRANGE], 0);
+}
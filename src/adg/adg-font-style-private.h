@@ -24,6 +24,9 @@
 
 G_BEGIN_DECLS
 
+/* Number of scaled fonts (one per different CTM) kept in cache */
+#define ADG_FONT_STYLE_CACHE_SIZE  4
+
 typedef struct _AdgFontStylePrivate AdgFontStylePrivate;
 
 struct _AdgFontStylePrivate {
@@ -38,7 +41,9 @@ struct _AdgFontStylePrivate {
     cairo_hint_metrics_t         hint_metrics;
 
     cairo_font_face_t           *face;
-    cairo_scaled_font_t         *font;
+    /* Most recently used first */
+    cairo_scaled_font_t         *fonts[ADG_FONT_STYLE_CACHE_SIZE];
+    guint                        n_fonts;
 };
 
 G_END_DECLS
@@ -46,6 +46,8 @@
 #include "adg-font-style.h"
 #include "adg-font-style-private.h"
 
+#include <string.h>
+
 
 #define _ADG_OLD_OBJECT_CLASS  ((GObjectClass *) adg_font_style_parent_class)
 
@@ -175,7 +177,8 @@ adg_font_style_init(AdgFontStyle *font_style)
     data->subpixel_order = CAIRO_SUBPIXEL_ORDER_DEFAULT;
     data->hint_style = CAIRO_HINT_STYLE_DEFAULT;
     data->hint_metrics = CAIRO_HINT_METRICS_DEFAULT;
-    data->font = NULL;
+    data->face = NULL;
+    data->n_fonts = 0;
 }
 
 static void
@@ -309,8 +312,8 @@ adg_font_style_new_options(AdgFontStyle *font_style)
     options = cairo_font_options_create();
 
     /* Check for cached font */
-    if (data->font != NULL) {
-        cairo_scaled_font_get_font_options(data->font, options);
+    if (data->n_fonts > 0) {
+        cairo_scaled_font_get_font_options(data->fonts[0], options);
     } else {
         cairo_font_options_set_antialias(options, data->antialias);
         cairo_font_options_set_subpixel_order(options, data->subpixel_order);
@@ -329,6 +332,13 @@ adg_font_style_new_options(AdgFontStyle *font_style)
  * Gets the scaled font of @font_style. The returned font is
  * owned by @font_style and must not be destroyed by the caller.
  *
+ * The last scaled fonts used are cached by @font_style, keyed by
+ * the linear part of @ctm, so entities rendered at different
+ * rotations or scales can share the same style without rebuilding
+ * the scaled font at every call. The least recently used font is
+ * dropped when the cache is full: use cairo_scaled_font_reference()
+ * to keep the returned font alive.
+ *
  * Returns: (transfer none): the scaled font.
  *
  * Since: 1.0
@@ -339,41 +349,57 @@ adg_font_style_get_scaled_font(AdgFontStyle *font_style,
 {
     AdgFontStylePrivate *data;
     cairo_font_options_t *options;
-    cairo_matrix_t matrix;
+    cairo_matrix_t matrix, font_ctm;
+    cairo_scaled_font_t *font;
+    guint n;
 
     g_return_val_if_fail(ADG_IS_FONT_STYLE(font_style), NULL);
     g_return_val_if_fail(ctm != NULL, NULL);
 
     data = adg_font_style_get_instance_private(font_style);
 
-    /* Check for cached font */
-    if (data->font != NULL) {
-        cairo_matrix_t font_ctm;
-
-        cairo_scaled_font_get_ctm(data->font, &font_ctm);
+    /* Look for a cached font with the same linear part of the ctm:
+     * the font options are not checked because they are the same
+     * for every font, as any property change invalidates the cache */
+    for (n = 0; n < data->n_fonts; ++n) {
+        cairo_scaled_font_get_ctm(data->fonts[n], &font_ctm);
 
-        /* The scaled font is valid only if the two ctm match */
         if (ctm->xx == font_ctm.xx && ctm->yy == font_ctm.yy &&
             ctm->xy == font_ctm.xy && ctm->yx == font_ctm.yx)
-            return data->font;
-
-        /* No valid cache found: rebuild the scaled font */
-        adg_style_invalidate((AdgStyle *) font_style);
+            break;
     }
 
-    if (data->face == NULL) {
-        const gchar *family = data->family != NULL ? data->family : "";
-
-        data->face = cairo_toy_font_face_create(family, data->slant,
-                                                data->weight);
+    if (n < data->n_fonts) {
+        /* Cache hit */
+        font = data->fonts[n];
+    } else {
+        /* Cache miss: build a new scaled font */
+        if (data->face == NULL) {
+            const gchar *family = data->family != NULL ? data->family : "";
+
+            data->face = cairo_toy_font_face_create(family, data->slant,
+                                                    data->weight);
+        }
+
+        cairo_matrix_init_scale(&matrix, data->size, data->size);
+        options = adg_font_style_new_options(font_style);
+        font = cairo_scaled_font_create(data->face, &matrix, ctm, options);
+        cairo_font_options_destroy(options);
+
+        /* Drop the least recently used font, if needed */
+        if (data->n_fonts < ADG_FONT_STYLE_CACHE_SIZE)
+            ++data->n_fonts;
+        else
+            cairo_scaled_font_destroy(data->fonts[ADG_FONT_STYLE_CACHE_SIZE - 1]);
+
+        n = data->n_fonts - 1;
     }
 
-    cairo_matrix_init_scale(&matrix, data->size, data->size);
-    options = adg_font_style_new_options(font_style);
-    data->font = cairo_scaled_font_create(data->face, &matrix, ctm, options);
-    cairo_font_options_destroy(options);
+    /* Move the font in front of the cache */
+    memmove(data->fonts + 1, data->fonts, n * sizeof(cairo_scaled_font_t *));
+    data->fonts[0] = font;
 
-    return data->font;
+    return font;
 }
 
 /**
@@ -740,12 +766,13 @@ _adg_invalidate(AdgStyle *style)
     AdgFontStyle *font_style = (AdgFontStyle *) style;
     AdgFontStylePrivate *data = adg_font_style_get_instance_private(font_style);
 
-    if (data->font != NULL) {
-        cairo_scaled_font_destroy(data->font);
-        data->font = NULL;
+    while (data->n_fonts > 0) {
+        --data->n_fonts;
+        cairo_scaled_font_destroy(data->fonts[data->n_fonts]);
+        data->fonts[data->n_fonts] = NULL;
     }
 
-    if (data->face == NULL) {
+    if (data->face != NULL) {
         cairo_font_face_destroy(data->face);
         data->face = NULL;
     }
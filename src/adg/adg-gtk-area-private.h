@@ -24,17 +24,29 @@
 
 G_BEGIN_DECLS
 
+typedef struct _AdgTileLevel AdgTileLevel;
 typedef struct _AdgGtkAreaPrivate AdgGtkAreaPrivate;
 
+struct _AdgTileLevel {
+    gdouble          zoom;
+    GHashTable      *tiles;
+};
+
 struct _AdgGtkAreaPrivate {
     AdgCanvas       *canvas;
     gdouble          factor;
     gboolean         autozoom;
     cairo_matrix_t   render_map;
+    gboolean         tile_cache;
 
     gboolean         initialized;
     CpmlExtents      extents;
     gdouble          x_event, y_event;
+    GSList          *levels;
+    gint             tiles_generation;
+    guint            prefetch_id;
+    GArray          *deferred;
+    guint            deferred_id;
 };
 
 G_END_DECLS
@@ -47,6 +47,17 @@
  * without affecting the other layers. Local transformations,
  * instead, are directly applied to the local matrix of the canvas.
  *
+ * When the #AdgGtkArea:tile-cache property is enabled, the canvas is
+ * rendered on fixed size tiles that are retained between redraws.
+ * Panning or zooming in global space (that is, changing the render
+ * map) will then blit the cached tiles instead of rendering the
+ * whole drawing again: only the tiles crossing the damaged areas of
+ * the canvas (see adg_canvas_get_damage()) are rendered again, while
+ * any style change or adg_switch_extents() call drops all of them. While
+ * idle, the tiles of the next zoom step in both directions are
+ * rendered ahead of time, so a wheel zoom in global space does not
+ * have to wait for the rendering.
+ *
  * Since: 1.0
  **/
 
@@ -82,6 +93,7 @@
 #include <gtk/gtk.h>
 
 #include "adg-container.h"
+#include "adg-alignment.h"
 #include "adg-table.h"
 #include "adg-title-block.h"
 #include <adg-canvas.h>
@@ -90,10 +102,21 @@
 
 #include "adg-gtk-area.h"
 #include "adg-gtk-area-private.h"
+#include "adg-entity-private.h"
+
+#include <math.h>
 
 #define _ADG_OLD_OBJECT_CLASS   ((GObjectClass *) adg_gtk_area_parent_class)
 #define _ADG_OLD_WIDGET_CLASS   ((GtkWidgetClass *) adg_gtk_area_parent_class)
 
+#define _ADG_TILE_SIZE          256
+#define _ADG_MAX_TILES          128
+#define _ADG_ZOOM_EPSILON       1e-6
+
+#define _ADG_TILE_KEY(x, y)     GUINT_TO_POINTER((((guint) (x) & 0xffff) << 16) | ((guint) (y) & 0xffff))
+#define _ADG_TILE_X(key)        ((gint16) (GPOINTER_TO_UINT(key) >> 16))
+#define _ADG_TILE_Y(key)        ((gint16) (GPOINTER_TO_UINT(key) & 0xffff))
+
 
 G_DEFINE_TYPE_WITH_PRIVATE(AdgGtkArea, adg_gtk_area, GTK_TYPE_DRAWING_AREA)
 
@@ -102,7 +125,8 @@ enum {
     PROP_CANVAS,
     PROP_FACTOR,
     PROP_AUTOZOOM,
-    PROP_RENDER_MAP
+    PROP_RENDER_MAP,
+    PROP_TILE_CACHE
 };
 
 enum {
@@ -146,6 +170,492 @@ _adg_get_extents(AdgGtkArea *area)
     return &data->extents;
 }
 
+static AdgEntity *
+_adg_entity_at(AdgContainer *container, const CpmlPair *pair)
+{
+    GSList *hits, *node;
+    AdgEntity *entity, *found;
+
+    /* The last rendered child is the topmost one */
+    hits = g_slist_reverse(adg_container_query_pair(container, pair));
+    found = NULL;
+
+    for (node = hits; node != NULL && found == NULL; node = node->next) {
+        entity = node->data;
+
+        /* The children of an alignment are displaced at rendering
+         * time, so the alignment is considered as a whole */
+        if (ADG_IS_CONTAINER(entity) && ! ADG_IS_ALIGNMENT(entity))
+            found = _adg_entity_at((AdgContainer *) entity, pair);
+        else
+            found = entity;
+    }
+
+    g_slist_free(hits);
+    return found;
+}
+
+static void
+_adg_level_free(AdgTileLevel *level)
+{
+    g_hash_table_destroy(level->tiles);
+    g_free(level);
+}
+
+static void
+_adg_drop_tiles(AdgGtkArea *area)
+{
+    AdgGtkAreaPrivate *data = adg_gtk_area_get_instance_private(area);
+
+    if (data->prefetch_id != 0) {
+        g_source_remove(data->prefetch_id);
+        data->prefetch_id = 0;
+    }
+
+    g_slist_free_full(data->levels, (GDestroyNotify) _adg_level_free);
+    data->levels = NULL;
+}
+
+static gboolean
+_adg_is_tileable(AdgGtkArea *area)
+{
+    AdgGtkAreaPrivate *data = adg_gtk_area_get_instance_private(area);
+    const cairo_matrix_t *map = &data->render_map;
+
+    /* Tiles can be only translated when blitted, so the render map
+     * must be a plain uniform scale followed by a translation */
+    return data->tile_cache && data->canvas != NULL &&
+        map->xy == 0 && map->yx == 0 && map->xx > 0 && map->xx == map->yy;
+}
+
+static AdgTileLevel *
+_adg_get_level(AdgGtkArea *area, gdouble zoom)
+{
+    AdgGtkAreaPrivate *data = adg_gtk_area_get_instance_private(area);
+    AdgTileLevel *level;
+    GSList *node;
+
+    for (node = data->levels; node != NULL; node = node->next) {
+        level = node->data;
+        if (fabs(level->zoom - zoom) <= zoom * _ADG_ZOOM_EPSILON)
+            return level;
+    }
+
+    level = g_new(AdgTileLevel, 1);
+    level->zoom = zoom;
+    level->tiles = g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL,
+                                         (GDestroyNotify) cairo_surface_destroy);
+    data->levels = g_slist_prepend(data->levels, level);
+
+    return level;
+}
+
+static void
+_adg_prune_levels(AdgGtkArea *area, gdouble zoom)
+{
+    AdgGtkAreaPrivate *data = adg_gtk_area_get_instance_private(area);
+    AdgTileLevel *level;
+    GSList *node, *next;
+    gdouble ratio;
+
+    /* Keep only the current zoom level and the next zoom steps */
+    for (node = data->levels; node != NULL; node = next) {
+        next = node->next;
+        level = node->data;
+        ratio = level->zoom / zoom;
+
+        if (fabs(ratio - 1) > _ADG_ZOOM_EPSILON &&
+            fabs(ratio - data->factor) > _ADG_ZOOM_EPSILON &&
+            fabs(ratio * data->factor - 1) > _ADG_ZOOM_EPSILON) {
+            _adg_level_free(level);
+            data->levels = g_slist_delete_link(data->levels, node);
+        }
+    }
+}
+
+static cairo_surface_t *
+_adg_get_tile(AdgGtkArea *area, AdgTileLevel *level, gint x, gint y)
+{
+    AdgGtkAreaPrivate *data = adg_gtk_area_get_instance_private(area);
+    gpointer key = _ADG_TILE_KEY(x, y);
+    cairo_surface_t *tile;
+    cairo_t *cr;
+
+    tile = g_hash_table_lookup(level->tiles, key);
+    if (tile != NULL)
+        return tile;
+
+    tile = cairo_image_surface_create(CAIRO_FORMAT_ARGB32,
+                                      _ADG_TILE_SIZE, _ADG_TILE_SIZE);
+    cr = cairo_create(tile);
+    cairo_translate(cr, -x * _ADG_TILE_SIZE, -y * _ADG_TILE_SIZE);
+    cairo_scale(cr, level->zoom, level->zoom);
+    adg_entity_render((AdgEntity *) data->canvas, cr);
+    cairo_destroy(cr);
+
+    g_hash_table_insert(level->tiles, key, tile);
+    return tile;
+}
+
+static void
+_adg_damage_tiles(AdgGtkArea *area)
+{
+    AdgGtkAreaPrivate *data = adg_gtk_area_get_instance_private(area);
+    const CpmlExtents *damage;
+    guint n, n_damage;
+    AdgTileLevel *level;
+    CpmlExtents extents;
+    GHashTableIter iter;
+    gpointer key;
+    GSList *node;
+
+    damage = adg_canvas_get_damage(data->canvas, &n_damage);
+    if (damage == NULL)
+        return;
+
+    extents.is_defined = 1;
+
+    for (node = data->levels; node != NULL; node = node->next) {
+        level = node->data;
+        g_hash_table_iter_init(&iter, level->tiles);
+
+        while (g_hash_table_iter_next(&iter, &key, NULL)) {
+            /* Tile extents in canvas space, antialiasing included */
+            extents.org.x = (_ADG_TILE_X(key) * _ADG_TILE_SIZE - 1) / level->zoom;
+            extents.org.y = (_ADG_TILE_Y(key) * _ADG_TILE_SIZE - 1) / level->zoom;
+            extents.size.x = (_ADG_TILE_SIZE + 2) / level->zoom;
+            extents.size.y = extents.size.x;
+
+            for (n = 0; n < n_damage; ++n) {
+                if (cpml_extents_is_intersecting(&extents, &damage[n])) {
+                    g_hash_table_iter_remove(&iter);
+                    break;
+                }
+            }
+        }
+    }
+}
+
+static void
+_adg_get_render_map(AdgGtkArea *area, cairo_matrix_t *map)
+{
+    AdgGtkAreaPrivate *data = adg_gtk_area_get_instance_private(area);
+
+    /* Snap the origin to whole pixels, so the tiles are not resampled
+     * and the drawing does not move when the tile cache is switched */
+    *map = data->render_map;
+    map->x0 = floor(map->x0 + 0.5);
+    map->y0 = floor(map->y0 + 0.5);
+}
+
+static void
+_adg_get_damage_area(const CpmlExtents *damage, const cairo_matrix_t *map,
+                     GdkRectangle *area)
+{
+    CpmlExtents extents;
+    gdouble x1, y1, x2, y2;
+
+    cpml_extents_copy(&extents, damage);
+    cpml_extents_transform(&extents, map);
+
+    /* Round outward to whole pixels, antialiasing included */
+    x1 = floor(extents.org.x) - 1;
+    y1 = floor(extents.org.y) - 1;
+    x2 = ceil(extents.org.x + extents.size.x) + 1;
+    y2 = ceil(extents.org.y + extents.size.y) + 1;
+
+    area->x = x1;
+    area->y = y1;
+    area->width = x2 - x1;
+    area->height = y2 - y1;
+}
+
+static void
+_adg_flush_damage(AdgGtkArea *area)
+{
+    AdgGtkAreaPrivate *data = adg_gtk_area_get_instance_private(area);
+    const CpmlExtents *damage;
+    cairo_matrix_t map;
+    GdkRectangle rect;
+    guint n, n_damage;
+
+    _adg_damage_tiles(area);
+    _adg_get_render_map(area, &map);
+    damage = adg_canvas_get_damage(data->canvas, &n_damage);
+
+    for (n = 0; n < n_damage; ++n) {
+        _adg_get_damage_area(&damage[n], &map, &rect);
+        gtk_widget_queue_draw_area((GtkWidget *) area,
+                                   rect.x, rect.y, rect.width, rect.height);
+    }
+
+    /* The damage has been consumed: do not drop the same tiles again */
+    adg_canvas_reset_damage(data->canvas);
+}
+
+static gboolean
+_adg_flush_deferred(gpointer user_data)
+{
+    AdgGtkArea *area = user_data;
+    AdgGtkAreaPrivate *data = adg_gtk_area_get_instance_private(area);
+    GdkRectangle *rect;
+    guint n;
+
+    for (n = 0; n < data->deferred->len; ++n) {
+        rect = &g_array_index(data->deferred, GdkRectangle, n);
+        gtk_widget_queue_draw_area((GtkWidget *) area,
+                                   rect->x, rect->y, rect->width, rect->height);
+    }
+
+    g_array_set_size(data->deferred, 0);
+    data->deferred_id = 0;
+    return FALSE;
+}
+
+static void
+_adg_defer_area(AdgGtkArea *area, gint x, gint y, gint width, gint height)
+{
+    AdgGtkAreaPrivate *data = adg_gtk_area_get_instance_private(area);
+    GdkRectangle rect;
+
+    if (width <= 0 || height <= 0)
+        return;
+
+    rect.x = x;
+    rect.y = y;
+    rect.width = width;
+    rect.height = height;
+    g_array_append_val(data->deferred, rect);
+}
+
+static void
+_adg_defer_damage(AdgGtkArea *area, const GdkRectangle *clip)
+{
+    AdgGtkAreaPrivate *data = adg_gtk_area_get_instance_private(area);
+    const CpmlExtents *damage;
+    cairo_matrix_t map;
+    GdkRectangle rect, inside;
+    guint n, n_damage;
+
+    _adg_damage_tiles(area);
+    _adg_get_render_map(area, &map);
+    damage = adg_canvas_get_damage(data->canvas, &n_damage);
+
+    if (data->deferred == NULL)
+        data->deferred = g_array_new(FALSE, FALSE, sizeof(GdkRectangle));
+
+    for (n = 0; n < n_damage; ++n) {
+        _adg_get_damage_area(&damage[n], &map, &rect);
+
+        if (! gdk_rectangle_intersect(&rect, clip, &inside)) {
+            _adg_defer_area(area, rect.x, rect.y, rect.width, rect.height);
+            continue;
+        }
+
+        /* Defer only the bands of the damaged area outside the
+         * clip: the inside has just been painted */
+        _adg_defer_area(area, rect.x, rect.y,
+                        rect.width, inside.y - rect.y);
+        _adg_defer_area(area, rect.x, inside.y + inside.height,
+                        rect.width, rect.y + rect.height - inside.y - inside.height);
+        _adg_defer_area(area, rect.x, inside.y,
+                        inside.x - rect.x, inside.height);
+        _adg_defer_area(area, inside.x + inside.width, inside.y,
+                        rect.x + rect.width - inside.x - inside.width, inside.height);
+    }
+
+    adg_canvas_reset_damage(data->canvas);
+
+    /* Redrawing from the draw handler would paint twice: the
+     * damaged areas outside the clip are queued when idle */
+    if (data->deferred->len > 0 && data->deferred_id == 0)
+        data->deferred_id = g_idle_add(_adg_flush_deferred, area);
+}
+
+static void
+_adg_outdate_tiles(AdgGtkArea *area)
+{
+    AdgGtkAreaPrivate *data = adg_gtk_area_get_instance_private(area);
+    gint generation = _adg_entity_get_render_generation();
+
+    /* Style changes and adg_switch_extents() do not damage the
+     * canvas, so any of them outdates every tile */
+    if (data->tiles_generation != generation) {
+        _adg_drop_tiles(area);
+        data->tiles_generation = generation;
+    }
+}
+
+static gboolean
+_adg_get_tile_range(gdouble x1, gdouble y1, gdouble x2, gdouble y2,
+                    gint range[4])
+{
+    gdouble tx1 = floor(x1 / _ADG_TILE_SIZE);
+    gdouble ty1 = floor(y1 / _ADG_TILE_SIZE);
+    gdouble tx2 = ceil(x2 / _ADG_TILE_SIZE) - 1;
+    gdouble ty2 = ceil(y2 / _ADG_TILE_SIZE) - 1;
+
+    /* Tile coordinates must fit in the 16 bits of the tile key */
+    if (tx1 < G_MININT16 || ty1 < G_MININT16 ||
+        tx2 > G_MAXINT16 || ty2 > G_MAXINT16)
+        return FALSE;
+
+    range[0] = tx1;
+    range[1] = ty1;
+    range[2] = tx2;
+    range[3] = ty2;
+    return TRUE;
+}
+
+static gboolean
+_adg_get_view_range(AdgGtkArea *area, const cairo_matrix_t *map,
+                    gdouble zoom, gint range[4])
+{
+    AdgGtkAreaPrivate *data = adg_gtk_area_get_instance_private(area);
+    GtkAllocation allocation;
+    gdouble grow, scale, x1, y1, x2, y2;
+
+    gtk_widget_get_allocation((GtkWidget *) area, &allocation);
+
+    /* A zoom step around any point of the widget keeps the new
+     * view inside the current one when zooming in and inside the
+     * current one grown by the factor when zooming out */
+    grow = zoom < map->xx ? data->factor - 1 : 0;
+    scale = zoom / map->xx;
+
+    x1 = -map->x0 - allocation.width * grow;
+    y1 = -map->y0 - allocation.height * grow;
+    x2 = allocation.width - map->x0 + allocation.width * grow;
+    y2 = allocation.height - map->y0 + allocation.height * grow;
+
+    return _adg_get_tile_range(x1 * scale, y1 * scale,
+                               x2 * scale, y2 * scale, range);
+}
+
+static void
+_adg_trim_level(AdgTileLevel *level, const gint range[4])
+{
+    GHashTableIter iter;
+    gpointer key;
+    gint x, y;
+
+    if (g_hash_table_size(level->tiles) <= _ADG_MAX_TILES)
+        return;
+
+    /* Too many tiles: drop the ones outside the range */
+    g_hash_table_iter_init(&iter, level->tiles);
+    while (g_hash_table_iter_next(&iter, &key, NULL)) {
+        x = _ADG_TILE_X(key);
+        y = _ADG_TILE_Y(key);
+        if (x < range[0] || x > range[2] || y < range[1] || y > range[3])
+            g_hash_table_iter_remove(&iter);
+    }
+}
+
+static gboolean
+_adg_prefetch(gpointer user_data)
+{
+    AdgGtkArea *area = user_data;
+    AdgGtkAreaPrivate *data = adg_gtk_area_get_instance_private(area);
+    cairo_matrix_t map;
+    AdgTileLevel *level;
+    gdouble zoom;
+    gint range[4], x, y, n;
+
+    /* Outdated tiles would be dropped by the next redraw anyway */
+    if (! _adg_is_tileable(area) ||
+        data->tiles_generation != _adg_entity_get_render_generation()) {
+        data->prefetch_id = 0;
+        return FALSE;
+    }
+
+    _adg_get_render_map(area, &map);
+
+    for (n = 0; n < 2; ++n) {
+        zoom = n == 0 ? map.xx * data->factor : map.xx / data->factor;
+        if (! _adg_get_view_range(area, &map, zoom, range))
+            continue;
+
+        level = _adg_get_level(area, zoom);
+
+        /* Render only one tile per iteration, to not block the UI */
+        for (y = range[1]; y <= range[3]; ++y) {
+            for (x = range[0]; x <= range[2]; ++x) {
+                if (g_hash_table_lookup(level->tiles, _ADG_TILE_KEY(x, y)) == NULL) {
+                    _adg_get_tile(area, level, x, y);
+                    return TRUE;
+                }
+            }
+        }
+    }
+
+    data->prefetch_id = 0;
+    return FALSE;
+}
+
+static void
+_adg_render(AdgGtkArea *area, cairo_t *cr)
+{
+    AdgGtkAreaPrivate *data = adg_gtk_area_get_instance_private(area);
+    cairo_matrix_t render_map;
+    const cairo_matrix_t *map = &render_map;
+    AdgTileLevel *level, *other;
+    GdkRectangle clip;
+    GSList *node;
+    gdouble x0, y0, x1, y1, x2, y2;
+    gint range[4], view[4], x, y;
+
+    _adg_get_render_map(area, &render_map);
+    x0 = map->x0;
+    y0 = map->y0;
+    cairo_clip_extents(cr, &x1, &y1, &x2, &y2);
+
+    if (! _adg_is_tileable(area) ||
+        ! _adg_get_tile_range(x1 - x0, y1 - y0, x2 - x0, y2 - y0, range)) {
+        cairo_transform(cr, map);
+        adg_entity_render((AdgEntity *) data->canvas, cr);
+        return;
+    }
+
+    /* Arrange the canvas before blitting, so the tiles damaged
+     * in the meantime are dropped and rendered again */
+    clip.x = ceil(x1);
+    clip.y = ceil(y1);
+    clip.width = floor(x2) - clip.x;
+    clip.height = floor(y2) - clip.y;
+    _adg_outdate_tiles(area);
+    adg_entity_arrange((AdgEntity *) data->canvas);
+    _adg_defer_damage(area, &clip);
+
+    _adg_prune_levels(area, map->xx);
+    level = _adg_get_level(area, map->xx);
+
+    /* Cap every level, the prefetched ones included: the current
+     * level keeps the tiles shown, the others the tiles of their
+     * own view as filled by _adg_prefetch() */
+    for (node = data->levels; node != NULL; node = node->next) {
+        other = node->data;
+        if (other == level)
+            _adg_trim_level(level, range);
+        else if (_adg_get_view_range(area, map, other->zoom, view))
+            _adg_trim_level(other, view);
+    }
+
+    for (y = range[1]; y <= range[3]; ++y) {
+        for (x = range[0]; x <= range[2]; ++x) {
+            cairo_set_source_surface(cr, _adg_get_tile(area, level, x, y),
+                                     x0 + x * _ADG_TILE_SIZE,
+                                     y0 + y * _ADG_TILE_SIZE);
+            cairo_rectangle(cr, x0 + x * _ADG_TILE_SIZE, y0 + y * _ADG_TILE_SIZE,
+                            _ADG_TILE_SIZE, _ADG_TILE_SIZE);
+            cairo_fill(cr);
+        }
+    }
+
+    if (data->prefetch_id == 0)
+        data->prefetch_id = g_idle_add(_adg_prefetch, area);
+}
+
 
 static void
 _adg_get_property(GObject *object, guint prop_id,
@@ -166,6 +676,9 @@ _adg_get_property(GObject *object, guint prop_id,
     case PROP_RENDER_MAP:
         g_value_set_boxed(value, &data->render_map);
         break;
+    case PROP_TILE_CACHE:
+        g_value_set_boolean(value, data->tile_cache);
+        break;
     default:
         G_OBJECT_WARN_INVALID_PROPERTY_ID(object, prop_id, pspec);
         break;
@@ -189,6 +702,7 @@ _adg_set_property(GObject *object, guint prop_id,
             if (old_canvas != NULL)
                 g_object_unref(old_canvas);
             data->canvas = new_canvas;
+            _adg_drop_tiles((AdgGtkArea *) object);
             g_signal_emit(object, _adg_signals[CANVAS_CHANGED], 0, old_canvas);
         }
         break;
@@ -201,6 +715,11 @@ _adg_set_property(GObject *object, guint prop_id,
     case PROP_RENDER_MAP:
         adg_matrix_copy(&data->render_map, g_value_get_boxed(value));
         break;
+    case PROP_TILE_CACHE:
+        data->tile_cache = g_value_get_boolean(value);
+        if (! data->tile_cache)
+            _adg_drop_tiles((AdgGtkArea *) object);
+        break;
     default:
         G_OBJECT_WARN_INVALID_PROPERTY_ID(object, prop_id, pspec);
         break;
@@ -213,6 +732,18 @@ _adg_dispose(GObject *object)
 {
     AdgGtkAreaPrivate *data = adg_gtk_area_get_instance_private((AdgGtkArea *) object);
 
+    _adg_drop_tiles((AdgGtkArea *) object);
+
+    if (data->deferred_id != 0) {
+        g_source_remove(data->deferred_id);
+        data->deferred_id = 0;
+    }
+
+    if (data->deferred != NULL) {
+        g_array_free(data->deferred, TRUE);
+        data->deferred = NULL;
+    }
+
     if (data->canvas) {
         g_object_unref(data->canvas);
         data->canvas = NULL;
@@ -321,6 +852,9 @@ _adg_set_map(GtkWidget *widget,
     if (local_space) {
         /* TODO: this forcibly overwrites any local transformation */
         adg_entity_set_local_map(entity, map);
+
+        /* The whole drawing changed: no cached tile is valid anymore */
+        _adg_drop_tiles((AdgGtkArea *) widget);
     } else {
         adg_matrix_transform(&data->render_map, map, ADG_TRANSFORM_BEFORE);
     }
@@ -418,6 +952,22 @@ _adg_motion_notify_event(GtkWidget *widget, GdkEventMotion *event)
     return _ADG_OLD_WIDGET_CLASS->motion_notify_event(widget, event);
 }
 
+static void
+_adg_repainted(GtkWidget *widget, const GdkRectangle *clip)
+{
+    AdgGtkAreaPrivate *data = adg_gtk_area_get_instance_private((AdgGtkArea *) widget);
+    GtkAllocation allocation;
+
+    gtk_widget_get_allocation(widget, &allocation);
+
+    /* When the whole widget has been repainted, every damage is gone */
+    if (clip == NULL ||
+        (clip->x <= 0 && clip->y <= 0 &&
+         clip->x + clip->width >= allocation.width &&
+         clip->y + clip->height >= allocation.height))
+        adg_canvas_reset_damage(data->canvas);
+}
+
 static void
 _adg_canvas_changed(AdgGtkArea *area, AdgCanvas *old_canvas)
 {
@@ -447,9 +997,11 @@ _adg_expose_event(GtkWidget *widget, GdkEventExpose *event)
 
     if (canvas != NULL && event->window != NULL) {
         cairo_t *cr = gdk_cairo_create(event->window);
-        cairo_transform(cr, &data->render_map);
-        adg_entity_render((AdgEntity *) canvas, cr);
+        gdk_cairo_rectangle(cr, &event->area);
+        cairo_clip(cr);
+        _adg_render((AdgGtkArea *) widget, cr);
         cairo_destroy(cr);
+        _adg_repainted(widget, &event->area);
     }
 
     if (_ADG_OLD_WIDGET_CLASS->expose_event == NULL)
@@ -533,8 +1085,11 @@ _adg_draw(GtkWidget *widget, cairo_t *cr)
     AdgCanvas *canvas = data->canvas;
 
     if (canvas != NULL) {
-        cairo_transform(cr, &data->render_map);
-        adg_entity_render((AdgEntity *) canvas, cr);
+        GdkRectangle clip;
+        gboolean clipped = gdk_cairo_get_clip_rectangle(cr, &clip);
+
+        _adg_render((AdgGtkArea *) widget, cr);
+        _adg_repainted(widget, clipped ? &clip : NULL);
     }
 
     return FALSE;
@@ -604,6 +1159,13 @@ adg_gtk_area_class_init(AdgGtkAreaClass *klass)
                                G_PARAM_READWRITE);
     g_object_class_install_property(gobject_class, PROP_RENDER_MAP, param);
 
+    param = g_param_spec_boolean("tile-cache",
+                                 P_("Tile Cache"),
+                                 P_("When enabled, the rendered canvas is retained in tiles that are reused while panning or zooming in global space"),
+                                 FALSE,
+                                 G_PARAM_READWRITE);
+    g_object_class_install_property(gobject_class, PROP_TILE_CACHE, param);
+
     /**
      * AdgGtkArea::canvas-changed:
      * @area: an #AdgGtkArea
@@ -656,9 +1218,15 @@ adg_gtk_area_init(AdgGtkArea *area)
     data->factor = 1.05;
     data->autozoom = FALSE;
     cairo_matrix_init_identity(&data->render_map);
+    data->tile_cache = FALSE;
     data->initialized = FALSE;
     data->x_event = 0;
     data->y_event = 0;
+    data->levels = NULL;
+    data->tiles_generation = 0;
+    data->prefetch_id = 0;
+    data->deferred = NULL;
+    data->deferred_id = 0;
 
     /* Enable GDK events to catch wheel rotation and drag */
     gtk_widget_add_events((GtkWidget *) area,
@@ -863,6 +1431,91 @@ adg_gtk_area_get_extents(AdgGtkArea *area)
     return _adg_get_extents(area);
 }
 
+/**
+ * adg_gtk_area_queue_damage:
+ * @area: an #AdgGtkArea
+ *
+ * Queues the redraw of the areas of the canvas bound to @area
+ * damaged since the last repaint, as returned by
+ * adg_canvas_get_damage(). The expose event will render only the
+ * entities crossing those areas, so this is much faster than
+ * gtk_widget_queue_draw() when only a few entities changed, e.g.
+ * after invalidating a single dimension.
+ *
+ * If the extents of @area changed, the whole widget is queued for
+ * redrawing.
+ *
+ * Since: 1.0
+ **/
+void
+adg_gtk_area_queue_damage(AdgGtkArea *area)
+{
+    AdgGtkAreaPrivate *data;
+    GtkWidget *widget;
+    CpmlExtents old_extents;
+
+    g_return_if_fail(ADG_GTK_IS_AREA(area));
+
+    data = adg_gtk_area_get_instance_private(area);
+    widget = (GtkWidget *) area;
+
+    if (data->canvas == NULL)
+        return;
+
+    /* Arranging the canvas adds the new extents of the
+     * invalidated entities to the damaged areas */
+    old_extents = data->extents;
+    _adg_get_extents(area);
+
+    if (! cpml_extents_equal(&old_extents, &data->extents))
+        gtk_widget_queue_draw(widget);
+
+    _adg_flush_damage(area);
+}
+
+/**
+ * adg_gtk_area_get_entity_at:
+ * @area: an #AdgGtkArea
+ * @x: x coordinate, in widget space
+ * @y: y coordinate, in widget space
+ *
+ * Gets the topmost entity of the canvas bound to @area whose extents
+ * contain the (@x, @y) point, descending into nested containers. This
+ * can be used to implement hit-testing, e.g. by calling it from the
+ * handler of a mouse event.
+ *
+ * The lookup is performed on the extents computed when the canvas
+ * has been arranged the last time, typically during the last redraw,
+ * so its cost does not depend on the number of entities.
+ *
+ * Returns: (transfer none): the entity under (@x, @y) or <constant>NULL</constant> if not found or on errors.
+ *
+ * Since: 1.0
+ **/
+AdgEntity *
+adg_gtk_area_get_entity_at(AdgGtkArea *area, gdouble x, gdouble y)
+{
+    AdgGtkAreaPrivate *data;
+    cairo_matrix_t inverted;
+    CpmlPair pair;
+
+    g_return_val_if_fail(ADG_GTK_IS_AREA(area), NULL);
+
+    data = adg_gtk_area_get_instance_private(area);
+    if (data->canvas == NULL)
+        return NULL;
+
+    adg_matrix_copy(&inverted, &data->render_map);
+    if (cairo_matrix_invert(&inverted) != CAIRO_STATUS_SUCCESS)
+        return NULL;
+
+    pair.x = x;
+    pair.y = y;
+    cpml_pair_transform(&pair, &inverted);
+
+    return _adg_entity_at((AdgContainer *) data->canvas, &pair);
+}
+
 /**
  * adg_gtk_area_get_zoom:
  * @area: an #AdgGtkArea
@@ -969,6 +1622,49 @@ adg_gtk_area_has_autozoom(AdgGtkArea *area)
     return data->autozoom;
 }
 
+/**
+ * adg_gtk_area_switch_tile_cache:
+ * @area: an #AdgGtkArea
+ * @state: the new tile cache state
+ *
+ * Sets the #AdgGtkArea:tile-cache property of @area to @state. When
+ * the tile cache is enabled, the rendered canvas is retained in
+ * fixed size tiles, so panning and zooming in global space blit the
+ * cached tiles instead of rendering the whole canvas again.
+ *
+ * Disabling the tile cache frees all the retained tiles.
+ *
+ * Since: 1.0
+ **/
+void
+adg_gtk_area_switch_tile_cache(AdgGtkArea *area, gboolean state)
+{
+    g_return_if_fail(ADG_GTK_IS_AREA(area));
+    g_object_set(area, "tile-cache", state, NULL);
+}
+
+/**
+ * adg_gtk_area_has_tile_cache:
+ * @area: an #AdgGtkArea
+ *
+ * Gets the current state of the #AdgGtkArea:tile-cache property on
+ * the @area object.
+ *
+ * Returns: the current tile cache state
+ *
+ * Since: 1.0
+ **/
+gboolean
+adg_gtk_area_has_tile_cache(AdgGtkArea *area)
+{
+    AdgGtkAreaPrivate *data;
+
+    g_return_val_if_fail(ADG_GTK_IS_AREA(area), FALSE);
+
+    data = adg_gtk_area_get_instance_private(area);
+    return data->tile_cache;
+}
+
 /**
  * adg_gtk_area_reset:
  * @area: an #AdgGtkArea
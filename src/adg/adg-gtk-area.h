@@ -67,6 +67,10 @@ void            adg_gtk_area_set_canvas         (AdgGtkArea      *area,
 AdgCanvas *     adg_gtk_area_get_canvas         (AdgGtkArea      *area);
 const CpmlExtents *
                 adg_gtk_area_get_extents        (AdgGtkArea      *area);
+void            adg_gtk_area_queue_damage       (AdgGtkArea      *area);
+AdgEntity *     adg_gtk_area_get_entity_at      (AdgGtkArea      *area,
+                                                 gdouble          x,
+                                                 gdouble          y);
 gdouble         adg_gtk_area_get_zoom           (AdgGtkArea      *area);
 void            adg_gtk_area_set_factor         (AdgGtkArea      *area,
                                                  gdouble          factor);
@@ -74,6 +78,9 @@ gdouble         adg_gtk_area_get_factor         (AdgGtkArea      *area);
 void            adg_gtk_area_switch_autozoom    (AdgGtkArea      *area,
                                                  gboolean         state);
 gboolean        adg_gtk_area_has_autozoom       (AdgGtkArea      *area);
+void            adg_gtk_area_switch_tile_cache  (AdgGtkArea      *area,
+                                                 gboolean         state);
+gboolean        adg_gtk_area_has_tile_cache     (AdgGtkArea      *area);
 void            adg_gtk_area_reset              (AdgGtkArea      *area);
 void            adg_gtk_area_canvas_changed     (AdgGtkArea      *area,
                                                  AdgCanvas       *old_canvas);
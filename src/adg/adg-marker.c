@@ -62,7 +62,9 @@
  * The @create_model method must be implemented by any #AdgMarker derived
  * classes. The derived classes are expected to apply a single model
  * (the one returned by this method) to every path endings by using
- * different transformations.
+ * different transformations. The returned model is owned by the
+ * caller, so implementations sharing the same model between different
+ * markers must add a new reference to it.
  *
  * Since: 1.0
  **/
@@ -635,9 +637,14 @@ adg_marker_model(AdgMarker *marker)
     if (data->model == NULL) {
         /* Model not found: regenerate it */
         AdgMarkerClass *marker_class = ADG_MARKER_GET_CLASS(marker);
+        AdgModel *model;
 
-        if (marker_class->create_model)
-            adg_marker_set_model(marker, marker_class->create_model(marker));
+        if (marker_class->create_model) {
+            model = marker_class->create_model(marker);
+            adg_marker_set_model(marker, model);
+            if (model != NULL)
+                g_object_unref(model);
+        }
     }
 
     return data->model;
@@ -48,14 +48,10 @@
 const cairo_matrix_t *
 adg_matrix_identity(void)
 {
-    static cairo_matrix_t *identity_matrix = NULL;
+    /* Statically initialized, so no thread can see it half built */
+    static const cairo_matrix_t identity_matrix = { 1, 0, 0, 1, 0, 0 };
 
-    if (G_UNLIKELY(identity_matrix == NULL)) {
-        identity_matrix = g_new(cairo_matrix_t, 1);
-        cairo_matrix_init_identity(identity_matrix);
-    }
-
-    return identity_matrix;
+    return &identity_matrix;
 }
 
 /**
@@ -71,12 +67,9 @@ adg_matrix_identity(void)
 const cairo_matrix_t *
 adg_matrix_null(void)
 {
-    static cairo_matrix_t *null_matrix = NULL;
-
-    if (G_UNLIKELY(null_matrix == NULL))
-        null_matrix = g_new0(cairo_matrix_t, 1);
+    static const cairo_matrix_t null_matrix = { 0, 0, 0, 0, 0, 0 };
 
-    return null_matrix;
+    return &null_matrix;
 }
 
 /**
@@ -25,19 +25,62 @@
 G_BEGIN_DECLS
 
 typedef struct _AdgModelPrivate  AdgModelPrivate;
-typedef struct _AdgWrapperHelper AdgWrapperHelper;
+typedef struct _AdgDependencySet AdgDependencySet;
+typedef struct _AdgPairSlot      AdgPairSlot;
+typedef struct _AdgModelUpdate   AdgModelUpdate;
+typedef struct _AdgPairDependency AdgPairDependency;
+
+/* A set of dependent entities. An entity added more than once is
+ * stored once, together with the number of additions still to be
+ * removed. The list is built on demand for the public getters and
+ * dropped whenever the set changes. */
+struct _AdgDependencySet {
+    GHashTable *entities;
+    GSList     *list;
+};
 
 struct _AdgModelPrivate {
-    GSList     *dependencies;
-    GHashTable *named_pairs;
+    AdgDependencySet dependencies;
+    GHashTable *pair_dependencies;
+    GPtrArray  *slots;
+    GHashTable *slot_index;
+    gint        updates;
+    gboolean    pending;
+};
+
+/* A named pair. Slots are never removed before the model is
+ * finalized (undefining a pair only clears is_defined), so their
+ * indexes are stable handles for AdgPoint. version is bumped
+ * whenever the pair is modified, defined or undefined. */
+struct _AdgPairSlot {
+    GQuark      name;
+    guint       version;
+    gboolean    is_defined;
+    CpmlPair    pair;
 };
 
-struct _AdgWrapperHelper {
-    AdgNamedPairFunc callback;
-    AdgModel        *model;
-    gpointer         user_data;
+/* The entities depending on a single named pair, together with
+ * the value the pair had on the last AdgModel::changed emission */
+struct _AdgPairDependency {
+    AdgDependencySet entities;
+    gboolean    is_defined;
+    CpmlPair    pair;
 };
 
+struct _AdgModelUpdate {
+    gint        depth;
+    GPtrArray  *pending;
+    GPtrArray  *entities;
+    GHashTable *seen;
+};
+
+
+gint            _adg_model_get_slot     (AdgModel       *model,
+                                         GQuark          name);
+const CpmlPair *_adg_model_slot_pair    (AdgModel       *model,
+                                         gint            slot,
+                                         guint          *version);
+
 G_END_DECLS
 
 
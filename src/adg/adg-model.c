@@ -41,6 +41,19 @@
  * coordinates stored in #CpmlPair) by accessing them using a string. To easily
  * the access of named pairs from the view, use #AdgPoint instead of #CpmlPair.
  *
+ * An entity can also depend on a single named pair of a model with
+ * adg_model_add_pair_dependency(): in this case #AdgModel::changed
+ * invalidates the entity only if that named pair has been modified
+ * since the previous #AdgModel::changed emission. This is what
+ * adg_entity_point() does for the points bound to a named pair, so
+ * changing a few named pairs does not rebuild every dimension.
+ *
+ * When many models are redefined at once, wrap the whole edit between
+ * adg_model_begin_update() and adg_model_end_update(): the
+ * #AdgModel::changed signals are deferred up to the end of the outermost
+ * update and every dependent entity is invalidated only once, even if it
+ * depends on more than one changed model.
+ *
  * Since: 1.0
  **/
 
@@ -66,23 +79,30 @@
  *
  *
  * The default @named_pair implementation looks up the #CpmlPair in an internal
- * #GHashTable that uses the pair name as key and the #CpmlPair struct as value.
+ * table indexed by the #GQuark of the pair name. A pair, once defined, keeps
+ * its place in the table for the whole life of the model, so #AdgPoint can
+ * resolve it with a direct index instead of a lookup by name.
  *
  * The default @set_named_pair implementation can be used for either adding
  * (if the #CpmlPair is not <constant>NULL</constant>) or removing (if #CpmlPair
- * is <constant>NULL</constant>) an item from the named pairs hash table.
+ * is <constant>NULL</constant>) a named pair. Removing a pair only marks it
+ * as undefined: its place in the table is kept.
  *
  * The default handler for @clear signals does not do anything.
  *
  * The default @reset involves the clearing of the internal cache data
- * (done by emitting the #AdgModel::clear signal) and the destruction of the
- * internal named pair hash table.
+ * (done by emitting the #AdgModel::clear signal) and the undefinition of
+ * every named pair. The #AdgPoint structs bound to those pairs stay valid
+ * and pick up the new values as soon as the pairs are defined again.
  *
- * The default @add_dependency and @remove_dependency implementations add and
- * remove items from an internal #GSList of #AdgEntity.
+ * The default @add_dependency and @remove_dependency implementations keep
+ * an internal set of #AdgEntity that counts the additions of every entity:
+ * an entity added more than once is stored once and it is removed only
+ * when all its additions have been removed.
  *
  * The default handler of the @changed signal calls adg_entity_invalidate()
- * on every dependency by using adg_model_foreach_dependency().
+ * on every dependency by using adg_model_foreach_dependency() and on the
+ * dependencies of the named pairs modified since the last emission.
  *
  * Since: 1.0
  **/
@@ -139,6 +159,7 @@ enum {
 
 
 static void             _adg_dispose            (GObject        *object);
+static void             _adg_finalize           (GObject        *object);
 static void             _adg_set_property       (GObject        *object,
                                                  guint           prop_id,
                                                  const GValue   *value,
@@ -154,13 +175,43 @@ static void             _adg_set_named_pair     (AdgModel       *model,
                                                  const gchar    *name,
                                                  const CpmlPair *pair);
 static void             _adg_changed            (AdgModel       *model);
-static void             _adg_named_pair_wrapper (gpointer        key,
-                                                 gpointer        value,
-                                                 gpointer        user_data);
-static void             _adg_invalidate_wrapper (AdgModel       *model,
+static AdgPairSlot *    _adg_lookup_slot        (AdgModel       *model,
+                                                 GQuark          name);
+static void             _adg_collect_wrapper    (AdgModel       *model,
                                                  AdgEntity      *entity,
                                                  gpointer        user_data);
+static void             _adg_collect            (AdgModel       *model,
+                                                 AdgModelUpdate *update);
+static void             _adg_invalidate_collected
+                                                (AdgModelUpdate *update);
+static gboolean         _adg_pair_dependency_sync
+                                                (AdgModel       *model,
+                                                 const gchar    *name,
+                                                 AdgPairDependency
+                                                                *dependency);
+static void             _adg_update_flush       (AdgModelUpdate *update);
+static void             _adg_update_free        (gpointer        user_data);
+static void             _adg_dependency_set_init(AdgDependencySet
+                                                                *set);
+static void             _adg_dependency_set_finalize
+                                                (AdgDependencySet
+                                                                *set);
+static void             _adg_dependency_set_add (AdgDependencySet
+                                                                *set,
+                                                 AdgEntity      *entity);
+static gboolean         _adg_dependency_set_remove
+                                                (AdgDependencySet
+                                                                *set,
+                                                 AdgEntity      *entity,
+                                                 gboolean       *dropped);
+static AdgEntity *      _adg_dependency_set_any (AdgDependencySet
+                                                                *set);
+static const GSList *   _adg_dependency_set_list(AdgDependencySet
+                                                                *set);
+static void             _adg_pair_dependency_free
+                                                (gpointer        user_data);
 static guint            _adg_signals[LAST_SIGNAL] = { 0 };
+static GPrivate         _adg_update = G_PRIVATE_INIT(_adg_update_free);
 
 
 static void
@@ -172,6 +223,7 @@ adg_model_class_init(AdgModelClass *klass)
     gobject_class = (GObjectClass *) klass;
 
     gobject_class->dispose = _adg_dispose;
+    gobject_class->finalize = _adg_finalize;
     gobject_class->set_property = _adg_set_property;
 
     klass->add_dependency = _adg_add_dependency;
@@ -253,7 +305,8 @@ adg_model_class_init(AdgModelClass *klass)
                      NULL, NULL,
                      adg_marshal_VOID__STRING_POINTER,
                      G_TYPE_NONE, 2,
-                     G_TYPE_STRING, G_TYPE_POINTER);
+                     G_TYPE_STRING | G_SIGNAL_TYPE_STATIC_SCOPE,
+                     G_TYPE_POINTER);
 
     /**
      * AdgModel::clear:
@@ -328,7 +381,12 @@ static void
 adg_model_init(AdgModel *model)
 {
     AdgModelPrivate *data = adg_model_get_instance_private(model);
-    data->dependencies = NULL;
+    _adg_dependency_set_init(&data->dependencies);
+    data->pair_dependencies = NULL;
+    data->slots = g_ptr_array_new_with_free_func(g_free);
+    data->slot_index = g_hash_table_new(NULL, NULL);
+    data->updates = 0;
+    data->pending = FALSE;
 }
 
 static void
@@ -344,9 +402,24 @@ _adg_dispose(GObject *object)
         /* Remove all the dependencies: this will emit a
          * "remove-dependency" signal for every dependency, dropping
          * all references from entities to this model */
-        while (data->dependencies != NULL) {
-            entity = (AdgEntity *) data->dependencies->data;
+        while ((entity = _adg_dependency_set_any(&data->dependencies)) != NULL)
             adg_model_remove_dependency(model, entity);
+
+        /* The table is destroyed when its last dependency is removed */
+        while (data->pair_dependencies != NULL) {
+            AdgPairDependency *dependency;
+            GHashTableIter iter;
+            gpointer key, value;
+
+            g_hash_table_iter_init(&iter, data->pair_dependencies);
+            if (! g_hash_table_iter_next(&iter, &key, &value))
+                break;
+
+            dependency = value;
+            entity = _adg_dependency_set_any(&dependency->entities);
+            adg_model_remove_pair_dependency(model,
+                                             g_quark_to_string(GPOINTER_TO_UINT(key)),
+                                             entity);
         }
 
         g_signal_emit(model, _adg_signals[RESET], 0);
@@ -356,6 +429,19 @@ _adg_dispose(GObject *object)
         _ADG_OLD_OBJECT_CLASS->dispose(object);
 }
 
+static void
+_adg_finalize(GObject *object)
+{
+    AdgModelPrivate *data = adg_model_get_instance_private((AdgModel *) object);
+
+    _adg_dependency_set_finalize(&data->dependencies);
+    g_ptr_array_free(data->slots, TRUE);
+    g_hash_table_destroy(data->slot_index);
+
+    if (_ADG_OLD_OBJECT_CLASS->finalize)
+        _ADG_OLD_OBJECT_CLASS->finalize(object);
+}
+
 static void
 _adg_set_property(GObject *object, guint prop_id,
                   const GValue *value, GParamSpec *pspec)
@@ -383,6 +469,11 @@ _adg_set_property(GObject *object, guint prop_id,
  * Emits a #AdgModel::add-dependency signal on @model passing @entity
  * as argument. This will add a reference to @entity owned by @model.
  *
+ * Adding the same @entity more than once is allowed: the default
+ * handler keeps a single dependency and counts the additions, so
+ * @entity is dropped only by the matching number of
+ * adg_model_remove_dependency() calls.
+ *
  * Since: 1.0
  **/
 void
@@ -424,8 +515,14 @@ adg_model_remove_dependency(AdgModel *model, AdgEntity *entity)
  * adg_model_get_dependencies:
  * @model: an #AdgModel
  *
- * Gets the list of entities dependending on @model. This list
- * is owned by @model and must not be modified or freed.
+ * Gets the list of entities dependending on @model. Every entity
+ * is listed once, regardless of how many times it has been added,
+ * in no particular order (the order can differ from the one of the
+ * additions and can change between calls).
+ *
+ * This list is owned by @model and must not be modified or freed.
+ * It is valid only up to the next addition or removal of a
+ * dependency on @model: copy it if you need to keep it around.
  *
  * Returns: (transfer none) (element-type Adg.Entity): a #GSList of dependencies or <constant>NULL</constant> on error.
  *
@@ -439,7 +536,155 @@ adg_model_get_dependencies(AdgModel *model)
     g_return_val_if_fail(ADG_IS_MODEL(model), NULL);
 
     data = adg_model_get_instance_private(model);
-    return data->dependencies;
+    return _adg_dependency_set_list(&data->dependencies);
+}
+
+/**
+ * adg_model_add_pair_dependency:
+ * @model: an #AdgModel
+ * @name: the name of a named pair of @model
+ * @entity: an #AdgEntity
+ *
+ * <note><para>
+ * This function is only useful in entity implementations.
+ * </para></note>
+ *
+ * Makes @entity dependent on the @name named pair of @model. Unlike
+ * adg_model_add_dependency(), @entity will be invalidated by
+ * #AdgModel::changed only when the value of @name differs from the
+ * one it had on the previous emission (or when @name has been
+ * defined or undefined in the meantime).
+ *
+ * The same entity can be added more than once: it must then be
+ * removed the same number of times. Whatever the number of
+ * additions, @model owns a single reference to @entity for
+ * every named pair @entity depends on.
+ *
+ * Since: 1.0
+ **/
+void
+adg_model_add_pair_dependency(AdgModel *model, const gchar *name,
+                              AdgEntity *entity)
+{
+    AdgModelPrivate *data;
+    AdgPairDependency *dependency;
+    gpointer key;
+
+    g_return_if_fail(ADG_IS_MODEL(model));
+    g_return_if_fail(name != NULL);
+    g_return_if_fail(ADG_IS_ENTITY(entity));
+
+    data = adg_model_get_instance_private(model);
+    key = GUINT_TO_POINTER(g_quark_from_string(name));
+
+    if (data->pair_dependencies == NULL)
+        data->pair_dependencies = g_hash_table_new_full(NULL, NULL, NULL,
+                                                        _adg_pair_dependency_free);
+
+    dependency = g_hash_table_lookup(data->pair_dependencies, key);
+    if (dependency == NULL) {
+        dependency = g_new(AdgPairDependency, 1);
+        _adg_dependency_set_init(&dependency->entities);
+        _adg_pair_dependency_sync(model, name, dependency);
+        g_hash_table_insert(data->pair_dependencies, key, dependency);
+    }
+
+    _adg_dependency_set_add(&dependency->entities, entity);
+}
+
+/**
+ * adg_model_remove_pair_dependency:
+ * @model: an #AdgModel
+ * @name: the name of a named pair of @model
+ * @entity: an #AdgEntity
+ *
+ * <note><para>
+ * This function is only useful in entity implementations.
+ * </para></note>
+ *
+ * Removes a dependency added by adg_model_add_pair_dependency().
+ * As for adg_model_remove_dependency(), the reference released
+ * by @model could be the last one, destroying @entity.
+ *
+ * Since: 1.0
+ **/
+void
+adg_model_remove_pair_dependency(AdgModel *model, const gchar *name,
+                                 AdgEntity *entity)
+{
+    AdgModelPrivate *data;
+    AdgPairDependency *dependency;
+    gpointer key;
+    gboolean dropped;
+
+    g_return_if_fail(ADG_IS_MODEL(model));
+    g_return_if_fail(name != NULL);
+    g_return_if_fail(ADG_IS_ENTITY(entity));
+
+    data = adg_model_get_instance_private(model);
+    key = GUINT_TO_POINTER(g_quark_try_string(name));
+    dependency = data->pair_dependencies != NULL ?
+        g_hash_table_lookup(data->pair_dependencies, key) : NULL;
+
+    if (dependency == NULL ||
+        ! _adg_dependency_set_remove(&dependency->entities, entity, &dropped)) {
+        g_warning(_("%s: attempting to remove the nonexistent dependency "
+                    "on the entity with type %s from the '%s' named pair "
+                    "of a model of type %s"),
+                  G_STRLOC, g_type_name(G_OBJECT_TYPE(entity)), name,
+                  g_type_name(G_OBJECT_TYPE(model)));
+        return;
+    }
+
+    if (! dropped)
+        return;
+
+    /* The bookkeeping must be consistent before releasing entity,
+     * as its disposal could remove other dependencies */
+    if (g_hash_table_size(dependency->entities.entities) == 0) {
+        g_hash_table_remove(data->pair_dependencies, key);
+        if (g_hash_table_size(data->pair_dependencies) == 0) {
+            g_hash_table_destroy(data->pair_dependencies);
+            data->pair_dependencies = NULL;
+        }
+    }
+
+    g_object_unref(entity);
+}
+
+/**
+ * adg_model_get_pair_dependencies:
+ * @model: an #AdgModel
+ * @name: the name of a named pair of @model
+ *
+ * Gets the list of entities dependending on the @name named pair
+ * of @model. Every entity is listed once, regardless of how many
+ * times it has been added, in no particular order.
+ *
+ * This list is owned by @model and must not be modified or freed.
+ * It is valid only up to the next addition or removal of a
+ * dependency on @name: copy it if you need to keep it around.
+ *
+ * Returns: (transfer none) (element-type Adg.Entity): a #GSList of dependencies or <constant>NULL</constant> on no dependencies or on errors.
+ *
+ * Since: 1.0
+ **/
+const GSList *
+adg_model_get_pair_dependencies(AdgModel *model, const gchar *name)
+{
+    AdgModelPrivate *data;
+    AdgPairDependency *dependency;
+
+    g_return_val_if_fail(ADG_IS_MODEL(model), NULL);
+    g_return_val_if_fail(name != NULL, NULL);
+
+    data = adg_model_get_instance_private(model);
+    if (data->pair_dependencies == NULL)
+        return NULL;
+
+    dependency = g_hash_table_lookup(data->pair_dependencies,
+                                     GUINT_TO_POINTER(g_quark_try_string(name)));
+    return dependency != NULL ? _adg_dependency_set_list(&dependency->entities) : NULL;
 }
 
 /**
@@ -448,7 +693,10 @@ adg_model_get_dependencies(AdgModel *model)
  * @callback: (scope call): the entity callback
  * @user_data: general purpose user data passed "as is" to @callback
  *
- * Invokes @callback on each entity linked to @model.
+ * Invokes @callback on each entity linked to @model. Every entity
+ * is visited once, regardless of how many times it has been added,
+ * in no particular order.
+ * @callback must not add or remove dependencies on @model.
  *
  * Since: 1.0
  **/
@@ -457,22 +705,18 @@ adg_model_foreach_dependency(AdgModel *model, AdgDependencyFunc callback,
                              gpointer user_data)
 {
     AdgModelPrivate *data;
-    GSList *dependency;
-    AdgEntity *entity;
+    GHashTableIter iter;
+    gpointer entity;
 
     g_return_if_fail(ADG_IS_MODEL(model));
     g_return_if_fail(callback != NULL);
 
     data = adg_model_get_instance_private(model);
-    dependency = data->dependencies;
 
-    while (dependency) {
-        entity = dependency->data;
-
-        if (entity != NULL && ADG_IS_ENTITY(entity))
+    g_hash_table_iter_init(&iter, data->dependencies.entities);
+    while (g_hash_table_iter_next(&iter, &entity, NULL)) {
+        if (ADG_IS_ENTITY(entity))
             callback(model, entity, user_data);
-
-        dependency = dependency->next;
     }
 }
 
@@ -567,9 +811,11 @@ adg_model_get_named_pair(AdgModel *model, const gchar *name)
  * @callback: (scope call): the named pair callback
  * @user_data: general purpose user data passed "as is" to @callback
  *
- * Invokes @callback for each named pair set on @model. This can
- * be used, for example, to retrieve all the named pairs of a @model
- * or to duplicate a transformed version of every named pair.
+ * Invokes @callback for each named pair set on @model, in the order
+ * they have been defined the first time. This can be used, for example,
+ * to retrieve all the named pairs of a @model or to duplicate a
+ * transformed version of every named pair. The name passed to
+ * @callback is an interned string, valid for the life of the program.
  *
  * Since: 1.0
  **/
@@ -578,21 +824,22 @@ adg_model_foreach_named_pair(AdgModel *model, AdgNamedPairFunc callback,
                              gpointer user_data)
 {
     AdgModelPrivate *data;
-    AdgWrapperHelper helper;
+    AdgPairSlot *slot;
+    guint n, len;
 
     g_return_if_fail(ADG_IS_MODEL(model));
     g_return_if_fail(callback != NULL);
 
     data = adg_model_get_instance_private(model);
 
-    if (data->named_pairs == NULL)
-        return;
-
-    helper.callback = callback;
-    helper.model = model;
-    helper.user_data = user_data;
-
-    g_hash_table_foreach(data->named_pairs, _adg_named_pair_wrapper, &helper);
+    /* The pairs added by callback, if any, are not visited */
+    len = data->slots->len;
+    for (n = 0; n < len; ++n) {
+        slot = g_ptr_array_index(data->slots, n);
+        if (slot->is_defined)
+            callback(model, g_quark_to_string(slot->name),
+                     &slot->pair, user_data);
+    }
 }
 
 /**
@@ -646,11 +893,165 @@ adg_model_reset(AdgModel *model)
 void
 adg_model_changed(AdgModel *model)
 {
+    AdgModelPrivate *data;
+
     g_return_if_fail(ADG_IS_MODEL(model));
 
+    data = adg_model_get_instance_private(model);
+
+    /* Inside an update, the emission is deferred to its end */
+    if (data->updates > 0) {
+        AdgModelUpdate *update = g_private_get(&_adg_update);
+
+        if (update != NULL) {
+            if (! data->pending) {
+                data->pending = TRUE;
+                g_ptr_array_add(update->pending, g_object_ref(model));
+            }
+            return;
+        }
+    }
+
     g_signal_emit(model, _adg_signals[CHANGED], 0);
 }
 
+/**
+ * adg_model_begin_update:
+ * @model: an #AdgModel
+ *
+ * Starts an update of @model. Until the matching adg_model_end_update()
+ * any adg_model_changed() call on @model is only recorded: the
+ * #AdgModel::changed signal will be emitted once at the end of the
+ * outermost update of the calling thread.
+ *
+ * Updates can be nested and can span different models, e.g.:
+ *
+ * <informalexample><programlisting language="C">
+ * adg_model_begin_update(body);
+ * adg_model_begin_update(hole);
+ * adg_model_reset(body);
+ * adg_model_reset(hole);
+ * // Redefinition of body and hole
+ * ...
+ * adg_model_changed(body);
+ * adg_model_changed(hole);
+ * adg_model_end_update(hole);
+ * adg_model_end_update(body);
+ * </programlisting></informalexample>
+ *
+ * When the outermost update ends, the deferred signals are emitted
+ * and the dependencies of all the changed models are invalidated
+ * together, so an entity depending on both body and hole is
+ * invalidated (and later arranged) only once.
+ *
+ * Since: 1.0
+ **/
+void
+adg_model_begin_update(AdgModel *model)
+{
+    AdgModelPrivate *data;
+    AdgModelUpdate *update;
+
+    g_return_if_fail(ADG_IS_MODEL(model));
+
+    data = adg_model_get_instance_private(model);
+    update = g_private_get(&_adg_update);
+
+    if (update == NULL) {
+        update = g_new(AdgModelUpdate, 1);
+        update->depth = 0;
+        update->pending = g_ptr_array_new();
+        update->entities = NULL;
+        update->seen = NULL;
+        g_private_set(&_adg_update, update);
+    }
+
+    ++data->updates;
+    ++update->depth;
+}
+
+/**
+ * adg_model_end_update:
+ * @model: an #AdgModel
+ *
+ * Ends an update of @model started with adg_model_begin_update().
+ * When this is the end of the outermost update, the changed models
+ * are notified and their dependencies are invalidated once.
+ *
+ * Since: 1.0
+ **/
+void
+adg_model_end_update(AdgModel *model)
+{
+    AdgModelPrivate *data;
+    AdgModelUpdate *update;
+
+    g_return_if_fail(ADG_IS_MODEL(model));
+
+    data = adg_model_get_instance_private(model);
+    update = g_private_get(&_adg_update);
+
+    if (data->updates <= 0 || update == NULL || update->depth <= 0) {
+        g_warning(_("%s: ending an update never started on a model of type %s"),
+                  G_STRLOC, g_type_name(G_OBJECT_TYPE(model)));
+        return;
+    }
+
+    --data->updates;
+    if (--update->depth == 0)
+        _adg_update_flush(update);
+}
+
+
+/* Gets the index of the @name slot, creating an undefined one when
+ * needed. The index is a stable handle to the named pair. */
+gint
+_adg_model_get_slot(AdgModel *model, GQuark name)
+{
+    AdgModelPrivate *data = adg_model_get_instance_private(model);
+    AdgPairSlot *slot;
+    guint index;
+
+    index = GPOINTER_TO_UINT(g_hash_table_lookup(data->slot_index,
+                                                 GUINT_TO_POINTER(name)));
+    if (index > 0)
+        return index - 1;
+
+    slot = g_new(AdgPairSlot, 1);
+    slot->name = name;
+    slot->version = 0;
+    slot->is_defined = FALSE;
+    slot->pair.x = 0;
+    slot->pair.y = 0;
+
+    g_ptr_array_add(data->slots, slot);
+    g_hash_table_insert(data->slot_index, GUINT_TO_POINTER(name),
+                        GUINT_TO_POINTER(data->slots->len));
+
+    return data->slots->len - 1;
+}
+
+/* Resolves the pair of a slot returned by _adg_model_get_slot(),
+ * storing in @version the current version of the pair. A version
+ * of 0 means the pair is provided by a custom named_pair() method
+ * and it must be resolved again on every access. */
+const CpmlPair *
+_adg_model_slot_pair(AdgModel *model, gint slot, guint *version)
+{
+    AdgModelPrivate *data = adg_model_get_instance_private(model);
+    AdgModelClass *klass = ADG_MODEL_GET_CLASS(model);
+    AdgPairSlot *pair_slot = g_ptr_array_index(data->slots, slot);
+
+    if (klass->named_pair != _adg_named_pair) {
+        *version = 0;
+        if (klass->named_pair == NULL)
+            return NULL;
+        return klass->named_pair(model, g_quark_to_string(pair_slot->name));
+    }
+
+    *version = pair_slot->version;
+    return pair_slot->is_defined ? &pair_slot->pair : NULL;
+}
 
 static void
 _adg_add_dependency(AdgModel *model, AdgEntity *entity)
@@ -662,20 +1063,16 @@ _adg_add_dependency(AdgModel *model, AdgEntity *entity)
         return;
 
     data = adg_model_get_instance_private(model);
-
-    /* The prepend operation is more efficient */
-    data->dependencies = g_slist_prepend(data->dependencies, entity);
-
-    g_object_ref(entity);
+    _adg_dependency_set_add(&data->dependencies, entity);
 }
 
 static void
 _adg_remove_dependency(AdgModel *model, AdgEntity *entity)
 {
     AdgModelPrivate *data = adg_model_get_instance_private(model);
-    GSList *node = g_slist_find(data->dependencies, entity);
+    gboolean dropped;
 
-    if (node == NULL) {
+    if (! _adg_dependency_set_remove(&data->dependencies, entity, &dropped)) {
         g_warning(_("%s: attempting to remove the nonexistent dependency "
                     "on the entity with type %s from a model of type %s"),
                   G_STRLOC,
@@ -684,84 +1081,310 @@ _adg_remove_dependency(AdgModel *model, AdgEntity *entity)
         return;
     }
 
-    data->dependencies = g_slist_delete_link(data->dependencies, node);
-    g_object_unref(entity);
+    if (dropped)
+        g_object_unref(entity);
 }
 
 static void
 _adg_reset(AdgModel *model)
 {
     AdgModelPrivate *data = adg_model_get_instance_private(model);
+    AdgPairSlot *slot;
+    guint n;
 
     adg_model_clear(model);
 
-    if (data->named_pairs) {
-        g_hash_table_destroy(data->named_pairs);
-        data->named_pairs = NULL;
+    /* Undefine the pairs but keep their slots, so the
+     * handles held by the points survive the reset */
+    for (n = 0; n < data->slots->len; ++n) {
+        slot = g_ptr_array_index(data->slots, n);
+        if (slot->is_defined) {
+            slot->is_defined = FALSE;
+            ++slot->version;
+        }
     }
 }
 
 static void
 _adg_set_named_pair(AdgModel *model, const gchar *name, const CpmlPair *pair)
 {
-    AdgModelPrivate *data = adg_model_get_instance_private(model);
-    GHashTable **hash = &data->named_pairs;
-    gchar *key;
-    CpmlPair *value;
+    AdgModelPrivate *data;
+    AdgPairSlot *slot;
 
     if (pair == NULL) {
         /* Delete mode: raise a warning if @name is not found */
-        if (*hash == NULL || !g_hash_table_remove(*hash, name))
+        slot = _adg_lookup_slot(model, g_quark_try_string(name));
+        if (slot == NULL || ! slot->is_defined) {
             g_warning(_("%s: attempting to remove nonexistent '%s' named pair"),
                       G_STRLOC, name);
+            return;
+        }
 
+        slot->is_defined = FALSE;
+        ++slot->version;
         return;
     }
 
     /* Insert or update mode */
-    key = g_strdup(name);
-    value = cpml_pair_dup(pair);
-
-    if (*hash == NULL)
-        *hash = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, g_free);
+    data = adg_model_get_instance_private(model);
+    slot = g_ptr_array_index(data->slots,
+                             _adg_model_get_slot(model, g_quark_from_string(name)));
 
-    g_hash_table_insert(*hash, key, value);
+    if (! slot->is_defined || ! cpml_pair_equal(&slot->pair, pair)) {
+        slot->is_defined = TRUE;
+        cpml_pair_copy(&slot->pair, pair);
+        ++slot->version;
+    }
 }
 
 static const CpmlPair *
 _adg_named_pair(AdgModel *model, const gchar *name)
 {
-    AdgModelPrivate *data = adg_model_get_instance_private(model);
+    AdgPairSlot *slot = _adg_lookup_slot(model, g_quark_try_string(name));
 
-    if (data->named_pairs == NULL)
+    if (slot == NULL || ! slot->is_defined)
         return NULL;
 
-    return g_hash_table_lookup(data->named_pairs, name);
+    return &slot->pair;
 }
 
 static void
 _adg_changed(AdgModel *model)
 {
-    /* Invalidate all the entities dependent on this model */
-    adg_model_foreach_dependency(model, _adg_invalidate_wrapper, NULL);
+    AdgModelUpdate *update, local;
+
+    /* While flushing an update, the entities are collected
+     * and invalidated all together at the end of the flush */
+    update = g_private_get(&_adg_update);
+    if (update != NULL && update->seen != NULL) {
+        _adg_collect(model, update);
+        return;
+    }
+
+    local.entities = g_ptr_array_new_with_free_func(g_object_unref);
+    local.seen = g_hash_table_new(NULL, NULL);
+    _adg_collect(model, &local);
+    _adg_invalidate_collected(&local);
+}
+
+static AdgPairSlot *
+_adg_lookup_slot(AdgModel *model, GQuark name)
+{
+    AdgModelPrivate *data = adg_model_get_instance_private(model);
+    guint index;
+
+    if (name == 0)
+        return NULL;
+
+    /* Indexes are stored off by one, to distinguish the first slot
+     * from a missing key */
+    index = GPOINTER_TO_UINT(g_hash_table_lookup(data->slot_index,
+                                                 GUINT_TO_POINTER(name)));
+    return index > 0 ? g_ptr_array_index(data->slots, index - 1) : NULL;
+}
+
+
+static void
+_adg_collect_wrapper(AdgModel *model, AdgEntity *entity, gpointer user_data)
+{
+    AdgModelUpdate *update = user_data;
+
+    if (g_hash_table_add(update->seen, entity))
+        g_ptr_array_add(update->entities, g_object_ref(entity));
 }
 
 static void
-_adg_named_pair_wrapper(gpointer key, gpointer value, gpointer user_data)
+_adg_collect(AdgModel *model, AdgModelUpdate *update)
 {
-    const gchar *name;
-    CpmlPair *pair;
-    AdgWrapperHelper *helper;
+    AdgModelPrivate *data = adg_model_get_instance_private(model);
+    GHashTableIter iter, entities;
+    gpointer key, value, entity;
+
+    adg_model_foreach_dependency(model, _adg_collect_wrapper, update);
 
-    name = key;
-    pair = value;
-    helper = user_data;
+    if (data->pair_dependencies == NULL)
+        return;
 
-    helper->callback(helper->model, name, pair, helper->user_data);
+    /* Only the entities bound to modified named pairs are collected */
+    g_hash_table_iter_init(&iter, data->pair_dependencies);
+    while (g_hash_table_iter_next(&iter, &key, &value)) {
+        if (! _adg_pair_dependency_sync(model,
+                                        g_quark_to_string(GPOINTER_TO_UINT(key)),
+                                        value))
+            continue;
+
+        g_hash_table_iter_init(&entities,
+                               ((AdgPairDependency *) value)->entities.entities);
+        while (g_hash_table_iter_next(&entities, &entity, NULL))
+            _adg_collect_wrapper(model, entity, update);
+    }
 }
 
 static void
-_adg_invalidate_wrapper(AdgModel *model, AdgEntity *entity, gpointer user_data)
+_adg_invalidate_collected(AdgModelUpdate *update)
 {
-    adg_entity_invalidate(entity);
+    GPtrArray *entities = update->entities;
+    guint n;
+
+    update->entities = NULL;
+    g_hash_table_destroy(update->seen);
+    update->seen = NULL;
+
+    for (n = 0; n < entities->len; ++n)
+        adg_entity_invalidate(g_ptr_array_index(entities, n));
+
+    g_ptr_array_free(entities, TRUE);
+}
+
+static gboolean
+_adg_pair_dependency_sync(AdgModel *model, const gchar *name,
+                          AdgPairDependency *dependency)
+{
+    const CpmlPair *pair = adg_model_get_named_pair(model, name);
+    gboolean changed;
+
+    if (pair == NULL) {
+        changed = dependency->is_defined;
+        dependency->is_defined = FALSE;
+    } else {
+        changed = ! dependency->is_defined ||
+                  ! cpml_pair_equal(pair, &dependency->pair);
+        dependency->is_defined = TRUE;
+        cpml_pair_copy(&dependency->pair, pair);
+    }
+
+    return changed;
+}
+
+static void
+_adg_update_flush(AdgModelUpdate *update)
+{
+    GPtrArray *pending;
+    AdgModel *model;
+    AdgModelPrivate *data;
+    guint n;
+
+    /* A flush is already in progress up in the stack: it will
+     * take care of the models changed in the meantime */
+    if (update->seen != NULL)
+        return;
+
+    update->entities = g_ptr_array_new_with_free_func(g_object_unref);
+    update->seen = g_hash_table_new(NULL, NULL);
+
+    /* The handlers can change other models, so loop until
+     * no more models are pending */
+    while (update->pending->len > 0) {
+        pending = update->pending;
+        update->pending = g_ptr_array_new();
+
+        for (n = 0; n < pending->len; ++n) {
+            model = g_ptr_array_index(pending, n);
+            data = adg_model_get_instance_private(model);
+            data->pending = FALSE;
+            g_signal_emit(model, _adg_signals[CHANGED], 0);
+            g_object_unref(model);
+        }
+
+        g_ptr_array_free(pending, TRUE);
+    }
+
+    _adg_invalidate_collected(update);
+}
+
+static void
+_adg_update_free(gpointer user_data)
+{
+    AdgModelUpdate *update = user_data;
+
+    g_ptr_array_free(update->pending, TRUE);
+    g_free(update);
+}
+
+static void
+_adg_dependency_set_init(AdgDependencySet *set)
+{
+    set->entities = g_hash_table_new(NULL, NULL);
+    set->list = NULL;
+}
+
+static void
+_adg_dependency_set_finalize(AdgDependencySet *set)
+{
+    g_hash_table_destroy(set->entities);
+    g_slist_free(set->list);
+}
+
+static void
+_adg_dependency_set_add(AdgDependencySet *set, AdgEntity *entity)
+{
+    guint count = GPOINTER_TO_UINT(g_hash_table_lookup(set->entities, entity));
+
+    /* A single reference is held, whatever the number of additions */
+    if (count == 0) {
+        g_object_ref(entity);
+        g_slist_free(set->list);
+        set->list = NULL;
+    }
+
+    g_hash_table_insert(set->entities, entity, GUINT_TO_POINTER(count + 1));
+}
+
+/* Returns FALSE if entity is not in set. When the last addition of
+ * entity is removed, dropped is set to TRUE and the caller must
+ * release the reference once its own bookkeeping is consistent. */
+static gboolean
+_adg_dependency_set_remove(AdgDependencySet *set, AdgEntity *entity,
+                           gboolean *dropped)
+{
+    guint count = GPOINTER_TO_UINT(g_hash_table_lookup(set->entities, entity));
+
+    if (count == 0)
+        return FALSE;
+
+    *dropped = count == 1;
+
+    if (*dropped) {
+        g_hash_table_remove(set->entities, entity);
+        g_slist_free(set->list);
+        set->list = NULL;
+    } else {
+        g_hash_table_insert(set->entities, entity, GUINT_TO_POINTER(count - 1));
+    }
+
+    return TRUE;
+}
+
+static AdgEntity *
+_adg_dependency_set_any(AdgDependencySet *set)
+{
+    GHashTableIter iter;
+    gpointer entity;
+
+    g_hash_table_iter_init(&iter, set->entities);
+    return g_hash_table_iter_next(&iter, &entity, NULL) ? entity : NULL;
+}
+
+static const GSList *
+_adg_dependency_set_list(AdgDependencySet *set)
+{
+    GHashTableIter iter;
+    gpointer entity;
+
+    if (set->list == NULL) {
+        g_hash_table_iter_init(&iter, set->entities);
+        while (g_hash_table_iter_next(&iter, &entity, NULL))
+            set->list = g_slist_prepend(set->list, entity);
+    }
+
+    return set->list;
+}
+
+static void
+_adg_pair_dependency_free(gpointer user_data)
+{
+    AdgPairDependency *dependency = user_data;
+
+    _adg_dependency_set_finalize(&dependency->entities);
+    g_free(dependency);
 }
@@ -82,6 +82,14 @@ void            adg_model_add_dependency        (AdgModel         *model,
 void            adg_model_remove_dependency     (AdgModel         *model,
                                                  AdgEntity        *entity);
 const GSList *  adg_model_get_dependencies      (AdgModel         *model);
+void            adg_model_add_pair_dependency   (AdgModel         *model,
+                                                 const gchar      *name,
+                                                 AdgEntity        *entity);
+void            adg_model_remove_pair_dependency(AdgModel         *model,
+                                                 const gchar      *name,
+                                                 AdgEntity        *entity);
+const GSList *  adg_model_get_pair_dependencies (AdgModel         *model,
+                                                 const gchar      *name);
 void            adg_model_foreach_dependency    (AdgModel         *model,
                                                  AdgDependencyFunc callback,
                                                  gpointer          user_data);
@@ -101,6 +109,8 @@ void            adg_model_foreach_named_pair    (AdgModel         *model,
 void            adg_model_clear                 (AdgModel         *model);
 void            adg_model_reset                 (AdgModel         *model);
 void            adg_model_changed               (AdgModel         *model);
+void            adg_model_begin_update          (AdgModel         *model);
+void            adg_model_end_update            (AdgModel         *model);
 
 G_END_DECLS
 
@@ -29,6 +29,9 @@ typedef struct _AdgPangoStylePrivate AdgPangoStylePrivate;
 struct _AdgPangoStylePrivate {
     PangoFontDescription   *font_description;
     gint                    spacing;
+
+    PangoLayout            *layout;
+    GHashTable             *text_extents;
 };
 
 G_END_DECLS
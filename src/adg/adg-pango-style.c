@@ -24,6 +24,12 @@
  *
  * Adds pango support to the #AdgFontStyle class.
  *
+ * Every pango style keeps a private #PangoLayout used only to measure
+ * text and caches the logical extents of any string measured through
+ * it, so identical strings rendered with the same style (think about
+ * the cells of a title block or the "Ø" prefix of diameters) are
+ * shaped only once. The cache is dropped whenever the style changes.
+ *
  * Since: 1.0
  */
 
@@ -38,7 +44,7 @@
 
 
 #include "adg-internal.h"
-#include <pango/pango.h>
+#include <pango/pangocairo.h>
 
 #include "adg-style.h"
 #include "adg-dress.h"
@@ -48,7 +54,13 @@
 #include "adg-pango-style-private.h"
 
 
-#define _ADG_OLD_STYLE_CLASS  ((AdgStyleClass *) adg_pango_style_parent_class)
+#define _ADG_OLD_OBJECT_CLASS  ((GObjectClass *) adg_pango_style_parent_class)
+#define _ADG_OLD_STYLE_CLASS   ((AdgStyleClass *) adg_pango_style_parent_class)
+
+/* Upper bound of the text extents cache: when reached, the cache is
+ * simply flushed, as a text changing at every arrange (e.g. a clock)
+ * would otherwise make it grow indefinitely */
+#define _ADG_MAX_TEXT_EXTENTS  1024
 
 
 G_DEFINE_TYPE_WITH_PRIVATE(AdgPangoStyle, adg_pango_style, ADG_TYPE_FONT_STYLE)
@@ -59,6 +71,7 @@ enum {
 };
 
 
+static void             _adg_finalize           (GObject        *object);
 static void             _adg_get_property       (GObject        *object,
                                                  guint           prop_id,
                                                  GValue         *value,
@@ -71,6 +84,8 @@ static void             _adg_invalidate         (AdgStyle       *style);
 static void             _adg_apply              (AdgStyle       *style,
                                                  AdgEntity      *entity,
                                                  cairo_t        *cr);
+static PangoFontMap *   _adg_font_map           (void);
+static void             _adg_clear_cache        (AdgPangoStyle  *pango_style);
 
 
 static void
@@ -83,6 +98,7 @@ adg_pango_style_class_init(AdgPangoStyleClass *klass)
     gobject_class = (GObjectClass *) klass;
     style_class = (AdgStyleClass *) klass;
 
+    gobject_class->finalize = _adg_finalize;
     gobject_class->get_property = _adg_get_property;
     gobject_class->set_property = _adg_set_property;
 
@@ -103,6 +119,23 @@ adg_pango_style_init(AdgPangoStyle *pango_style)
     AdgPangoStylePrivate *data = adg_pango_style_get_instance_private(pango_style);
     data->font_description = NULL;
     data->spacing = 0;
+    data->layout = NULL;
+    data->text_extents = NULL;
+}
+
+static void
+_adg_finalize(GObject *object)
+{
+    AdgPangoStyle *pango_style = (AdgPangoStyle *) object;
+    AdgPangoStylePrivate *data = adg_pango_style_get_instance_private(pango_style);
+
+    _adg_clear_cache(pango_style);
+
+    if (data->font_description != NULL)
+        pango_font_description_free(data->font_description);
+
+    if (_ADG_OLD_OBJECT_CLASS->finalize)
+        _ADG_OLD_OBJECT_CLASS->finalize(object);
 }
 
 static void
@@ -130,6 +163,7 @@ _adg_set_property(GObject *object, guint prop_id,
     switch (prop_id) {
     case PROP_SPACING:
         data->spacing = g_value_get_int(value);
+        adg_style_invalidate((AdgStyle *) object);
         break;
     default:
         G_OBJECT_WARN_INVALID_PROPERTY_ID(object, prop_id, pspec);
@@ -264,6 +298,104 @@ adg_pango_style_get_spacing(AdgPangoStyle *pango_style)
     return data->spacing;
 }
 
+/**
+ * adg_pango_style_new_layout:
+ * @pango_style: an #AdgPangoStyle object
+ * @text: the text to lay out
+ *
+ * Creates a new #PangoLayout showing @text with the font description
+ * and the spacing of @pango_style. The layout has its own context
+ * (sharing the font map with any other layout created by the ADG),
+ * so it can be freely updated with pango_cairo_update_layout()
+ * without affecting other layouts.
+ *
+ * Returns: (transfer full): a newly created layout, to be freed with g_object_unref().
+ *
+ * Since: 1.0
+ **/
+PangoLayout *
+adg_pango_style_new_layout(AdgPangoStyle *pango_style, const gchar *text)
+{
+    PangoContext *context;
+    cairo_font_options_t *options;
+    PangoLayout *layout;
+
+    g_return_val_if_fail(ADG_IS_PANGO_STYLE(pango_style), NULL);
+
+    context = pango_context_new();
+    pango_context_set_font_map(context, _adg_font_map());
+    pango_cairo_context_set_resolution(context, 72);
+
+    options = adg_font_style_new_options((AdgFontStyle *) pango_style);
+    pango_cairo_context_set_font_options(context, options);
+    cairo_font_options_destroy(options);
+
+    layout = pango_layout_new(context);
+    g_object_unref(context);
+
+    pango_layout_set_spacing(layout, adg_pango_style_get_spacing(pango_style));
+    pango_layout_set_font_description(layout,
+                                      adg_pango_style_get_description(pango_style));
+    if (text != NULL)
+        pango_layout_set_text(layout, text, -1);
+
+    return layout;
+}
+
+/**
+ * adg_pango_style_put_text_extents:
+ * @pango_style: an #AdgPangoStyle object
+ * @text: the text to measure
+ * @extents: (out): where to store the logical extents
+ *
+ * Computes the logical extents of @text, as it would be laid out by
+ * adg_pango_style_new_layout(), and stores them in @extents (in pango
+ * units). The result is cached by @pango_style, so measuring the same
+ * string again does not involve any further shaping.
+ *
+ * Returns: <constant>TRUE</constant> on success, <constant>FALSE</constant> on errors.
+ *
+ * Since: 1.0
+ **/
+gboolean
+adg_pango_style_put_text_extents(AdgPangoStyle *pango_style, const gchar *text,
+                                 PangoRectangle *extents)
+{
+    AdgPangoStylePrivate *data;
+    PangoRectangle *cached;
+
+    g_return_val_if_fail(ADG_IS_PANGO_STYLE(pango_style), FALSE);
+    g_return_val_if_fail(text != NULL, FALSE);
+    g_return_val_if_fail(extents != NULL, FALSE);
+
+    data = adg_pango_style_get_instance_private(pango_style);
+
+    if (data->text_extents == NULL) {
+        data->text_extents = g_hash_table_new_full(g_str_hash, g_str_equal,
+                                                   g_free, g_free);
+    } else {
+        cached = g_hash_table_lookup(data->text_extents, text);
+        if (cached != NULL) {
+            *extents = *cached;
+            return TRUE;
+        }
+
+        if (g_hash_table_size(data->text_extents) >= _ADG_MAX_TEXT_EXTENTS)
+            g_hash_table_remove_all(data->text_extents);
+    }
+
+    if (data->layout == NULL)
+        data->layout = adg_pango_style_new_layout(pango_style, NULL);
+
+    cached = g_new(PangoRectangle, 1);
+    pango_layout_set_text(data->layout, text, -1);
+    pango_layout_get_extents(data->layout, NULL, cached);
+    g_hash_table_insert(data->text_extents, g_strdup(text), cached);
+
+    *extents = *cached;
+    return TRUE;
+}
+
 
 static void
 _adg_invalidate(AdgStyle *style)
@@ -276,6 +408,8 @@ _adg_invalidate(AdgStyle *style)
         data->font_description = NULL;
     }
 
+    _adg_clear_cache(pango_style);
+
     if (_ADG_OLD_STYLE_CLASS->invalidate != NULL)
         _ADG_OLD_STYLE_CLASS->invalidate(style);
 }
@@ -291,3 +425,49 @@ _adg_apply(AdgStyle *style, AdgEntity *entity, cairo_t *cr)
 
     adg_entity_apply_dress(entity, color_dress, cr);
 }
+
+static PangoFontMap *
+_adg_font_map(void)
+{
+    /* Pango objects are not thread-safe, so every thread gets its
+     * own font map. Keep around the font_map object. The rationale is:
+     * https://bugzilla.gnome.org/show_bug.cgi?id=143542
+     *
+     * Basically, PangoFontMap is a heavy object and
+     * creating/destroying it is not the right thing to do.
+     *
+     * In reality, the blocking issue for me was the following
+     * line makes the adg-demo program crash on MinGW32:
+     * g_object_unref(font_map);
+     *
+     * so the font map is never released while its thread is alive.
+     * It is released only when the thread exits (the destroy notify
+     * is not called for the main thread), otherwise every worker of
+     * adg_canvas_export_batch() would leak its own font map.
+     */
+    static GPrivate font_map_key = G_PRIVATE_INIT(g_object_unref);
+    PangoFontMap *font_map = g_private_get(&font_map_key);
+
+    if (font_map == NULL) {
+        font_map = pango_cairo_font_map_new();
+        g_private_set(&font_map_key, font_map);
+    }
+
+    return font_map;
+}
+
+static void
+_adg_clear_cache(AdgPangoStyle *pango_style)
+{
+    AdgPangoStylePrivate *data = adg_pango_style_get_instance_private(pango_style);
+
+    if (data->layout != NULL) {
+        g_object_unref(data->layout);
+        data->layout = NULL;
+    }
+
+    if (data->text_extents != NULL) {
+        g_hash_table_destroy(data->text_extents);
+        data->text_extents = NULL;
+    }
+}
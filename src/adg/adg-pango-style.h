@@ -58,6 +58,11 @@ PangoFontDescription *
 gint            adg_pango_style_get_spacing     (AdgPangoStyle  *pango_style);
 void            adg_pango_style_set_spacing     (AdgPangoStyle  *pango_style,
                                                  gint            spacing);
+PangoLayout *   adg_pango_style_new_layout      (AdgPangoStyle  *pango_style,
+                                                 const gchar    *text);
+gboolean        adg_pango_style_put_text_extents(AdgPangoStyle  *pango_style,
+                                                 const gchar    *text,
+                                                 PangoRectangle *extents);
 
 
 G_END_DECLS
@@ -27,6 +27,7 @@ G_BEGIN_DECLS
 typedef struct _AdgNamedPair     AdgNamedPair;
 typedef enum   _AdgAction        AdgAction;
 typedef struct _AdgOperation     AdgOperation;
+typedef struct _AdgPrimitiveRef  AdgPrimitiveRef;
 typedef struct _AdgPathPrivate   AdgPathPrivate;
 
 struct _AdgNamedPair {
@@ -54,6 +55,13 @@ struct _AdgOperation{
 
 };
 
+/* Offsets of a primitive inside the path array: offsets are used
+ * instead of pointers so they survive any array reallocation */
+struct _AdgPrimitiveRef {
+    guint        org;
+    guint        data;
+};
+
 struct _AdgPathPrivate {
     gboolean             cp_is_valid;
     CpmlPair             cp;
@@ -63,6 +71,7 @@ struct _AdgPathPrivate {
         GArray          *array;
     }                    cairo;
 
+    GArray              *primitives;
     CpmlPrimitive        last;
     CpmlPrimitive        over;
     AdgOperation         operation;
@@ -64,6 +64,7 @@
 
 #include "adg-model.h"
 #include "adg-trail.h"
+#include <string.h>
 
 #include "adg-path.h"
 #include "adg-path-private.h"
@@ -76,6 +77,8 @@
     (ptr) == NULL ? NULL : \
         (gpointer) ((guint8 *) (ptr) - (guint8 *) (from) + (guint8 *) (to))
 
+#define NO_ORG  G_MAXUINT
+
 
 G_DEFINE_TYPE_WITH_PRIVATE(AdgPath, adg_path, ADG_TYPE_TRAIL)
 
@@ -92,7 +95,20 @@ static void             _adg_primitive_remap    (CpmlPrimitive  *primitive,
                                                  const CpmlPrimitive
                                                                 *old,
                                                  gconstpointer   from);
+static void             _adg_push_primitive     (AdgPath        *path,
+                                                 const CpmlPrimitive
+                                                                *primitive);
+static void             _adg_load_primitive     (AdgPath        *path,
+                                                 CpmlPrimitive  *primitive,
+                                                 gint            n);
+static void             _adg_sync_primitives    (AdgPath        *path);
+static void             _adg_scan               (AdgPath        *path,
+                                                 guint           from);
 static void             _adg_rescan             (AdgPath        *path);
+static void             _adg_append_data        (AdgPath        *path,
+                                                 const cairo_path_data_t
+                                                                *path_data,
+                                                 gint            num_data);
 static void             _adg_append_primitive   (AdgPath        *path,
                                                  CpmlPrimitive  *primitive);
 static void             _adg_clear_operation    (AdgPath        *path);
@@ -154,6 +170,7 @@ adg_path_init(AdgPath *path)
     data->cairo.path.data = NULL;
     data->cairo.path.num_data = 0;
     data->cairo.array = g_array_new(FALSE, FALSE, sizeof(cairo_path_data_t));
+    data->primitives = g_array_new(FALSE, FALSE, sizeof(AdgPrimitiveRef));
     data->last.segment = NULL;
     data->last.org = NULL;
     data->last.data = NULL;
@@ -170,6 +187,7 @@ _adg_finalize(GObject *object)
     AdgPathPrivate *data = adg_path_get_instance_private(path);
 
     g_array_free(data->cairo.array, TRUE);
+    g_array_free(data->primitives, TRUE);
     _adg_clear_operation(path);
 
     if (_ADG_OLD_OBJECT_CLASS->finalize)
@@ -500,16 +518,8 @@ adg_path_append_segment(AdgPath *path, const CpmlSegment *segment)
     g_return_if_fail(segment != NULL);
 
     if (segment->num_data > 0) {
-        AdgPathPrivate *data;
-
         g_return_if_fail(segment->data != NULL);
-
-        data = adg_path_get_instance_private(path);
-
-        _adg_clear_parent((AdgModel *) path);
-        data->cairo.array = g_array_append_vals(data->cairo.array,
-                                                segment->data, segment->num_data);
-        _adg_rescan(path);
+        _adg_append_data(path, segment->data, segment->num_data);
     }
 }
 
@@ -525,18 +535,10 @@ adg_path_append_segment(AdgPath *path, const CpmlSegment *segment)
 void
 adg_path_append_cairo_path(AdgPath *path, const cairo_path_t *cairo_path)
 {
-    AdgPathPrivate *data;
-
     g_return_if_fail(ADG_IS_PATH(path));
     g_return_if_fail(cairo_path != NULL);
 
-    data = adg_path_get_instance_private(path);
-
-    _adg_clear_parent((AdgModel *) path);
-    data->cairo.array = g_array_append_vals(data->cairo.array,
-                                            cairo_path->data,
-                                            cairo_path->num_data);
-    _adg_rescan(path);
+    _adg_append_data(path, cairo_path->data, cairo_path->num_data);
 }
 
 /**
@@ -553,8 +555,9 @@ adg_path_append_cairo_path(AdgPath *path, const cairo_path_t *cairo_path)
 void
 adg_path_append_trail(AdgPath *path, AdgTrail *trail)
 {
-    GSList *named_pairs;
+    GArray *named_pairs;
     AdgNamedPair *named_pair;
+    guint n;
 
     g_return_if_fail(ADG_IS_PATH(path));
     g_return_if_fail(ADG_IS_TRAIL(trail));
@@ -562,17 +565,18 @@ adg_path_append_trail(AdgPath *path, AdgTrail *trail)
     adg_path_append_cairo_path(path, adg_trail_get_cairo_path(trail));
 
     /* Populate named_pairs with all the named pairs of trail */
-    named_pairs = NULL;
+    named_pairs = g_array_new(FALSE, FALSE, sizeof(AdgNamedPair));
     adg_model_foreach_named_pair((AdgModel *)trail,
-                                 _adg_get_named_pair, &named_pairs);
+                                 _adg_get_named_pair, named_pairs);
 
     /* Readd the pairs to path */
-    while (named_pairs) {
-        named_pair = (AdgNamedPair *) named_pairs->data;
+    for (n = 0; n < named_pairs->len; ++n) {
+        named_pair = &g_array_index(named_pairs, AdgNamedPair, n);
         adg_model_set_named_pair((AdgModel *) path,
                                  named_pair->name, &named_pair->pair);
-        named_pairs = g_slist_delete_link(named_pairs, named_pairs);
     }
+
+    g_array_free(named_pairs, TRUE);
 }
 
 /**
@@ -587,27 +591,30 @@ void
 adg_path_remove_primitive(AdgPath *path)
 {
     AdgPathPrivate *data;
-    const CpmlPrimitive *over;
+    GArray *primitives;
     guint len;
 
     g_return_if_fail(ADG_IS_PATH(path));
 
     data = adg_path_get_instance_private(path);
-    over = adg_path_over_primitive(path);
+    primitives = data->primitives;
 
-    if (over) {
-        cairo_path_data_t *end = over->data + over->data->header.length;
-        len = end - (cairo_path_data_t *) (data->cairo.array)->data;
+    if (primitives->len > 1) {
+        /* Keep everything up to the end of the over primitive */
+        cairo_path_data_t *path_data = (cairo_path_data_t *) data->cairo.array->data;
+        len = g_array_index(primitives, AdgPrimitiveRef, primitives->len - 2).data;
+        len += path_data[len].header.length;
     } else {
         len = 0;
     }
 
-    /* Resize the data array */
+    /* Resize the data array and drop the last primitive */
     g_array_set_size(data->cairo.array, len);
+    if (primitives->len > 0)
+        g_array_set_size(primitives, primitives->len - 1);
 
-    /* Rescan path to compute the new over and last primitives */
     _adg_clear_parent((AdgModel *) path);
-    _adg_rescan(path);
+    _adg_sync_primitives(path);
 }
 
 /**
@@ -981,12 +988,13 @@ adg_path_join(AdgPath *path)
 {
     cairo_path_t *cairo_path;
     cairo_path_data_t *data;
-    gboolean pen_down;
+    gboolean pen_down, joined;
 
     g_return_if_fail(ADG_IS_PATH(path));
 
     cairo_path = _adg_read_cairo_path(path);
     pen_down = FALSE;
+    joined = FALSE;
     data = cairo_path->data;
 
     while (data - cairo_path->data < cairo_path->num_data) {
@@ -994,9 +1002,16 @@ adg_path_join(AdgPath *path)
             pen_down = TRUE;
         } else if (pen_down) {
             data->header.type = CPML_LINE;
+            joined = TRUE;
         }
         data += data->header.length;
     }
+
+    /* The former CPML_MOVE are now full-fledged primitives */
+    if (joined) {
+        _adg_clear_parent((AdgModel *) path);
+        _adg_rescan(path);
+    }
 }
 
 /**
@@ -1009,7 +1024,8 @@ adg_path_join(AdgPath *path)
  * is duplicated and the proper transformation (computed from
  * @vector) to mirror the segment is applied on all its points.
  * The result is then reversed with cpml_segment_reverse() and
- * appended to the original path with adg_path_append_segment().
+ * appended to the original path. All the segments are reflected
+ * in a single pass, so the operation is linear in the path size.
  *
  * For convenience, if @vector is <constant>NULL</constant> the
  * path is reversed around the x axis <constant>(y = 0)</constant>.
@@ -1020,16 +1036,16 @@ void
 adg_path_reflect(AdgPath *path, const CpmlVector *vector)
 {
     AdgModel *model;
-    AdgTrail *trail;
     cairo_matrix_t matrix;
-    CpmlSegment segment, *dup_segment;
-    gint n;
+    cairo_path_t *cairo_path;
+    CpmlSegment segment;
+    GArray *segments, *reflected;
+    guint n;
 
     g_return_if_fail(ADG_IS_PATH(path));
     g_return_if_fail(vector == NULL || vector->x != 0 || vector->y != 0);
 
     model = (AdgModel *) path;
-    trail = (AdgTrail *) path;
 
     if (vector == NULL) {
         cairo_matrix_init_scale(&matrix, 1, -1);
@@ -1053,26 +1069,46 @@ adg_path_reflect(AdgPath *path, const CpmlVector *vector)
                           sin2angle, -cos2angle, 0, 0);
     }
 
-    for (n = adg_trail_n_segments(trail); n > 0; --n) {
-        adg_trail_put_segment(trail, n, &segment);
+    /* Collect the segments once: appending to the path invalidates
+     * the segment index of AdgTrail, so adg_trail_put_segment()
+     * would rescan the whole path for every reflected segment */
+    cairo_path = _adg_read_cairo_path(path);
+    segments = g_array_new(FALSE, FALSE, sizeof(CpmlSegment));
+    if (cpml_segment_from_cairo(&segment, cairo_path)) {
+        do {
+            g_array_append_val(segments, segment);
+        } while (cpml_segment_next(&segment));
+    }
+
+    /* Build the reflected segments in reverse order in a single
+     * chunk, so the path is extended and rescanned only once */
+    reflected = g_array_sized_new(FALSE, FALSE, sizeof(cairo_path_data_t),
+                                  cairo_path->num_data);
+    for (n = segments->len; n > 0; --n) {
+        const CpmlSegment *src = &g_array_index(segments, CpmlSegment, n - 1);
+        guint start = reflected->len;
 
         /* No need to reverse an empty segment */
-        if (segment.num_data == 0 || segment.num_data == 0)
+        if (src->num_data == 0)
             continue;
 
-        dup_segment = cpml_segment_deep_dup(&segment);
-        if (dup_segment == NULL)
-            return;
-
-        cpml_segment_reverse(dup_segment);
-        cpml_segment_transform(dup_segment, &matrix);
-        dup_segment->data[0].header.type = CPML_MOVE;
+        g_array_append_vals(reflected, src->data, src->num_data);
 
-        adg_path_append_segment(path, dup_segment);
+        segment.path = NULL;
+        segment.data = (cairo_path_data_t *) reflected->data + start;
+        segment.num_data = src->num_data;
 
-        g_free(dup_segment);
+        cpml_segment_reverse(&segment);
+        cpml_segment_transform(&segment, &matrix);
+        segment.data[0].header.type = CPML_MOVE;
     }
 
+    _adg_append_data(path, (cairo_path_data_t *) reflected->data,
+                     reflected->len);
+
+    g_array_free(reflected, TRUE);
+    g_array_free(segments, TRUE);
+
     _adg_dup_reverse_named_pairs(model, &matrix);
 }
 
@@ -1106,6 +1142,7 @@ _adg_clear(AdgModel *model)
     AdgPathPrivate *data = adg_path_get_instance_private(path);
 
     g_array_set_size(data->cairo.array, 0);
+    g_array_set_size(data->primitives, 0);
     _adg_clear_operation(path);
     _adg_clear_parent(model);
 }
@@ -1129,7 +1166,8 @@ _adg_changed(AdgModel *model)
 static cairo_path_t *
 _adg_get_cairo_path(AdgTrail *trail)
 {
-    _adg_clear_parent((AdgModel *) trail);
+    /* Every change to the array already clears the parent caches,
+     * so the segment index of AdgTrail can survive plain reads */
     return _adg_read_cairo_path((AdgPath *) trail);
 }
 
@@ -1174,34 +1212,46 @@ _adg_primitive_remap(CpmlPrimitive *primitive, gpointer to,
 }
 
 static void
-_adg_rescan(AdgPath *path)
+_adg_push_primitive(AdgPath *path, const CpmlPrimitive *primitive)
 {
     AdgPathPrivate *data = adg_path_get_instance_private(path);
-    CpmlPrimitive *last = &data->last;
-    CpmlPrimitive *over = &data->over;
-    CpmlSegment segment;
-    CpmlPrimitive current;
+    cairo_path_data_t *base = (cairo_path_data_t *) data->cairo.array->data;
+    AdgPrimitiveRef ref;
 
-    last->segment = NULL;
-    last->org = NULL;
-    last->data = NULL;
-    over->segment = NULL;
-    over->org = NULL;
-    over->data = NULL;
+    ref.org = primitive->org == NULL ? NO_ORG : primitive->org - base;
+    ref.data = primitive->data - base;
+    g_array_append_val(data->primitives, ref);
+}
 
-    /* When no data is present, just bail out */
-    if (! cpml_segment_from_cairo(&segment, _adg_read_cairo_path(path))) {
-        data->cp_is_valid = FALSE;
+static void
+_adg_load_primitive(AdgPath *path, CpmlPrimitive *primitive, gint n)
+{
+    AdgPathPrivate *data = adg_path_get_instance_private(path);
+    cairo_path_data_t *base = (cairo_path_data_t *) data->cairo.array->data;
+    const AdgPrimitiveRef *ref;
+
+    primitive->segment = NULL;
+
+    if (n < 0) {
+        primitive->org = NULL;
+        primitive->data = NULL;
         return;
     }
 
-    do {
-        cpml_primitive_from_segment(&current, &segment);
-        do {
-            cpml_primitive_copy(over, last);
-            cpml_primitive_copy(last, &current);
-        } while (cpml_primitive_next(&current));
-    } while (cpml_segment_next(&segment));
+    ref = &g_array_index(data->primitives, AdgPrimitiveRef, n);
+    primitive->org = ref->org == NO_ORG ? NULL : base + ref->org;
+    primitive->data = base + ref->data;
+}
+
+static void
+_adg_sync_primitives(AdgPath *path)
+{
+    AdgPathPrivate *data = adg_path_get_instance_private(path);
+    CpmlPrimitive *last = &data->last;
+    gint len = data->primitives->len;
+
+    _adg_load_primitive(path, last, len - 1);
+    _adg_load_primitive(path, &data->over, len - 2);
 
     /* Save the last point in the current point */
     data->cp_is_valid = last->data && last->data->header.type != CPML_CLOSE;
@@ -1212,6 +1262,65 @@ _adg_rescan(AdgPath *path)
     }
 }
 
+static void
+_adg_scan(AdgPath *path, guint from)
+{
+    AdgPathPrivate *data = adg_path_get_instance_private(path);
+    GArray *array = data->cairo.array;
+    cairo_path_t chunk;
+    CpmlSegment segment;
+    CpmlPrimitive current;
+
+    /* Only the data starting at from is scanned: the primitives
+     * before it are expected to be already in data->primitives */
+    chunk.status = CAIRO_STATUS_SUCCESS;
+    chunk.data = (cairo_path_data_t *) array->data + from;
+    chunk.num_data = array->len - from;
+
+    if (chunk.num_data > 0 && cpml_segment_from_cairo(&segment, &chunk)) {
+        do {
+            cpml_primitive_from_segment(&current, &segment);
+            do {
+                _adg_push_primitive(path, &current);
+            } while (cpml_primitive_next(&current));
+        } while (cpml_segment_next(&segment));
+    }
+
+    _adg_sync_primitives(path);
+}
+
+static void
+_adg_rescan(AdgPath *path)
+{
+    AdgPathPrivate *data = adg_path_get_instance_private(path);
+
+    g_array_set_size(data->primitives, 0);
+    _adg_scan(path, 0);
+}
+
+static void
+_adg_append_data(AdgPath *path, const cairo_path_data_t *path_data,
+                 gint num_data)
+{
+    AdgPathPrivate *data = adg_path_get_instance_private(path);
+    guint from = data->cairo.array->len;
+
+    _adg_clear_parent((AdgModel *) path);
+
+    if (num_data <= 0)
+        return;
+
+    data->cairo.array = g_array_append_vals(data->cairo.array,
+                                            path_data, num_data);
+
+    /* A chunk starting with a CPML_MOVE cannot continue the
+     * last segment, so only the new data needs to be scanned */
+    if (path_data[0].header.type == CPML_MOVE)
+        _adg_scan(path, from);
+    else
+        _adg_rescan(path);
+}
+
 static void
 _adg_append_primitive(AdgPath *path, CpmlPrimitive *current)
 {
@@ -1250,6 +1359,8 @@ _adg_append_primitive(AdgPath *path, CpmlPrimitive *current)
         data->last.org = data->cp_is_valid ? path_data - 1 : NULL;
         data->last.segment = NULL;
         data->last.data = path_data;
+
+        _adg_push_primitive(path, &data->last);
     }
 
     data->cp_is_valid = type != CPML_CLOSE;
@@ -1367,6 +1478,7 @@ _adg_append_operation(AdgPath *path, gint action, ...)
         data->last.data = &path_data[length - 1];
 
         _adg_do_action(path, real_action, &current);
+        _adg_clear_parent((AdgModel *) path);
     }
 
     return TRUE;
@@ -1552,41 +1664,52 @@ static void
 _adg_get_named_pair(AdgModel *model, const gchar *name,
                     CpmlPair *pair, gpointer user_data)
 {
-    GSList **named_pairs;
-    AdgNamedPair *named_pair;
-
-    named_pairs = user_data;
+    AdgNamedPair named_pair;
 
-    named_pair = g_new(AdgNamedPair, 1);
-    named_pair->name = name;
-    named_pair->pair = *pair;
+    /* name is interned by the model, so there is no need to copy it */
+    named_pair.name = name;
+    named_pair.pair = *pair;
 
-    *named_pairs = g_slist_prepend(*named_pairs, named_pair);
+    g_array_append_val((GArray *) user_data, named_pair);
 }
 
 static void
 _adg_dup_reverse_named_pairs(AdgModel *model, const cairo_matrix_t *matrix)
 {
-    AdgNamedPair *old_named_pair;
-    AdgNamedPair named_pair;
-    GSList *named_pairs;
+    AdgNamedPair *named_pair;
+    GArray *named_pairs;
+    CpmlPair pair;
+    gchar buffer[64];
+    gchar *name;
+    gsize len;
+    guint n;
 
     /* Populate named_pairs with all the named pairs of model */
-    named_pairs = NULL;
-    adg_model_foreach_named_pair(model, _adg_get_named_pair, &named_pairs);
+    named_pairs = g_array_new(FALSE, FALSE, sizeof(AdgNamedPair));
+    adg_model_foreach_named_pair(model, _adg_get_named_pair, named_pairs);
 
     /* Readd the pairs applying the reversing transformation matrix to
-     * their coordinates and prepending a "-" to their name */
-    while (named_pairs) {
-        old_named_pair = named_pairs->data;
-
-        named_pair.name = g_strdup_printf("-%s", old_named_pair->name);
-        named_pair.pair = old_named_pair->pair;
-        cpml_pair_transform(&named_pair.pair, matrix);
+     * their coordinates and prepending a "-" to their name: the new
+     * name is built on the stack unless it is unusually long */
+    for (n = 0; n < named_pairs->len; ++n) {
+        named_pair = &g_array_index(named_pairs, AdgNamedPair, n);
+
+        len = strlen(named_pair->name);
+        if (len + 2 <= sizeof(buffer)) {
+            name = buffer;
+            name[0] = '-';
+            memcpy(name + 1, named_pair->name, len + 1);
+        } else {
+            name = g_strconcat("-", named_pair->name, NULL);
+        }
 
-        adg_model_set_named_pair(model, named_pair.name, &named_pair.pair);
+        pair = named_pair->pair;
+        cpml_pair_transform(&pair, matrix);
+        adg_model_set_named_pair(model, name, &pair);
 
-        g_free((gpointer) named_pair.name);
-        named_pairs = g_slist_delete_link(named_pairs, named_pairs);
+        if (name != buffer)
+            g_free(name);
     }
+
+    g_array_free(named_pairs, TRUE);
 }
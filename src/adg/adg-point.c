@@ -32,6 +32,12 @@
  * #CpmlPair on steroid, because it adds named pair support to
  * a simple pair, enabling coordinates depending on #AdgModel.
  *
+ * A point bound to a named pair does not keep the name around: it
+ * holds a direct handle to the pair slot inside the model, so the
+ * pair is resolved without any lookup by name. The handle survives
+ * adg_model_reset(), so a point bound to a pair still to be defined
+ * works as expected.
+ *
  * Since: 1.0
  **/
 
@@ -46,6 +52,7 @@
 
 #include "adg-internal.h"
 #include "adg-model.h"
+#include "adg-model-private.h"
 #include <string.h>
 
 #include "adg-point.h"
@@ -54,7 +61,9 @@
 struct _AdgPoint {
     CpmlPair     pair;
     AdgModel    *model;
-    gchar       *name;
+    GQuark       name;
+    gint         slot;
+    guint        version;
     gboolean     up_to_date;
 };
 
@@ -105,17 +114,12 @@ adg_point_new(void)
 AdgPoint *
 adg_point_dup(const AdgPoint *src)
 {
-    AdgPoint *point;
-
     g_return_val_if_fail(src != NULL, NULL);
 
     if (src->model)
         g_object_ref(src->model);
 
-    point = g_memdup(src, sizeof(AdgPoint));
-    point->name = g_strdup(src->name);
-
-    return point;
+    return g_memdup(src, sizeof(AdgPoint));
 }
 
 /**
@@ -160,11 +164,7 @@ adg_point_copy(AdgPoint *point, const AdgPoint *src)
     if (point->model != NULL)
         g_object_unref(point->model);
 
-    if (point->name != NULL)
-        g_free(point->name);
-
     memcpy(point, src, sizeof(AdgPoint));
-    point->name = g_strdup(src->name);
 }
 
 /**
@@ -226,12 +226,16 @@ void
 adg_point_set_pair_from_model(AdgPoint *point,
                               AdgModel *model, const gchar *name)
 {
+    GQuark quark;
+
     g_return_if_fail(point != NULL);
     g_return_if_fail(ADG_IS_MODEL(model));
     g_return_if_fail(name != NULL);
 
+    quark = g_quark_from_string(name);
+
     /* Return if the new named pair is the same of the old one */
-    if (model == point->model && strcmp(point->name, name) == 0)
+    if (model == point->model && quark == point->name)
         return;
 
     g_object_ref(model);
@@ -239,13 +243,14 @@ adg_point_set_pair_from_model(AdgPoint *point,
     if (point->model) {
         /* Remove the old named pair */
         g_object_unref(point->model);
-        g_free(point->name);
     }
 
     /* Set the new named pair */
     point->up_to_date = FALSE;
     point->model = model;
-    point->name = g_strdup(name);
+    point->name = quark;
+    point->slot = _adg_model_get_slot(model, quark);
+    point->version = 0;
 }
 
 /**
@@ -287,12 +292,13 @@ adg_point_unset(AdgPoint *point)
     if (point->model) {
         /* Remove the old named pair */
         g_object_unref(point->model);
-        g_free(point->name);
     }
 
     point->up_to_date = FALSE;
     point->model = NULL;
-    point->name = NULL;
+    point->name = 0;
+    point->slot = 0;
+    point->version = 0;
 }
 
 /**
@@ -312,6 +318,7 @@ adg_point_update(AdgPoint *point)
 {
     AdgModel *model;
     const CpmlPair *pair;
+    guint version;
 
     g_return_val_if_fail(point != NULL, FALSE);
 
@@ -327,11 +334,18 @@ adg_point_update(AdgPoint *point)
         return FALSE;
     }
 
-    pair = adg_model_get_named_pair(model, point->name);
+    pair = _adg_model_slot_pair(model, point->slot, &version);
     if (pair == NULL)
         return FALSE;
 
-    cpml_pair_copy(&point->pair, pair);
+    /* The version check saves the copy when the pair has not been
+     * modified since the last update: a version of 0 means the
+     * pair cannot be tracked and must always be refreshed */
+    if (version == 0 || version != point->version) {
+        cpml_pair_copy(&point->pair, pair);
+        point->version = version;
+    }
+
     point->up_to_date = TRUE;
     return TRUE;
 }
@@ -402,7 +416,7 @@ const gchar *
 adg_point_get_name(const AdgPoint *point)
 {
     g_return_val_if_fail(point != NULL, NULL);
-    return point->name;
+    return g_quark_to_string(point->name);
 }
 
 /**
@@ -447,7 +461,7 @@ adg_point_equal(const AdgPoint *point1, const AdgPoint *point2)
 
     /* Handle points bound to named pairs */
     if (point1->model != NULL)
-        return g_strcmp0(point1->name, point2->name) == 0;
+        return point1->name == point2->name;
 
     /* Handle points with explicit coordinates */
     return cpml_pair_equal(&point1->pair, &point2->pair);
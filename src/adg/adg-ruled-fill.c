@@ -26,6 +26,12 @@
  * adg_ruled_fill_set_spacing() method. The angle of the lines should
  * be changed with adg_ruled_fill_set_angle().
  *
+ * By default the lines are rendered on a surface as big as the
+ * filling extents, later used as source pattern. When the vector
+ * mode is enabled with adg_ruled_fill_switch_vector(), the lines
+ * are instead clipped against the boundary of the current path and
+ * stroked directly, without any intermediate surface.
+ *
  * Since: 1.0
  **/
 
@@ -61,7 +67,8 @@ enum {
     PROP_0,
     PROP_LINE_DRESS,
     PROP_SPACING,
-    PROP_ANGLE
+    PROP_ANGLE,
+    PROP_VECTOR
 };
 
 
@@ -84,6 +91,23 @@ static cairo_pattern_t *_adg_create_pattern     (AdgRuledFill   *ruled_fill,
 static void             _adg_draw_lines         (const CpmlPair *spacing,
                                                  const CpmlPair *size,
                                                  cairo_t        *cr);
+static void             _adg_apply_vector       (AdgRuledFill   *ruled_fill,
+                                                 AdgEntity      *entity,
+                                                 cairo_t        *cr);
+static void             _adg_clip_line          (const CpmlPair *dir,
+                                                 const CpmlPair *normal,
+                                                 gdouble         offset,
+                                                 const cairo_path_t *boundary,
+                                                 GArray         *positions,
+                                                 cairo_t        *cr);
+static void             _adg_add_crossing       (const CpmlPair *p1,
+                                                 const CpmlPair *p2,
+                                                 const CpmlPair *dir,
+                                                 const CpmlPair *normal,
+                                                 gdouble         offset,
+                                                 GArray         *positions);
+static gint             _adg_compare_pos        (gconstpointer   a,
+                                                 gconstpointer   b);
 
 
 static void
@@ -125,6 +149,13 @@ adg_ruled_fill_class_init(AdgRuledFillClass *klass)
                                0, G_PI, G_PI_4,
                                G_PARAM_READWRITE);
     g_object_class_install_property(gobject_class, PROP_ANGLE, param);
+
+    param = g_param_spec_boolean("vector",
+                                 P_("Vector Mode"),
+                                 P_("If enabled, the lines are clipped against the path to fill and stroked directly instead of being rendered on an intermediate surface"),
+                                 FALSE,
+                                 G_PARAM_READWRITE);
+    g_object_class_install_property(gobject_class, PROP_VECTOR, param);
 }
 
 static void
@@ -134,6 +165,7 @@ adg_ruled_fill_init(AdgRuledFill *ruled_fill)
     data->line_dress = ADG_DRESS_LINE_FILL;
     data->angle = G_PI_4;
     data->spacing = 16;
+    data->vector = FALSE;
 }
 
 static void
@@ -152,6 +184,9 @@ _adg_get_property(GObject *object, guint prop_id,
     case PROP_ANGLE:
         g_value_set_double(value, data->angle);
         break;
+    case PROP_VECTOR:
+        g_value_set_boolean(value, data->vector);
+        break;
     default:
         G_OBJECT_WARN_INVALID_PROPERTY_ID(object, prop_id, pspec);
         break;
@@ -176,6 +211,10 @@ _adg_set_property(GObject *object, guint prop_id,
         data->angle = g_value_get_double(value);
         adg_fill_style_set_pattern((AdgFillStyle *) object, NULL);
         break;
+    case PROP_VECTOR:
+        data->vector = g_value_get_boolean(value);
+        adg_fill_style_set_pattern((AdgFillStyle *) object, NULL);
+        break;
     default:
         G_OBJECT_WARN_INVALID_PROPERTY_ID(object, prop_id, pspec);
         break;
@@ -309,14 +348,69 @@ adg_ruled_fill_get_angle(AdgRuledFill *ruled_fill)
     return data->angle;
 }
 
+/**
+ * adg_ruled_fill_switch_vector:
+ * @ruled_fill: an #AdgRuledFill
+ * @new_state: the new vector state
+ *
+ * Sets a new status on the #AdgRuledFill:vector property. When
+ * enabled, applying @ruled_fill consumes the current path: the
+ * lines are clipped against its flattened version (using the
+ * tolerance of the cairo context) and stroked straight away, so
+ * the subsequent fill operation becomes a no-op. This avoids the
+ * intermediate surface and keeps the hatch as plain vector data on
+ * PDF and SVG exports.
+ *
+ * The lines have the same density and phase of the ones drawn on
+ * the surface, while the inner region is computed with the even-odd
+ * rule.
+ *
+ * Since: 1.0
+ **/
+void
+adg_ruled_fill_switch_vector(AdgRuledFill *ruled_fill, gboolean new_state)
+{
+    g_return_if_fail(ADG_IS_RULED_FILL(ruled_fill));
+    g_object_set(ruled_fill, "vector", new_state, NULL);
+}
+
+/**
+ * adg_ruled_fill_has_vector:
+ * @ruled_fill: an #AdgRuledFill
+ *
+ * Gets the current status of the #AdgRuledFill:vector property.
+ * See adg_ruled_fill_switch_vector() for details.
+ *
+ * Returns: the current state of the vector flag.
+ *
+ * Since: 1.0
+ **/
+gboolean
+adg_ruled_fill_has_vector(AdgRuledFill *ruled_fill)
+{
+    AdgRuledFillPrivate *data;
+
+    g_return_val_if_fail(ADG_IS_RULED_FILL(ruled_fill), FALSE);
+
+    data = adg_ruled_fill_get_instance_private(ruled_fill);
+    return data->vector;
+}
+
 
 static void
 _adg_apply(AdgStyle *style, AdgEntity *entity, cairo_t *cr)
 {
+    AdgRuledFillPrivate *data;
     AdgFillStyle *fill_style;
     cairo_pattern_t *pattern;
     const CpmlExtents *extents;
 
+    data = adg_ruled_fill_get_instance_private((AdgRuledFill *) style);
+    if (data->vector) {
+        _adg_apply_vector((AdgRuledFill *) style, entity, cr);
+        return;
+    }
+
     fill_style = (AdgFillStyle *) style;
     pattern = adg_fill_style_get_pattern(fill_style);
     extents = adg_fill_style_get_extents(fill_style);
@@ -339,8 +433,18 @@ _adg_apply(AdgStyle *style, AdgEntity *entity, cairo_t *cr)
 static void
 _adg_set_extents(AdgFillStyle *fill_style, const CpmlExtents *extents)
 {
+    AdgRuledFillPrivate *data;
     CpmlExtents old, new;
 
+    data = adg_ruled_fill_get_instance_private((AdgRuledFill *) fill_style);
+
+    /* No pattern to invalidate in vector mode */
+    if (data->vector) {
+        if (_ADG_OLD_FILL_STYLE_CLASS->set_extents)
+            _ADG_OLD_FILL_STYLE_CLASS->set_extents(fill_style, extents);
+        return;
+    }
+
     cpml_extents_copy(&old, adg_fill_style_get_extents(fill_style));
 
     /* The pattern is invalidated (and thus regenerated) only
@@ -466,3 +570,171 @@ _adg_draw_lines(const CpmlPair *spacing, const CpmlPair *size, cairo_t *cr)
 
     cairo_stroke(cr);
 }
+
+
+static void
+_adg_apply_vector(AdgRuledFill *ruled_fill, AdgEntity *entity, cairo_t *cr)
+{
+    AdgRuledFillPrivate *data;
+    cairo_path_t *boundary;
+    GArray *positions;
+    CpmlPair step, dir, normal;
+    gdouble x1, y1, x2, y2;
+    gdouble from, to, pitch, offset;
+
+    data = adg_ruled_fill_get_instance_private(ruled_fill);
+
+    /* The current path is the boundary: it is consumed here, leaving
+     * nothing to fill to the caller. It is flattened with the same
+     * tolerance cairo uses when filling, so only lines are involved */
+    cairo_path_extents(cr, &x1, &y1, &x2, &y2);
+    boundary = cairo_copy_path_flat(cr);
+    cairo_new_path(cr);
+
+    if (data->spacing <= 0 || x1 >= x2 || y1 >= y2) {
+        cairo_path_destroy(boundary);
+        return;
+    }
+
+    /* Same lines drawn by _adg_draw_lines(), that is the ones joining
+     * the (k + 1/2) * step points on both axes: (x / step.x) +
+     * (y / step.y) = k + 1/2, relative to the corner the pattern is
+     * anchored to. Horizontal and vertical steps give no lines. */
+    step.x = cos(data->angle) * data->spacing;
+    step.y = sin(data->angle) * data->spacing;
+    if (step.x < 0 || (step.x == 0 && step.y < 0)) {
+        step.x = -step.x;
+        step.y = -step.y;
+    }
+
+    pitch = step.x * step.y / data->spacing;
+    if (fabs(pitch) < data->spacing * 1e-6) {
+        cairo_path_destroy(boundary);
+        return;
+    }
+
+    normal.x = step.y / data->spacing;
+    normal.y = step.x / data->spacing;
+    if (pitch < 0) {
+        normal.x = -normal.x;
+        normal.y = -normal.y;
+        pitch = -pitch;
+    }
+    dir.x = normal.y;
+    dir.y = -normal.x;
+
+    /* Range of the line offsets (along normal) covering the extents */
+    from = MIN(normal.x * x1, normal.x * x2) + MIN(normal.y * y1, normal.y * y2);
+    to = MAX(normal.x * x1, normal.x * x2) + MAX(normal.y * y1, normal.y * y2);
+
+    /* The first line is half a pitch away from the anchor corner */
+    offset = normal.x * x1 + normal.y * (step.y < 0 ? y2 : y1) + pitch / 2;
+    offset -= floor((offset - from) / pitch) * pitch;
+
+    adg_style_apply(adg_entity_style(entity, data->line_dress), entity, cr);
+    positions = g_array_new(FALSE, FALSE, sizeof(gdouble));
+
+    for (; offset <= to; offset += pitch)
+        _adg_clip_line(&dir, &normal, offset, boundary, positions, cr);
+
+    cairo_stroke(cr);
+
+    g_array_free(positions, TRUE);
+    cairo_path_destroy(boundary);
+}
+
+/* Adds to cr the portions of the line at offset (along normal) inside
+ * boundary, accordingly to the even-odd rule. A point P of the line is
+ * normal * offset + dir * pos, where pos is its position on the line */
+static void
+_adg_clip_line(const CpmlPair *dir, const CpmlPair *normal, gdouble offset,
+               const cairo_path_t *boundary, GArray *positions, cairo_t *cr)
+{
+    const cairo_path_data_t *path_data;
+    CpmlPair start, last, pair;
+    gboolean has_start;
+    gdouble pos, pos2;
+    gint n;
+    guint k;
+
+    g_array_set_size(positions, 0);
+    has_start = FALSE;
+
+    for (n = 0; n < boundary->num_data; n += path_data->header.length) {
+        path_data = &boundary->data[n];
+
+        switch (path_data->header.type) {
+        case CAIRO_PATH_MOVE_TO:
+            /* Open subpaths are implicitly closed when filled */
+            if (has_start)
+                _adg_add_crossing(&last, &start, dir, normal, offset, positions);
+            cpml_pair_from_cairo(&start, &path_data[1]);
+            cpml_pair_copy(&last, &start);
+            has_start = TRUE;
+            break;
+        case CAIRO_PATH_LINE_TO:
+        case CAIRO_PATH_CURVE_TO:
+            /* A flattened path has no curves: just in case,
+             * consider them as lines up to their end point */
+            cpml_pair_from_cairo(&pair, &path_data[path_data->header.length - 1]);
+            if (has_start)
+                _adg_add_crossing(&last, &pair, dir, normal, offset, positions);
+            cpml_pair_copy(&last, &pair);
+            break;
+        case CAIRO_PATH_CLOSE_PATH:
+            if (has_start) {
+                _adg_add_crossing(&last, &start, dir, normal, offset, positions);
+                cpml_pair_copy(&last, &start);
+            }
+            break;
+        }
+    }
+
+    if (has_start)
+        _adg_add_crossing(&last, &start, dir, normal, offset, positions);
+
+    /* Even-odd rule: the line is inside between every couple */
+    g_array_sort(positions, _adg_compare_pos);
+
+    for (k = 1; k < positions->len; k += 2) {
+        pos = g_array_index(positions, gdouble, k - 1);
+        pos2 = g_array_index(positions, gdouble, k);
+        cairo_move_to(cr, normal->x * offset + dir->x * pos,
+                      normal->y * offset + dir->y * pos);
+        cairo_line_to(cr, normal->x * offset + dir->x * pos2,
+                      normal->y * offset + dir->y * pos2);
+    }
+}
+
+/* Appends to positions the position where the p1-p2 edge crosses the
+ * line at offset, if any. The crossing test is half-open: a vertex
+ * lying on the line is considered on its positive side, so a line
+ * touching the boundary in a vertex crosses it twice or never while a
+ * line passing through a vertex crosses it once, as expected */
+static void
+_adg_add_crossing(const CpmlPair *p1, const CpmlPair *p2,
+                  const CpmlPair *dir, const CpmlPair *normal,
+                  gdouble offset, GArray *positions)
+{
+    gdouble d1, d2, t, pos;
+
+    d1 = normal->x * p1->x + normal->y * p1->y - offset;
+    d2 = normal->x * p2->x + normal->y * p2->y - offset;
+
+    if ((d1 < 0) == (d2 < 0))
+        return;
+
+    t = d1 / (d1 - d2);
+    pos = dir->x * (p1->x + (p2->x - p1->x) * t) +
+          dir->y * (p1->y + (p2->y - p1->y) * t);
+    g_array_append_val(positions, pos);
+}
+
+static gint
+_adg_compare_pos(gconstpointer a, gconstpointer b)
+{
+    gdouble pos_a = *(const gdouble *) a;
+    gdouble pos_b = *(const gdouble *) b;
+
+    return pos_a < pos_b ? -1 : pos_a > pos_b ? 1 : 0;
+}
@@ -53,6 +53,7 @@
 #include "adg-internal.h"
 
 #include "adg-style.h"
+#include "adg-entity-private.h"
 
 
 #define _ADG_OLD_OBJECT_CLASS  ((GObjectClass *) adg_style_parent_class)
@@ -67,6 +68,8 @@ enum {
 };
 
 static void             _adg_dispose            (GObject        *object);
+static void             _adg_notify             (GObject        *object,
+                                                 GParamSpec     *pspec);
 static void             _adg_apply              (AdgStyle       *style,
                                                  AdgEntity      *entity,
                                                  cairo_t        *cr);
@@ -81,6 +84,7 @@ adg_style_class_init(AdgStyleClass *klass)
     gobject_class = (GObjectClass *) klass;
 
     gobject_class->dispose = _adg_dispose;
+    gobject_class->notify = _adg_notify;
 
     klass->clone = (AdgStyle *(*)(AdgStyle *)) adg_object_clone;
     klass->invalidate = NULL;
@@ -145,6 +149,16 @@ _adg_dispose(GObject *object)
         _ADG_OLD_OBJECT_CLASS->dispose(object);
 }
 
+static void
+_adg_notify(GObject *object, GParamSpec *pspec)
+{
+    /* The recorded renderings could depend on the old value */
+    _adg_entity_outdate_recordings();
+
+    if (_ADG_OLD_OBJECT_CLASS->notify != NULL)
+        _ADG_OLD_OBJECT_CLASS->notify(object, pspec);
+}
+
 
 /**
  * adg_style_invalidate:
@@ -165,6 +179,7 @@ adg_style_invalidate(AdgStyle *style)
 {
     g_return_if_fail(ADG_IS_STYLE(style));
 
+    _adg_entity_outdate_recordings();
     g_signal_emit(style, _adg_signals[INVALIDATE], 0);
 }
 
@@ -24,15 +24,8 @@
 
 G_BEGIN_DECLS
 
-typedef struct _AdgProxyData AdgProxyData;
 typedef struct _AdgTablePrivate AdgTablePrivate;
 
-struct _AdgProxyData {
-    guint signal_id;
-    GQuark detail;
-    va_list var_args;
-};
-
 struct _AdgTablePrivate {
     AdgDress       table_dress;
     gboolean       has_frame;
@@ -105,14 +105,14 @@ static void         _adg_arrange_frame      (AdgEntity      *entity,
 static void         _adg_render             (AdgEntity      *entity,
                                              cairo_t        *cr);
 static void         _adg_propagate          (AdgTable       *table,
-                                             const gchar    *detailed_signal,
-                                             ...);
+                                             GCallback       callback,
+                                             gpointer        user_data);
 static void         _adg_foreach_row        (AdgTableRow    *table_row,
                                              const AdgClosure *closure);
 static void         _adg_append_frame       (AdgTableCell   *table_cell,
                                              AdgPath        *path);
 static void         _adg_proxy_signal       (AdgTableCell   *table_cell,
-                                             AdgProxyData   *proxy_data);
+                                             const AdgClosure *closure);
 static gboolean     _adg_value_match        (gpointer        key,
                                              gpointer        value,
                                              gpointer        user_data);
@@ -583,7 +583,7 @@ adg_table_invalidate_grid(AdgTable *table)
 static void
 _adg_destroy(AdgEntity *entity)
 {
-    _adg_propagate((AdgTable *) entity, "destroy");
+    _adg_propagate((AdgTable *) entity, G_CALLBACK(adg_entity_destroy), NULL);
 
     if (_ADG_OLD_ENTITY_CLASS->destroy)
         _ADG_OLD_ENTITY_CLASS->destroy(entity);
@@ -595,7 +595,8 @@ _adg_global_changed(AdgEntity *entity)
     if (_ADG_OLD_ENTITY_CLASS->global_changed)
         _ADG_OLD_ENTITY_CLASS->global_changed(entity);
 
-    _adg_propagate((AdgTable *) entity, "global-changed");
+    _adg_propagate((AdgTable *) entity,
+                   G_CALLBACK(adg_entity_global_changed), NULL);
 }
 
 static void
@@ -604,13 +605,14 @@ _adg_local_changed(AdgEntity *entity)
     if (_ADG_OLD_ENTITY_CLASS->local_changed)
         _ADG_OLD_ENTITY_CLASS->local_changed(entity);
 
-    _adg_propagate((AdgTable *) entity, "local-changed");
+    _adg_propagate((AdgTable *) entity,
+                   G_CALLBACK(adg_entity_local_changed), NULL);
 }
 
 static void
 _adg_invalidate(AdgEntity *entity)
 {
-    _adg_propagate((AdgTable *) entity, "invalidate");
+    _adg_propagate((AdgTable *) entity, G_CALLBACK(adg_entity_invalidate), NULL);
 }
 
 static void
@@ -734,38 +736,25 @@ _adg_render(AdgEntity *entity, cairo_t *cr)
 
     adg_style_apply((AdgStyle *) data->table_style, entity, cr);
 
-    _adg_propagate((AdgTable *) entity, "render", cr);
+    _adg_propagate((AdgTable *) entity, G_CALLBACK(adg_entity_render), cr);
 }
 
 static void
-_adg_propagate(AdgTable *table, const gchar *detailed_signal, ...)
+_adg_propagate(AdgTable *table, GCallback callback, gpointer user_data)
 {
-    va_list var_copy;
-    AdgTablePrivate *data;
-    AdgProxyData proxy_data;
-
-    if (!g_signal_parse_name(detailed_signal, G_TYPE_FROM_INSTANCE(table),
-                             &proxy_data.signal_id, &proxy_data.detail, FALSE)) {
-        g_return_if_reached();
-    }
-
-    va_start(proxy_data.var_args, detailed_signal);
-    data = adg_table_get_instance_private(table);
+    AdgTablePrivate *data = adg_table_get_instance_private(table);
+    AdgClosure closure = { callback, user_data };
 
-    if (data->frame) {
-        G_VA_COPY(var_copy, proxy_data.var_args);
-        g_signal_emit_valist(data->frame, proxy_data.signal_id,
-                             proxy_data.detail, var_copy);
-    }
+    /* Calling the adg_entity_...() API directly instead of emitting
+     * the signals by name avoids parsing the signal name every time
+     * and leaves to AdgEntity the choice of the dispatch method */
+    if (data->frame)
+        ((void (*) (gpointer, gpointer)) callback) (data->frame, user_data);
 
-    if (data->grid) {
-        G_VA_COPY(var_copy, proxy_data.var_args);
-        g_signal_emit_valist(data->grid, proxy_data.signal_id,
-                             proxy_data.detail, var_copy);
-    }
+    if (data->grid)
+        ((void (*) (gpointer, gpointer)) callback) (data->grid, user_data);
 
-    adg_table_foreach_cell(table, (GCallback) _adg_proxy_signal, &proxy_data);
-    va_end(proxy_data.var_args);
+    adg_table_foreach_cell(table, (GCallback) _adg_proxy_signal, &closure);
 }
 
 static void
@@ -797,26 +786,21 @@ _adg_append_frame(AdgTableCell *table_cell, AdgPath *path)
 }
 
 static void
-_adg_proxy_signal(AdgTableCell *table_cell, AdgProxyData *proxy_data)
+_adg_proxy_signal(AdgTableCell *table_cell, const AdgClosure *closure)
 {
     AdgEntity *entity;
-    AdgAlignment *alignment;
-    va_list var_copy;
+    AdgEntity *alignment;
 
     entity = adg_table_cell_title(table_cell);
     if (entity) {
-        alignment = (AdgAlignment *) adg_entity_get_parent(entity);
-        G_VA_COPY(var_copy, proxy_data->var_args);
-        g_signal_emit_valist(alignment, proxy_data->signal_id,
-                             proxy_data->detail, var_copy);
+        alignment = adg_entity_get_parent(entity);
+        ((void (*) (gpointer, gpointer)) closure->callback) (alignment, closure->user_data);
     }
 
     entity = adg_table_cell_value(table_cell);
     if (entity) {
-        alignment = (AdgAlignment *) adg_entity_get_parent(entity);
-        G_VA_COPY(var_copy, proxy_data->var_args);
-        g_signal_emit_valist(alignment, proxy_data->signal_id,
-                             proxy_data->detail, var_copy);
+        alignment = adg_entity_get_parent(entity);
+        ((void (*) (gpointer, gpointer)) closure->callback) (alignment, closure->user_data);
     }
 }
 
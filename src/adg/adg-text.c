@@ -144,6 +144,7 @@ adg_text_init(AdgText *text)
     data->font_dress = ADG_DRESS_FONT_TEXT;
     data->text = NULL;
     data->layout = NULL;
+    data->raw_extents.is_defined = FALSE;
     adg_entity_set_local_mix((AdgEntity *) text, ADG_MIX_ANCESTORS_NORMALIZED);
 }
 
@@ -262,6 +263,7 @@ _adg_arrange(AdgEntity *entity)
 {
     AdgText *text = (AdgText *) entity;
     AdgTextPrivate *data = adg_text_get_instance_private(text);
+    AdgPangoStyle *pango_style;
     PangoRectangle size;
 
     if (adg_is_string_empty(data->text)) {
@@ -271,53 +273,16 @@ _adg_arrange(AdgEntity *entity)
         adg_entity_set_extents(entity, &new_extents);
         _adg_clear_layout(text);
         return;
-    } else if (data->layout != NULL) {
+    } else if (data->raw_extents.is_defined) {
         /* Cached result */
         return;
     }
 
-    if (data->layout == NULL) {
-        static PangoFontMap *font_map = NULL;
-        AdgDress dress;
-        AdgPangoStyle *pango_style;
-        PangoFontDescription *font_description;
-        cairo_font_options_t *options;
-        PangoContext *context;
-
-        /* Keep around the font_map object. The rationale is:
-         * https://bugzilla.gnome.org/show_bug.cgi?id=143542
-         *
-         * Basically, PangoFontMap is a heavy object and
-         * creating/destroying it is not the right thing to do.
-         *
-         * In reality, the blocking issue for me was the following
-         * line makes the adg-demo program crash on MinGW32:
-         * g_object_unref(font_map);
-         */
-        if (font_map == NULL)
-            font_map = pango_cairo_font_map_new();
-
-        dress = data->font_dress;
-        pango_style = (AdgPangoStyle *) adg_entity_style(entity, dress);
-        font_description = adg_pango_style_get_description(pango_style);
-
-        context = pango_context_new();
-        pango_context_set_font_map(context, font_map);
-        pango_cairo_context_set_resolution(context, 72);
-
-        options = adg_font_style_new_options((AdgFontStyle *) pango_style);
-        pango_cairo_context_set_font_options(context, options);
-        cairo_font_options_destroy(options);
-
-        data->layout = pango_layout_new(context);
-        g_object_unref(context);
-
-        pango_layout_set_spacing(data->layout, adg_pango_style_get_spacing(pango_style));
-        pango_layout_set_text(data->layout, data->text, -1);
-        pango_layout_set_font_description(data->layout, font_description);
-    }
-
-    pango_layout_get_extents(data->layout, NULL, &size);
+    /* The layout is built only when needed by _adg_render(): the
+     * extents are measured (and cached) by the pango style itself */
+    pango_style = (AdgPangoStyle *) adg_entity_style(entity, data->font_dress);
+    if (! adg_pango_style_put_text_extents(pango_style, data->text, &size))
+        return;
 
     data->raw_extents.org.x = pango_units_to_double(size.x);
     data->raw_extents.org.y = pango_units_to_double(size.y);
@@ -334,18 +299,26 @@ _adg_render(AdgEntity *entity, cairo_t *cr)
     AdgText *text = (AdgText *) entity;
     AdgTextPrivate *data = adg_text_get_instance_private(text);
 
-    if (data->layout != NULL) {
-        adg_entity_apply_dress(entity, data->font_dress, cr);
-        cairo_transform(cr, adg_entity_get_global_matrix(entity));
-        cairo_transform(cr, adg_entity_get_local_matrix(entity));
+    if (! data->raw_extents.is_defined)
+        return;
 
-        /* Realign the text to follow the cairo toy text convention:
-         * use bottom/left corner as reference (pango uses top/left). */
-        cairo_translate(cr, 0, -data->raw_extents.size.y);
+    if (data->layout == NULL) {
+        AdgPangoStyle *pango_style;
 
-        pango_cairo_update_layout(cr, data->layout);
-        pango_cairo_show_layout(cr, data->layout);
+        pango_style = (AdgPangoStyle *) adg_entity_style(entity, data->font_dress);
+        data->layout = adg_pango_style_new_layout(pango_style, data->text);
     }
+
+    adg_entity_apply_dress(entity, data->font_dress, cr);
+    cairo_transform(cr, adg_entity_get_global_matrix(entity));
+    cairo_transform(cr, adg_entity_get_local_matrix(entity));
+
+    /* Realign the text to follow the cairo toy text convention:
+     * use bottom/left corner as reference (pango uses top/left). */
+    cairo_translate(cr, 0, -data->raw_extents.size.y);
+
+    pango_cairo_update_layout(cr, data->layout);
+    pango_cairo_show_layout(cr, data->layout);
 }
 
 static void
@@ -409,4 +382,6 @@ _adg_clear_layout(AdgText *text)
         g_object_unref(data->layout);
         data->layout = NULL;
     }
+
+    data->raw_extents.is_defined = FALSE;
 }
@@ -263,7 +263,9 @@ _adg_arrange(AdgEntity *entity)
         adg_matrix_transform(&ctm, adg_entity_get_local_matrix(entity),
                              ADG_TRANSFORM_BEFORE);
 
+        /* The font style can drop this font from its cache at any time */
         data->font = adg_font_style_get_scaled_font(font_style, &ctm);
+        cairo_scaled_font_reference(data->font);
     }
 
     if (adg_is_string_empty(data->text)) {
@@ -344,7 +346,11 @@ static void
 _adg_clear_font(AdgToyText *toy_text)
 {
     AdgToyTextPrivate *data = adg_toy_text_get_instance_private(toy_text);
-    data->font = NULL;
+
+    if (data->font != NULL) {
+        cairo_scaled_font_destroy(data->font);
+        data->font = NULL;
+    }
 }
 
 static void
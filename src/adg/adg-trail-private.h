@@ -24,8 +24,15 @@
 
 G_BEGIN_DECLS
 
+typedef struct _AdgTrailSegment AdgTrailSegment;
 typedef struct _AdgTrailPrivate AdgTrailPrivate;
 
+struct _AdgTrailSegment {
+    CpmlSegment         segment;
+    CpmlExtents         extents;
+    gdouble             length;
+};
+
 struct _AdgTrailPrivate {
     cairo_path_t        cairo_path;
     AdgTrailCallback    callback;
@@ -34,6 +41,7 @@ struct _AdgTrailPrivate {
 
     gboolean            in_construction;
     CpmlExtents         extents;
+    GArray             *segments;
 };
 
 G_END_DECLS
@@ -51,8 +51,10 @@
  * @get_cairo_path: virtual method to get the #cairo_path_t bound to the trail.
  *
  * The default @get_cairo_path calls the #AdgTrailCallback callback passed
- * to adg_trail_new() during construction. No caching is performed in
- * between.
+ * to adg_trail_new() during construction. The path itself is not cached,
+ * but the data derived from it (the segment index used by
+ * adg_trail_put_segment() and friends and the extents) is kept until the
+ * next adg_model_clear(): see #AdgTrailCallback for the implications.
  *
  * Since: 1.0
  **/
@@ -67,6 +69,13 @@
  * the returned path, that is the finalization of the returned
  * #cairo_path_t should be made by the caller when appropriate.
  *
+ * The segment index and the extents of the trail point into the path
+ * returned by this callback and are kept until the next
+ * adg_model_clear(). Whenever the callback would return a different
+ * path, or the data of the returned path is modified or released,
+ * adg_model_clear() must be called on the trail first: otherwise
+ * the trail would refer to stale or freed data.
+ *
  * Returns: the #cairo_path_t of this trail model
  *
  * Since: 1.0
@@ -106,6 +115,9 @@ static void             _adg_set_property       (GObject        *object,
                                                  GParamSpec     *pspec);
 static void             _adg_clear              (AdgModel       *model);
 static cairo_path_t *   _adg_get_cairo_path     (AdgTrail       *trail);
+static GArray *         _adg_get_segments       (AdgTrail       *trail);
+static AdgTrailSegment *_adg_nth_segment        (AdgTrail       *trail,
+                                                 guint           n_segment);
 static GArray *         _adg_arc_to_curves      (GArray         *array,
                                                  const cairo_path_data_t *src,
                                                  gdouble         max_angle);
@@ -149,6 +161,7 @@ adg_trail_init(AdgTrail *trail)
     data->max_angle = G_PI_2;
     data->in_construction = FALSE;
     data->extents.is_defined = FALSE;
+    data->segments = NULL;
 }
 
 static void
@@ -201,8 +214,11 @@ _adg_set_property(GObject *object, guint prop_id,
  * @user_data: generic pointer to pass to the callback
  *
  * Creates a new trail model. The #cairo_path_t must be constructed by
- * the @callback function: #AdgTrail will not cache anything, so you
+ * the @callback function: #AdgTrail will not cache the path, so you
  * should implement any caching mechanism in the callback, if needed.
+ * Anyway, the data derived from the path is cached, so
+ * adg_model_clear() must be called on the trail whenever the path
+ * returned by @callback changes (see #AdgTrailCallback).
  *
  * Returns: (transfer full): a new trail model.
  *
@@ -345,21 +361,12 @@ adg_trail_cairo_path(AdgTrail *trail)
 guint
 adg_trail_n_segments(AdgTrail *trail)
 {
-    cairo_path_t *cairo_path;
-    CpmlSegment iterator;
-    guint n;
+    GArray *segments;
 
     g_return_val_if_fail(ADG_IS_TRAIL(trail), 0);
 
-    cairo_path = adg_trail_cairo_path(trail);
-
-    n = 0;
-    if (! EMPTY_PATH(cairo_path) && cpml_segment_from_cairo(&iterator, cairo_path)) {
-        for (n = 1; cpml_segment_next(&iterator); ++n) {
-        }
-    }
-
-    return n;
+    segments = _adg_get_segments(trail);
+    return segments != NULL ? segments->len : 0;
 }
 
 /**
@@ -372,6 +379,9 @@ adg_trail_n_segments(AdgTrail *trail)
  * got from the cairo path: check out adg_trail_cairo_path() for
  * further information.
  *
+ * The segment boundaries are indexed the first time they are needed,
+ * so this is an O(1) operation until the next adg_model_clear().
+ *
  * When the segment is not found, either because @n_segment is out
  * of range or because there is still no path bound to @trail, this
  * function will return <constant>FALSE</constant> leaving @segment
@@ -385,30 +395,73 @@ adg_trail_n_segments(AdgTrail *trail)
 gboolean
 adg_trail_put_segment(AdgTrail *trail, guint n_segment, CpmlSegment *segment)
 {
-    cairo_path_t *cairo_path;
-    gboolean found;
-    CpmlSegment iterator;
-    guint cnt;
+    AdgTrailSegment *entry;
 
     g_return_val_if_fail(ADG_IS_TRAIL(trail), FALSE);
 
-    if (n_segment == 0) {
-        g_warning(_("%s: requested undefined segment for type '%s'"),
-                  G_STRLOC, g_type_name(G_OBJECT_TYPE(trail)));
+    entry = _adg_nth_segment(trail, n_segment);
+    if (entry == NULL)
         return FALSE;
-    }
 
-    cairo_path = adg_trail_cairo_path(trail);
-    found = ! EMPTY_PATH(cairo_path) &&
-        cpml_segment_from_cairo(&iterator, cairo_path);
+    if (segment != NULL)
+        cpml_segment_copy(segment, &entry->segment);
 
-    for (cnt = 1; found && cnt < n_segment; ++cnt)
-        found = cpml_segment_next(&iterator);
+    return TRUE;
+}
 
-    if (found && segment != NULL)
-        cpml_segment_copy(segment, &iterator);
+/**
+ * adg_trail_get_segment_extents:
+ * @trail: an #AdgTrail
+ * @n_segment: the segment to inspect, where 1 is the first segment
+ *
+ * Gets the extents of the @n_segment segment of @trail. The extents
+ * are computed together with the segment index, so no further path
+ * scanning is needed. The returned pointer is owned by @trail and
+ * should not be freed nor modified.
+ *
+ * Returns: the requested extents or <constant>NULL</constant> on errors.
+ *
+ * Since: 1.0
+ **/
+const CpmlExtents *
+adg_trail_get_segment_extents(AdgTrail *trail, guint n_segment)
+{
+    AdgTrailSegment *entry;
+
+    g_return_val_if_fail(ADG_IS_TRAIL(trail), NULL);
 
-    return found;
+    entry = _adg_nth_segment(trail, n_segment);
+    return entry != NULL ? &entry->extents : NULL;
+}
+
+/**
+ * adg_trail_get_segment_length:
+ * @trail: an #AdgTrail
+ * @n_segment: the segment to inspect, where 1 is the first segment
+ *
+ * Gets the length of the @n_segment segment of @trail, as returned
+ * by cpml_segment_get_length(). The value is computed on the first
+ * request and cached until the next adg_model_clear().
+ *
+ * Returns: the requested length or 0 on errors.
+ *
+ * Since: 1.0
+ **/
+gdouble
+adg_trail_get_segment_length(AdgTrail *trail, guint n_segment)
+{
+    AdgTrailSegment *entry;
+
+    g_return_val_if_fail(ADG_IS_TRAIL(trail), 0);
+
+    entry = _adg_nth_segment(trail, n_segment);
+    if (entry == NULL)
+        return 0;
+
+    if (entry->length < 0)
+        entry->length = cpml_segment_get_length(&entry->segment);
+
+    return entry->length;
 }
 
 /**
@@ -432,18 +485,12 @@ adg_trail_get_extents(AdgTrail *trail)
     data = adg_trail_get_instance_private(trail);
 
     if (!data->extents.is_defined) {
-        cairo_path_t *cairo_path;
-        CpmlSegment segment;
-        CpmlExtents extents;
-
-        cairo_path = adg_trail_cairo_path(trail);
-        if (! EMPTY_PATH(cairo_path) &&
-            cpml_segment_from_cairo(&segment, cairo_path)) {
-            do {
-                cpml_segment_put_extents(&segment, &extents);
-                cpml_extents_add(&data->extents, &extents);
-            } while (cpml_segment_next(&segment));
-        }
+        GArray *segments = _adg_get_segments(trail);
+        guint n;
+
+        for (n = 0; segments != NULL && n < segments->len; ++n)
+            cpml_extents_add(&data->extents,
+                             &g_array_index(segments, AdgTrailSegment, n).extents);
     }
 
     return &data->extents;
@@ -546,6 +593,11 @@ _adg_clear(AdgModel *model)
     data->cairo_path.num_data = 0;
     data->extents.is_defined = FALSE;
 
+    if (data->segments != NULL) {
+        g_array_free(data->segments, TRUE);
+        data->segments = NULL;
+    }
+
     if (_ADG_OLD_MODEL_CLASS->clear)
         _ADG_OLD_MODEL_CLASS->clear(model);
 }
@@ -564,6 +616,52 @@ _adg_get_cairo_path(AdgTrail *trail)
     return data->callback(trail, data->user_data);
 }
 
+static GArray *
+_adg_get_segments(AdgTrail *trail)
+{
+    AdgTrailPrivate *data = adg_trail_get_instance_private(trail);
+    cairo_path_t *cairo_path;
+    AdgTrailSegment entry;
+
+    if (data->segments != NULL)
+        return data->segments;
+
+    cairo_path = adg_trail_cairo_path(trail);
+    if (EMPTY_PATH(cairo_path) ||
+        ! cpml_segment_from_cairo(&entry.segment, cairo_path))
+        return NULL;
+
+    /* A single pass over the path collects the segment boundaries
+     * and their extents: the lengths are left to be computed
+     * on demand because they are seldom needed */
+    data->segments = g_array_new(FALSE, FALSE, sizeof(AdgTrailSegment));
+    do {
+        cpml_segment_put_extents(&entry.segment, &entry.extents);
+        entry.length = -1;
+        g_array_append_val(data->segments, entry);
+    } while (cpml_segment_next(&entry.segment));
+
+    return data->segments;
+}
+
+static AdgTrailSegment *
+_adg_nth_segment(AdgTrail *trail, guint n_segment)
+{
+    GArray *segments;
+
+    if (n_segment == 0) {
+        g_warning(_("%s: requested undefined segment for type '%s'"),
+                  G_STRLOC, g_type_name(G_OBJECT_TYPE(trail)));
+        return NULL;
+    }
+
+    segments = _adg_get_segments(trail);
+    if (segments == NULL || n_segment > segments->len)
+        return NULL;
+
+    return &g_array_index(segments, AdgTrailSegment, n_segment - 1);
+}
+
 static GArray *
 _adg_arc_to_curves(GArray *array, const cairo_path_data_t *src,
                    gdouble max_angle)
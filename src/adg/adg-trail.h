@@ -66,6 +66,12 @@ guint               adg_trail_n_segments        (AdgTrail        *trail);
 gboolean            adg_trail_put_segment       (AdgTrail        *trail,
                                                  guint            n_segment,
                                                  CpmlSegment     *segment);
+const CpmlExtents * adg_trail_get_segment_extents
+                                                (AdgTrail        *trail,
+                                                 guint            n_segment);
+gdouble             adg_trail_get_segment_length
+                                                (AdgTrail        *trail,
+                                                 guint            n_segment);
 const CpmlExtents * adg_trail_get_extents       (AdgTrail        *trail);
 void                adg_trail_dump              (AdgTrail        *trail);
 void                adg_trail_set_max_angle     (AdgTrail        *trail,
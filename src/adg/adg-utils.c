@@ -270,9 +270,9 @@ adg_string_replace(const gchar *str, const gchar *from, const gchar *to)
 const gchar *
 _adg_dgettext(const gchar *domain, const gchar *msgid)
 {
-    static gboolean initialized = FALSE;
+    static gsize initialized = 0;
 
-    if (G_UNLIKELY(!initialized)) {
+    if (g_once_init_enter(&initialized)) {
 #ifdef G_OS_UNIX
         bindtextdomain(GETTEXT_PACKAGE, LOCALEDIR);
 #else
@@ -283,7 +283,7 @@ _adg_dgettext(const gchar *domain, const gchar *msgid)
         g_free(path);
 #endif
         bind_textdomain_codeset(GETTEXT_PACKAGE, "UTF-8");
-        initialized = TRUE;
+        g_once_init_leave(&initialized, 1);
     }
 
     return g_dgettext(domain, msgid);
@@ -374,6 +374,47 @@ adg_find_file(const gchar *file, ...)
     return NULL;
 }
 
+/**
+ * adg_scale_parse:
+ * @scale: a string identifying the scale
+ * @numerator: (out) (allow-none): where to store the numerator
+ * @denominator: (out) (allow-none): where to store the denominator
+ *
+ * Splits a scale in the form x:y into its numerator x and its
+ * denominator y. The same rules explained in adg_scale_factor()
+ * apply: any garbage following x or y is silently ignored and
+ * the :y postfix can be omitted, in which case @denominator is 1.
+ *
+ * The numbers are converted with g_ascii_strtod(), so the
+ * decimal separator is always the dot regardless of the current
+ * locale. No global state is touched, hence this function can be
+ * safely called from multiple threads.
+ *
+ * Returns: <constant>TRUE</constant> if @scale has been parsed to a valid fraction, <constant>FALSE</constant> otherwise.
+ *
+ * Since: 1.0
+ **/
+gboolean
+adg_scale_parse(const gchar *scale, gdouble *numerator, gdouble *denominator)
+{
+    gdouble x, y;
+    const gchar *ptr;
+
+    g_return_val_if_fail(scale != NULL, FALSE);
+
+    x = g_ascii_strtod(scale, NULL);
+
+    ptr = strchr(scale, ':');
+    y = ptr == NULL ? 1 : g_ascii_strtod(ptr + 1, NULL);
+
+    if (numerator != NULL)
+        *numerator = x;
+    if (denominator != NULL)
+        *denominator = y;
+
+    return y != 0;
+}
+
 /**
  * adg_scale_factor:
  * @scale: a string identifying the scale
@@ -385,8 +426,8 @@ adg_find_file(const gchar *file, ...)
  * x+garbage:y+garbage is equivalent to x:y. Furthermore, the postfix
  * :y can be omitted, in which case (double) x will be returned.
  *
- * x and y are converted by using atof(), so refer to your C library
- * documentation for details on the algorithm used.
+ * x and y are converted by using adg_scale_parse(), so the parsing
+ * is locale independent and thread safe.
  *
  * Returns: the (possibly approximated) double conversion of @scale or 0 on errors.
  *
@@ -396,22 +437,10 @@ gdouble
 adg_scale_factor(const gchar *scale)
 {
     gdouble numerator, denominator;
-    const gchar *ptr;
-    gchar *orig;
 
     g_return_val_if_fail(scale != NULL, 0);
 
-    orig = setlocale(LC_NUMERIC, NULL);
-    setlocale(LC_NUMERIC, "C");
-
-    numerator = atof(scale);
-
-    ptr = strchr(scale, ':');
-    denominator = ptr == NULL ? 1 : atof(ptr + 1);
-
-    setlocale(LC_NUMERIC, orig);
-
-    if (denominator == 0)
+    if (!adg_scale_parse(scale, &numerator, &denominator))
         return 0;
 
     return numerator / denominator;
@@ -56,6 +56,9 @@ gchar *                 adg_string_replace      (const gchar    *str,
                                                  const gchar    *to);
 gchar *                 adg_find_file           (const gchar    *file,
                                                  ...);
+gboolean                adg_scale_parse         (const gchar    *scale,
+                                                 gdouble        *numerator,
+                                                 gdouble        *denominator);
 gdouble                 adg_scale_factor        (const gchar    *scale);
 cairo_surface_type_t    adg_type_from_filename  (const gchar    *file);
 GObject *               adg_object_clone        (GObject        *src);
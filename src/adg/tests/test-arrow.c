@@ -87,6 +87,32 @@ _adg_property_angle(void)
     adg_entity_destroy((AdgEntity *) arrow);
 }
 
+static void
+_adg_method_model(void)
+{
+    AdgArrow *arrow1, *arrow2;
+    AdgModel *model;
+
+    arrow1 = adg_arrow_new();
+    arrow2 = adg_arrow_new();
+
+    /* Arrows with the same angle share the same model */
+    model = adg_marker_model(ADG_MARKER(arrow1));
+    g_assert_nonnull(model);
+    g_assert_true(adg_marker_model(ADG_MARKER(arrow2)) == model);
+
+    /* Changing the angle changes the model */
+    adg_arrow_set_angle(arrow2, G_PI_2);
+    g_assert_nonnull(adg_marker_model(ADG_MARKER(arrow2)));
+    g_assert_true(adg_marker_model(ADG_MARKER(arrow2)) != model);
+
+    adg_arrow_set_angle(arrow2, G_PI / 6);
+    g_assert_true(adg_marker_model(ADG_MARKER(arrow2)) == model);
+
+    adg_entity_destroy(ADG_ENTITY(arrow1));
+    adg_entity_destroy(ADG_ENTITY(arrow2));
+}
+
 
 int
 main(int argc, char *argv[])
@@ -99,5 +125,7 @@ main(int argc, char *argv[])
     g_test_add_func("/adg/arrow/property/local-mix", _adg_property_local_mix);
     g_test_add_func("/adg/arrow/property/angle", _adg_property_angle);
 
+    g_test_add_func("/adg/arrow/method/model", _adg_method_model);
+
     return g_test_run();
 }
@@ -0,0 +1,290 @@
+/* ADG - Automatic Drawing Generation
+ * Copyright (C) 2007-2020  Nicola Fontana <ntd at entidi.it>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA  02110-1301, USA.
+ */
+
+
+/* Benchmarks on procedurally generated drawings.
+ *
+ * Every test builds a canvas with n parts, loosely modeled on the
+ * piston of adg-demo: each part has its own body (with fillets and
+ * chamfers), an hatched hole, linear, angular and radial dimensions
+ * and a row in a bill of materials table. The canvas also has a
+ * title block with logo and projection.
+ *
+ * Without the perf mode only a tiny drawing is processed, just to
+ * check the code paths. Run `make perf-report` (or the test program
+ * with `-m perf`) to get the timings of the bigger drawings: every
+ * phase is reported with g_test_minimized_result(), so the results
+ * end up in the machine readable gtester log (perf-report.xml).
+ */
+
+#include <adg-test.h>
+#include <adg.h>
+#include <glib/gstdio.h>
+
+#ifdef G_OS_UNIX
+#include <sys/resource.h>
+#endif
+
+
+static void
+_adg_bench_add_part(AdgContainer *container, gdouble x, gdouble y)
+{
+    AdgContainer *part;
+    AdgPath *body, *hole;
+    AdgModel *model;
+    AdgEntity *entity;
+    cairo_matrix_t map;
+
+    body = adg_path_new();
+    model = ADG_MODEL(body);
+
+    adg_path_move_to_explicit(body, 0, 10);
+    adg_model_set_named_pair_explicit(model, "D1I", 0, 10);
+    adg_path_line_to_explicit(body, 20, 10);
+    adg_model_set_named_pair_explicit(model, "D1F", 20, 10);
+    adg_path_line_to_explicit(body, 22, 6);
+    adg_model_set_named_pair_explicit(model, "D2I", 22, 6);
+    adg_path_fillet(body, 0.5);
+    adg_path_line_to_explicit(body, 50, 6);
+    adg_model_set_named_pair_explicit(model, "D2F", 50, 6);
+    adg_path_chamfer(body, 1, 1);
+    adg_path_line_to_explicit(body, 50, 0);
+    adg_model_set_named_pair_explicit(model, "East", 50, 0);
+    adg_model_set_named_pair_explicit(model, "West", 0, 0);
+    adg_model_set_named_pair_explicit(model, "RC", 35, 0);
+    adg_model_set_named_pair_explicit(model, "RR", 38, 0);
+    adg_model_set_named_pair_explicit(model, "RP", 45, -15);
+    adg_path_reflect(body, NULL);
+    adg_path_join(body);
+    adg_path_close(body);
+
+    hole = adg_path_new();
+    adg_path_move_to_explicit(hole, 5, -3);
+    adg_path_line_to_explicit(hole, 15, -3);
+    adg_path_arc_to_explicit(hole, 17, 0, 15, 3);
+    adg_path_line_to_explicit(hole, 5, 3);
+    adg_path_close(hole);
+
+    part = adg_container_new();
+    cairo_matrix_init_translate(&map, x, y);
+    adg_entity_set_local_map(ADG_ENTITY(part), &map);
+
+    entity = ADG_ENTITY(adg_stroke_new(ADG_TRAIL(body)));
+    adg_container_add(part, entity);
+
+    entity = ADG_ENTITY(adg_hatch_new(ADG_TRAIL(hole)));
+    adg_container_add(part, entity);
+
+    entity = ADG_ENTITY(adg_stroke_new(ADG_TRAIL(hole)));
+    adg_container_add(part, entity);
+
+    entity = ADG_ENTITY(adg_ldim_new_full_from_model(model, "D1I", "D2F",
+                                                     "D1I", ADG_DIR_UP));
+    adg_container_add(part, entity);
+
+    entity = ADG_ENTITY(adg_ldim_new_full_from_model(model, "D1I", "-D1I",
+                                                     "West", ADG_DIR_LEFT));
+    adg_dim_set_limits(ADG_DIM(entity), "-0.05", "+0.05");
+    adg_container_add(part, entity);
+
+    entity = ADG_ENTITY(adg_adim_new_full_from_model(model, "D1F", "D1I",
+                                                     "D2I", "D1F", "D1F"));
+    adg_container_add(part, entity);
+
+    entity = ADG_ENTITY(adg_rdim_new_full_from_model(model, "RC", "RR", "RP"));
+    adg_container_add(part, entity);
+
+    adg_container_add(container, ADG_ENTITY(part));
+
+    g_object_unref(body);
+    g_object_unref(hole);
+}
+
+static AdgCanvas *
+_adg_bench_canvas(gint n_parts)
+{
+    AdgCanvas *canvas;
+    AdgTitleBlock *title_block;
+    AdgTable *table;
+    AdgTableRow *row;
+    AdgTableCell *cell;
+    cairo_matrix_t map;
+    gchar *text;
+    gint n;
+
+    canvas = adg_canvas_new();
+    title_block = adg_title_block_new();
+    g_object_set(title_block,
+                 "title", "BENCHMARK",
+                 "author", "ADG",
+                 "date", "",
+                 "drawing", "BENCH",
+                 "scale", "1:1",
+                 "size", "A4",
+                 "logo", adg_logo_new(),
+                 "projection", adg_projection_new(ADG_PROJECTION_SCHEME_FIRST_ANGLE),
+                 NULL);
+    adg_canvas_set_title_block(canvas, title_block);
+    g_object_unref(title_block);
+
+    for (n = 0; n < n_parts; ++n)
+        _adg_bench_add_part(ADG_CONTAINER(canvas),
+                            (n % 10) * 80, (n / 10) * 50);
+
+    /* Bill of materials, one row per part */
+    table = adg_table_new();
+    cairo_matrix_init_translate(&map, 820, 0);
+    adg_entity_set_local_map(ADG_ENTITY(table), &map);
+    for (n = 0; n < n_parts; ++n) {
+        row = adg_table_row_new(table);
+
+        text = g_strdup_printf("%d", n + 1);
+        cell = adg_table_cell_new_full(row, 15, NULL, NULL, TRUE);
+        adg_table_cell_set_text_value(cell, text);
+        g_free(text);
+
+        cell = adg_table_cell_new_full(row, 60, NULL, NULL, TRUE);
+        adg_table_cell_set_text_value(cell, "PISTON");
+
+        text = g_strdup_printf("BENCH-%04d", n + 1);
+        cell = adg_table_cell_new_full(row, 40, NULL, NULL, TRUE);
+        adg_table_cell_set_text_value(cell, text);
+        g_free(text);
+    }
+    adg_container_add(ADG_CONTAINER(canvas), ADG_ENTITY(table));
+
+    return canvas;
+}
+
+static void
+_adg_bench_export(AdgCanvas *canvas, gint n_parts,
+                  cairo_surface_type_t type, const gchar *name)
+{
+    gchar *basename, *file;
+    gdouble elapsed;
+    gboolean result;
+
+    basename = g_strdup_printf("adg-bench-%d.%s", n_parts, name);
+    file = g_build_filename(g_get_tmp_dir(), basename, NULL);
+    g_free(basename);
+
+    g_test_timer_start();
+    result = adg_canvas_export(canvas, type, file, NULL);
+    elapsed = g_test_timer_elapsed();
+
+    g_assert_true(result);
+    g_test_minimized_result(elapsed, "export-%s %d parts: %g s",
+                            name, n_parts, elapsed);
+
+    g_unlink(file);
+    g_free(file);
+}
+
+static void
+_adg_bench(gconstpointer user_data)
+{
+    gint n_parts;
+    AdgCanvas *canvas;
+    AdgEntity *entity;
+    cairo_t *cr;
+    gdouble elapsed;
+
+    n_parts = GPOINTER_TO_INT(user_data);
+
+    g_test_timer_start();
+    canvas = _adg_bench_canvas(n_parts);
+    elapsed = g_test_timer_elapsed();
+    g_test_minimized_result(elapsed, "build %d parts: %g s", n_parts, elapsed);
+
+    entity = ADG_ENTITY(canvas);
+
+    /* Cold arrange, with no cache filled in */
+    g_test_timer_start();
+    adg_entity_arrange(entity);
+    elapsed = g_test_timer_elapsed();
+    g_test_minimized_result(elapsed, "arrange %d parts: %g s", n_parts, elapsed);
+    g_assert_true(adg_entity_get_extents(entity)->is_defined);
+
+    /* Arrange after invalidating the whole drawing */
+    adg_entity_invalidate(entity);
+    g_test_timer_start();
+    adg_entity_arrange(entity);
+    elapsed = g_test_timer_elapsed();
+    g_test_minimized_result(elapsed, "rearrange %d parts: %g s", n_parts, elapsed);
+
+    cr = adg_test_cairo_context();
+    g_test_timer_start();
+    adg_entity_render(entity, cr);
+    elapsed = g_test_timer_elapsed();
+    g_test_minimized_result(elapsed, "render %d parts: %g s", n_parts, elapsed);
+    g_assert_cmpint(cairo_status(cr), ==, CAIRO_STATUS_SUCCESS);
+    cairo_destroy(cr);
+
+#ifdef CAIRO_HAS_PNG_FUNCTIONS
+    _adg_bench_export(canvas, n_parts, CAIRO_SURFACE_TYPE_IMAGE, "png");
+#endif
+#ifdef CAIRO_HAS_PDF_SURFACE
+    _adg_bench_export(canvas, n_parts, CAIRO_SURFACE_TYPE_PDF, "pdf");
+#endif
+#ifdef CAIRO_HAS_SVG_SURFACE
+    _adg_bench_export(canvas, n_parts, CAIRO_SURFACE_TYPE_SVG, "svg");
+#endif
+
+    g_test_timer_start();
+    adg_entity_destroy(entity);
+    elapsed = g_test_timer_elapsed();
+    g_test_minimized_result(elapsed, "destroy %d parts: %g s", n_parts, elapsed);
+
+#ifdef G_OS_UNIX
+    {
+        struct rusage usage;
+
+        /* ru_maxrss is a process wide high-water mark: the results are
+         * meaningful only when the tests are run in increasing size */
+        if (getrusage(RUSAGE_SELF, &usage) == 0)
+            g_test_minimized_result(usage.ru_maxrss,
+                                    "peak-rss %d parts: %ld KiB",
+                                    n_parts, (glong) usage.ru_maxrss);
+    }
+#endif
+}
+
+
+int
+main(int argc, char *argv[])
+{
+    static const gint perf_sizes[] = { 10, 100, 1000 };
+    gchar *path;
+    guint n;
+
+    adg_test_init(&argc, &argv);
+
+    if (! g_test_perf()) {
+        g_test_add_data_func("/adg/bench/canvas/1", GINT_TO_POINTER(1), _adg_bench);
+        return g_test_run();
+    }
+
+    for (n = 0; n < G_N_ELEMENTS(perf_sizes); ++n) {
+        path = g_strdup_printf("/adg/bench/canvas/%d", perf_sizes[n]);
+        g_test_add_data_func(path, GINT_TO_POINTER(perf_sizes[n]), _adg_bench);
+        g_free(path);
+    }
+
+    return g_test_run();
+}
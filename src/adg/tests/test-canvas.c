@@ -718,6 +718,59 @@ _adg_method_autoscale(void)
     adg_entity_destroy(ADG_ENTITY(canvas));
 }
 
+static AdgEntity *
+_adg_stroke(gdouble x, gdouble y)
+{
+    AdgPath *path;
+    AdgStroke *stroke;
+
+    path = adg_path_new();
+    adg_path_move_to_explicit(path, 0, 0);
+    adg_path_line_to_explicit(path, x, y);
+    stroke = adg_stroke_new(ADG_TRAIL(path));
+    g_object_unref(path);
+
+    return ADG_ENTITY(stroke);
+}
+
+static void
+_adg_method_autoscale_fixed(void)
+{
+    AdgCanvas *canvas;
+    AdgTitleBlock *title_block;
+    AdgContainer *container;
+    AdgEntity *annotation;
+    const cairo_matrix_t *matrix;
+
+    canvas = adg_canvas_new();
+    adg_canvas_set_scales(canvas, "20:1", "10:1", "8:1", "1:1", NULL);
+    adg_canvas_set_size_explicit(canvas, 105, 105);
+    adg_canvas_set_paddings(canvas, 0, 0, 0, 0);
+
+    title_block = adg_title_block_new();
+    adg_canvas_set_title_block(canvas, title_block);
+    g_object_unref(title_block);
+
+    /* The annotation keeps its size at any scale, so the extents of
+     * the container are 60 up to 6:1 and 10 times the scale after:
+     * interpolating them between 1:1 and 20:1 predicts only 1:1 fits */
+    annotation = _adg_stroke(60, 60);
+    adg_entity_set_local_mix(annotation, ADG_MIX_DISABLED);
+
+    container = adg_container_new();
+    adg_container_add(container, _adg_stroke(10, 10));
+    adg_container_add(container, annotation);
+    adg_container_add(ADG_CONTAINER(canvas), ADG_ENTITY(container));
+
+    /* The selected scale must be the first one that fits */
+    adg_canvas_autoscale(canvas);
+    matrix = adg_entity_get_local_matrix(ADG_ENTITY(canvas));
+    adg_assert_isapprox(matrix->xx, 10);
+    g_assert_cmpstr(adg_title_block_get_scale(title_block), ==, "10:1");
+
+    adg_entity_destroy(ADG_ENTITY(canvas));
+}
+
 static void
 _adg_method_set_margins(void)
 {
@@ -843,6 +896,63 @@ _adg_method_set_paddings(void)
     adg_entity_destroy(ADG_ENTITY(canvas));
 }
 
+static void
+_adg_method_damage(void)
+{
+    AdgCanvas *canvas;
+    AdgPath *path;
+    AdgStroke *stroke;
+    const CpmlExtents *damage;
+    guint n_damage;
+    CpmlPair old_pair = { 5, 5 };
+    CpmlPair new_pair = { 100, 100 };
+
+    canvas = adg_canvas_new();
+    path = adg_path_new();
+    adg_path_move_to_explicit(path, 0, 0);
+    adg_path_line_to_explicit(path, 10, 10);
+    stroke = adg_stroke_new(ADG_TRAIL(path));
+    g_object_unref(path);
+    adg_container_add(ADG_CONTAINER(canvas), ADG_ENTITY(stroke));
+
+    /* Sanity check */
+    g_assert_null(adg_canvas_get_damage(NULL, &n_damage));
+    g_assert_null(adg_canvas_get_damage(canvas, NULL));
+
+    /* The first arrange damages the whole drawing */
+    adg_entity_arrange(ADG_ENTITY(canvas));
+    damage = adg_canvas_get_damage(canvas, &n_damage);
+    g_assert_nonnull(damage);
+    g_assert_cmpuint(n_damage, >, 0);
+
+    adg_canvas_reset_damage(canvas);
+    damage = adg_canvas_get_damage(canvas, &n_damage);
+    g_assert_null(damage);
+    g_assert_cmpuint(n_damage, ==, 0);
+
+    /* Arranging without changes does not damage anything */
+    adg_entity_arrange(ADG_ENTITY(canvas));
+    damage = adg_canvas_get_damage(canvas, &n_damage);
+    g_assert_null(damage);
+    g_assert_cmpuint(n_damage, ==, 0);
+
+    /* Invalidating an entity damages its old extents... */
+    adg_path_line_to_explicit(path, 100, 100);
+    adg_entity_invalidate(ADG_ENTITY(stroke));
+    damage = adg_canvas_get_damage(canvas, &n_damage);
+    g_assert_cmpuint(n_damage, ==, 1);
+    g_assert_true(cpml_extents_pair_is_inside(&damage[0], &old_pair));
+    g_assert_false(cpml_extents_pair_is_inside(&damage[0], &new_pair));
+
+    /* ...and arranging it again damages the new ones */
+    adg_entity_arrange(ADG_ENTITY(canvas));
+    damage = adg_canvas_get_damage(canvas, &n_damage);
+    g_assert_cmpuint(n_damage, ==, 2);
+    g_assert_true(cpml_extents_pair_is_inside(&damage[1], &new_pair));
+
+    adg_entity_destroy(ADG_ENTITY(canvas));
+}
+
 static void
 _adg_method_export(void)
 {
@@ -874,6 +984,42 @@ _adg_method_export(void)
     adg_entity_destroy(ADG_ENTITY(canvas));
 }
 
+static void
+_adg_method_export_batch(void)
+{
+    AdgCanvas *canvases[4];
+    const gchar *files[4];
+    GError *error;
+    guint n;
+
+    for (n = 0; n < G_N_ELEMENTS(canvases); ++n) {
+        canvases[n] = adg_test_canvas();
+        files[n] = NULL_FILE;
+    }
+
+    /* Sanity check */
+    g_assert_false(adg_canvas_export_batch(NULL, files, 1, CAIRO_SURFACE_TYPE_PDF, 0, NULL));
+    g_assert_false(adg_canvas_export_batch(canvases, NULL, 1, CAIRO_SURFACE_TYPE_PDF, 0, NULL));
+    g_assert_true(adg_canvas_export_batch(NULL, NULL, 0, CAIRO_SURFACE_TYPE_PDF, 0, NULL));
+
+    /* Export using the default number of threads and a single thread */
+    g_assert_true(adg_canvas_export_batch(canvases, files, 4, CAIRO_SURFACE_TYPE_PDF, 0, NULL));
+    g_assert_true(adg_canvas_export_batch(canvases, files, 4, CAIRO_SURFACE_TYPE_SVG, 1, NULL));
+
+    /* The main thread must not be affected by the workers */
+    g_assert_false(adg_dress_has_thread_fallbacks());
+
+    /* Unsupported surface types must report an error */
+    error = NULL;
+    g_assert_false(adg_canvas_export_batch(canvases, files, 4, CAIRO_SURFACE_TYPE_XLIB, 2, &error));
+    g_assert_nonnull(error);
+    g_assert_cmpint(error->code, ==, ADG_CANVAS_ERROR_SURFACE);
+    g_error_free(error);
+
+    for (n = 0; n < G_N_ELEMENTS(canvases); ++n)
+        adg_entity_destroy(ADG_ENTITY(canvases[n]));
+}
+
 #if GTK3_ENABLED || GTK2_ENABLED
 
 static void
@@ -1035,12 +1181,15 @@ main(int argc, char *argv[])
     g_test_add_func("/adg/canvas/property/left-padding", _adg_property_left_padding);
 
     g_test_add_func("/adg/canvas/method/autoscale", _adg_method_autoscale);
+    g_test_add_func("/adg/canvas/method/autoscale-fixed", _adg_method_autoscale_fixed);
     g_test_add_func("/adg/canvas/method/set-margins", _adg_method_set_margins);
     g_test_add_func("/adg/canvas/method/get-margins", _adg_method_get_margins);
     g_test_add_func("/adg/canvas/method/apply-margins", _adg_method_apply_margins);
     g_test_add_func("/adg/canvas/method/set-paddings", _adg_method_set_paddings);
     g_test_add_func("/adg/canvas/method/get-paddings", _adg_method_get_paddings);
+    g_test_add_func("/adg/canvas/method/damage", _adg_method_damage);
     g_test_add_func("/adg/canvas/method/export", _adg_method_export);
+    g_test_add_func("/adg/canvas/method/export-batch", _adg_method_export_batch);
 #if GTK3_ENABLED || GTK2_ENABLED
     g_test_add_func("/adg/canvas/method/set-paper", _adg_method_set_paper);
     g_test_add_func("/adg/canvas/method/get-page-setup", _adg_method_get_page_setup);
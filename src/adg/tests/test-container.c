@@ -123,6 +123,179 @@ _adg_property_child(void)
     adg_entity_destroy(valid_entity);
 }
 
+static AdgEntity *
+_adg_stroke(gdouble x1, gdouble y1, gdouble x2, gdouble y2)
+{
+    AdgPath *path;
+    AdgStroke *stroke;
+
+    path = adg_path_new();
+    adg_path_move_to_explicit(path, x1, y1);
+    adg_path_line_to_explicit(path, x2, y2);
+    stroke = adg_stroke_new(ADG_TRAIL(path));
+    g_object_unref(path);
+
+    return ADG_ENTITY(stroke);
+}
+
+static void
+_adg_method_query(void)
+{
+    AdgContainer *container;
+    AdgEntity *stroke1, *stroke2;
+    CpmlExtents extents;
+    CpmlPair pair;
+    GSList *children;
+    gint n;
+
+    container = adg_container_new();
+    stroke1 = _adg_stroke(0, 0, 10, 10);
+    stroke2 = _adg_stroke(100, 100, 110, 110);
+    adg_container_add(container, stroke1);
+    adg_container_add(container, stroke2);
+
+    /* Enough children to have a real hierarchy */
+    for (n = 0; n < 20; ++n)
+        adg_container_add(container, _adg_stroke(200 + n * 20, 0, 210 + n * 20, 10));
+
+    /* Invalid input */
+    pair.x = 5;
+    pair.y = 5;
+    g_assert_null(adg_container_query_pair(NULL, &pair));
+    g_assert_null(adg_container_query_pair(container, NULL));
+    g_assert_null(adg_container_query_extents(container, NULL));
+
+    /* Children without extents are never returned */
+    g_assert_null(adg_container_query_pair(container, &pair));
+
+    adg_entity_arrange(ADG_ENTITY(container));
+
+    children = adg_container_query_pair(container, &pair);
+    g_assert_nonnull(children);
+    g_assert_cmpint(g_slist_length(children), ==, 1);
+    g_assert_true(children->data == stroke1);
+    g_slist_free(children);
+
+    pair.x = 105;
+    pair.y = 105;
+    children = adg_container_query_pair(container, &pair);
+    g_assert_nonnull(children);
+    g_assert_cmpint(g_slist_length(children), ==, 1);
+    g_assert_true(children->data == stroke2);
+    g_slist_free(children);
+
+    pair.x = 50;
+    pair.y = 50;
+    g_assert_null(adg_container_query_pair(container, &pair));
+
+    /* The result has the same order of adg_container_children() */
+    extents.is_defined = 1;
+    extents.org.x = -1;
+    extents.org.y = -1;
+    extents.size.x = 200;
+    extents.size.y = 200;
+    children = adg_container_query_extents(container, &extents);
+    g_assert_nonnull(children);
+    g_assert_cmpint(g_slist_length(children), ==, 2);
+    g_assert_true(children->data == stroke2);
+    g_assert_true(children->next->data == stroke1);
+    g_slist_free(children);
+
+    extents.org.x = 235;
+    extents.size.x = 20;
+    children = adg_container_query_extents(container, &extents);
+    g_assert_nonnull(children);
+    g_assert_cmpint(g_slist_length(children), ==, 1);
+    g_slist_free(children);
+
+    /* Removing a child is immediately reflected on the result */
+    adg_container_remove(container, stroke1);
+    pair.x = 5;
+    pair.y = 5;
+    g_assert_null(adg_container_query_pair(container, &pair));
+
+    adg_entity_destroy(ADG_ENTITY(container));
+}
+
+static void
+_adg_behavior_culling(void)
+{
+    AdgContainer *container, *nested;
+    AdgEntity *floating;
+    cairo_t *cr;
+
+    container = adg_container_new();
+    nested = adg_container_new();
+    floating = _adg_stroke(0, 20, 40, 20);
+    adg_entity_switch_floating(floating, TRUE);
+    adg_container_add(nested, _adg_stroke(1000, 1000, 1010, 1010));
+    adg_container_add(nested, floating);
+    adg_container_add(container, ADG_ENTITY(nested));
+
+    cr = adg_test_cairo_context();
+    cairo_rectangle(cr, 0, 0, 40, 40);
+    cairo_clip(cr);
+
+    /* The extents of the nested container do not include its floating
+     * child, so they are outside the clipping area: the floating child
+     * crosses it and must be rendered anyway */
+    adg_entity_render(ADG_ENTITY(container), cr);
+    g_assert_true(adg_test_cairo_is_painted(cr, 20, 20));
+    cairo_destroy(cr);
+
+    /* The same must happen when the nested container is floating too */
+    adg_entity_switch_floating(ADG_ENTITY(nested), TRUE);
+    adg_entity_invalidate(ADG_ENTITY(container));
+
+    cr = adg_test_cairo_context();
+    cairo_rectangle(cr, 0, 0, 40, 40);
+    cairo_clip(cr);
+    adg_entity_render(ADG_ENTITY(container), cr);
+    g_assert_true(adg_test_cairo_is_painted(cr, 20, 20));
+    cairo_destroy(cr);
+
+    adg_entity_destroy(ADG_ENTITY(container));
+}
+
+static void
+_adg_mutating_callback(AdgEntity *entity, gpointer user_data)
+{
+    AdgContainer *container = (AdgContainer *) adg_entity_get_parent(entity);
+    gint *n_calls = user_data;
+
+    ++*n_calls;
+
+    /* Remove this child and add a new one that must not be visited */
+    adg_container_remove(container, entity);
+    adg_container_add(container, ADG_ENTITY(adg_logo_new()));
+}
+
+static void
+_adg_method_foreach(void)
+{
+    AdgContainer *container;
+    GSList *children;
+    gint n, n_calls;
+
+    container = adg_container_new();
+    for (n = 0; n < 3; ++n)
+        adg_container_add(container, ADG_ENTITY(adg_logo_new()));
+
+    n_calls = 0;
+    adg_container_foreach(container, G_CALLBACK(_adg_mutating_callback), &n_calls);
+    g_assert_cmpint(n_calls, ==, 3);
+
+    children = adg_container_children(container);
+    g_assert_cmpint(g_slist_length(children), ==, 3);
+    g_slist_free(children);
+
+    /* Destroying the children while propagating must not crash */
+    adg_container_propagate_by_name(container, "destroy");
+    g_assert_null(adg_container_children(container));
+
+    adg_entity_destroy(ADG_ENTITY(container));
+}
+
 
 int
 main(int argc, char *argv[])
@@ -145,5 +318,9 @@ main(int argc, char *argv[])
 
     g_test_add_func("/adg/container/property/child", _adg_property_child);
 
+    g_test_add_func("/adg/container/behavior/culling", _adg_behavior_culling);
+    g_test_add_func("/adg/container/method/query", _adg_method_query);
+    g_test_add_func("/adg/container/method/foreach", _adg_method_foreach);
+
     return g_test_run();
 }
@@ -937,6 +937,66 @@ _adg_method_convert(void)
     g_object_unref(dim_style);
 }
 
+static void
+_adg_method_format(void)
+{
+    AdgDimStyle *dim_style;
+    gchar *text;
+
+    dim_style = adg_dim_style_new();
+
+    /* Sanity check */
+    g_assert_null(adg_dim_style_format(NULL, 1));
+
+    /* Default format */
+    text = adg_dim_style_format(dim_style, 7.891);
+    g_assert_cmpstr(text, ==, "7.89");
+    g_free(text);
+
+    /* The compiled format must be rebuilt on property changes */
+    adg_dim_style_set_number_arguments(dim_style, "D");
+    text = adg_dim_style_format(dim_style, 7.891);
+    g_assert_cmpstr(text, ==, "7");
+    g_free(text);
+
+    adg_dim_style_set_number_format(dim_style, "\\(%g\\)");
+    text = adg_dim_style_format(dim_style, 7.891);
+    g_assert_cmpstr(text, ==, "(7)");
+    g_free(text);
+
+    /* Groups and escape sequences */
+    adg_dim_style_set_number_arguments(dim_style, "DMs");
+    adg_dim_style_set_number_format(dim_style, "%g\\%(%g'(%g\"))");
+
+    text = adg_dim_style_format(dim_style, 0);
+    g_assert_cmpstr(text, ==, "0%");
+    g_free(text);
+
+    text = adg_dim_style_format(dim_style, 1.5);
+    g_assert_cmpstr(text, ==, "1%30'");
+    g_free(text);
+
+    /* Same format, different values */
+    text = adg_dim_style_format(dim_style, 2.5);
+    g_assert_cmpstr(text, ==, "2%30'");
+    g_free(text);
+
+    /* Unbalanced parenthesis */
+    adg_dim_style_set_number_format(dim_style, "%g(");
+    g_assert_null(adg_dim_style_format(dim_style, 1));
+
+    adg_dim_style_set_number_format(dim_style, "%g)");
+    g_assert_null(adg_dim_style_format(dim_style, 1));
+
+    /* No arguments: the format is returned as is */
+    adg_dim_style_set_number_arguments(dim_style, NULL);
+    text = adg_dim_style_format(dim_style, 1);
+    g_assert_cmpstr(text, ==, "%g)");
+    g_free(text);
+
+    g_object_unref(dim_style);
+}
+
 static void
 _adg_method_clone(void)
 {
@@ -1000,6 +1060,7 @@ main(int argc, char *argv[])
     g_test_add_func("/adg/dim-style/property/value-dress", _adg_property_value_dress);
 
     g_test_add_func("/adg/dim-style/method/convert", _adg_method_convert);
+    g_test_add_func("/adg/dim-style/method/format", _adg_method_format);
     g_test_add_func("/adg/dim-style/method/clone", _adg_method_clone);
 
     return g_test_run();
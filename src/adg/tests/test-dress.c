@@ -301,6 +301,42 @@ _adg_method_get_ancestor_type(void)
     g_assert_cmpint(adg_dress_get_ancestor_type(ADG_DRESS_TABLE),                 ==, ADG_TYPE_TABLE_STYLE);
 }
 
+static void
+_adg_method_thread_fallbacks(void)
+{
+    AdgStyle *global, *private, *style;
+
+    global = adg_dress_get_fallback(ADG_DRESS_LINE_STROKE);
+    g_assert_false(adg_dress_has_thread_fallbacks());
+
+    /* Private fallbacks must be distinct clones of the global ones */
+    adg_dress_switch_thread_fallbacks(TRUE);
+    g_assert_true(adg_dress_has_thread_fallbacks());
+    private = adg_dress_get_fallback(ADG_DRESS_LINE_STROKE);
+    g_assert_nonnull(private);
+    g_assert_true(private != global);
+    g_assert_true(G_OBJECT_TYPE(private) == G_OBJECT_TYPE(global));
+    g_assert_true(adg_dress_get_fallback(ADG_DRESS_LINE_STROKE) == private);
+
+    /* Changing a global fallback must refresh the private clones */
+    style = (AdgStyle *) adg_line_style_new();
+    adg_line_style_set_width((AdgLineStyle *) style, 12.5);
+    g_object_ref(global);
+    adg_dress_set_fallback(ADG_DRESS_LINE_STROKE, style);
+    private = adg_dress_get_fallback(ADG_DRESS_LINE_STROKE);
+    g_assert_true(private != style);
+    adg_assert_isapprox(adg_line_style_get_width((AdgLineStyle *) private), 12.5);
+
+    /* Back to the global fallbacks */
+    adg_dress_switch_thread_fallbacks(FALSE);
+    g_assert_false(adg_dress_has_thread_fallbacks());
+    g_assert_true(adg_dress_get_fallback(ADG_DRESS_LINE_STROKE) == style);
+
+    adg_dress_set_fallback(ADG_DRESS_LINE_STROKE, global);
+    g_object_unref(global);
+    g_object_unref(style);
+}
+
 
 int
 main(int argc, char *argv[])
@@ -313,6 +349,7 @@ main(int argc, char *argv[])
     g_test_add_func("/adg/dress/method/set", _adg_method_set);
     g_test_add_func("/adg/dress/method/are-related",  _adg_method_are_related);
     g_test_add_func("/adg/dress/method/ancestor-type", _adg_method_get_ancestor_type);
+    g_test_add_func("/adg/dress/method/thread-fallbacks", _adg_method_thread_fallbacks);
 
     return g_test_run();
 }
@@ -59,6 +59,7 @@ static void
 _adg_behavior_style(void)
 {
     AdgEntity *entity;
+    AdgContainer *container;
     AdgStyle *style, *color_style, *line_style;
 
     entity = ADG_ENTITY(adg_logo_new());
@@ -89,11 +90,172 @@ _adg_behavior_style(void)
 
     g_assert_null(adg_entity_get_style(NULL, ADG_DRESS_COLOR));
 
+    /* Check the resolved styles are refreshed when needed */
+    container = adg_container_new();
+    adg_entity_set_style(ADG_ENTITY(container), ADG_DRESS_COLOR, color_style);
+    style = adg_entity_style(entity, ADG_DRESS_COLOR);
+    g_assert_true(style == adg_dress_get_fallback(ADG_DRESS_COLOR));
+
+    adg_container_add(container, entity);
+    style = adg_entity_style(entity, ADG_DRESS_COLOR);
+    g_assert_true(style == color_style);
+
+    adg_entity_set_style(ADG_ENTITY(container), ADG_DRESS_COLOR, NULL);
+    style = adg_entity_style(entity, ADG_DRESS_COLOR);
+    g_assert_true(style == adg_dress_get_fallback(ADG_DRESS_COLOR));
+
+    adg_entity_set_style(ADG_ENTITY(container), ADG_DRESS_COLOR, color_style);
+    style = adg_entity_style(entity, ADG_DRESS_COLOR);
+    g_assert_true(style == color_style);
+
+    g_object_ref(entity);
+    adg_container_remove(container, entity);
+    style = adg_entity_style(entity, ADG_DRESS_COLOR);
+    g_assert_true(style == adg_dress_get_fallback(ADG_DRESS_COLOR));
+
+    adg_entity_destroy(ADG_ENTITY(container));
     adg_entity_destroy(entity);
     g_object_unref(color_style);
     g_object_unref(line_style);
 }
 
+static void
+_adg_count_calls(AdgEntity *entity, gpointer user_data)
+{
+    ++*(gint *) user_data;
+}
+
+static void
+_adg_behavior_direct_dispatch(void)
+{
+    AdgEntity *entity;
+    gulong handler;
+    gint n_calls;
+
+    adg_switch_direct_dispatch(TRUE);
+    entity = ADG_ENTITY(adg_logo_new());
+
+    /* Without handlers the default handlers are called directly */
+    adg_entity_arrange(entity);
+    g_assert_true(adg_entity_get_extents(entity)->is_defined);
+    adg_entity_invalidate(entity);
+    g_assert_false(adg_entity_get_extents(entity)->is_defined);
+
+    /* With a connected handler the signal is emitted */
+    n_calls = 0;
+    handler = g_signal_connect(entity, "arrange",
+                               G_CALLBACK(_adg_count_calls), &n_calls);
+    adg_entity_arrange(entity);
+    g_assert_cmpint(n_calls, ==, 1);
+    g_assert_true(adg_entity_get_extents(entity)->is_defined);
+
+    g_signal_handler_disconnect(entity, handler);
+    adg_entity_arrange(entity);
+    g_assert_cmpint(n_calls, ==, 1);
+
+    adg_entity_destroy(entity);
+    adg_switch_direct_dispatch(FALSE);
+}
+
+static gboolean
+_adg_same_rendering(cairo_t *cr1, cairo_t *cr2)
+{
+    cairo_surface_t *surface1 = cairo_get_target(cr1);
+    cairo_surface_t *surface2 = cairo_get_target(cr2);
+
+    cairo_surface_flush(surface1);
+    cairo_surface_flush(surface2);
+
+    return memcmp(cairo_image_surface_get_data(surface1),
+                  cairo_image_surface_get_data(surface2),
+                  cairo_image_surface_get_stride(surface1) *
+                  cairo_image_surface_get_height(surface1)) == 0;
+}
+
+static void
+_adg_behavior_cache(void)
+{
+    AdgCanvas *canvas;
+    AdgEntity *entity;
+    AdgLineStyle *line_style;
+    cairo_matrix_t map;
+    cairo_t *plain, *recorded, *replayed;
+
+    canvas = adg_test_canvas();
+    entity = ADG_ENTITY(adg_logo_new());
+    adg_container_add(ADG_CONTAINER(canvas), entity);
+    cairo_matrix_init_scale(&map, 10, 10);
+    adg_entity_set_global_map(ADG_ENTITY(canvas), &map);
+
+    plain = adg_test_cairo_context();
+    adg_entity_render(ADG_ENTITY(canvas), plain);
+
+    /* The first rendering records the logo, the second one replays it */
+    adg_entity_switch_cache(entity, TRUE);
+    recorded = adg_test_cairo_context();
+    adg_entity_render(ADG_ENTITY(canvas), recorded);
+    replayed = adg_test_cairo_context();
+    adg_entity_render(ADG_ENTITY(canvas), replayed);
+
+    g_assert_true(_adg_same_rendering(plain, recorded));
+    g_assert_true(_adg_same_rendering(plain, replayed));
+
+    /* A translation moves the replayed recording */
+    cairo_destroy(replayed);
+    replayed = adg_test_cairo_context();
+    cairo_translate(replayed, 5, 5);
+    adg_entity_render(ADG_ENTITY(canvas), replayed);
+    g_assert_false(_adg_same_rendering(plain, replayed));
+
+    /* A different scale must not reuse the old recording */
+    cairo_destroy(recorded);
+    recorded = adg_test_cairo_context();
+    cairo_translate(recorded, 5, 5);
+    cairo_scale(recorded, 2, 2);
+    adg_entity_render(ADG_ENTITY(canvas), recorded);
+
+    cairo_destroy(plain);
+    plain = adg_test_cairo_context();
+    cairo_translate(plain, 5, 5);
+    adg_entity_switch_cache(entity, FALSE);
+    adg_entity_render(ADG_ENTITY(canvas), plain);
+    g_assert_true(_adg_same_rendering(plain, replayed));
+
+    cairo_destroy(plain);
+    plain = adg_test_cairo_context();
+    cairo_translate(plain, 5, 5);
+    cairo_scale(plain, 2, 2);
+    adg_entity_render(ADG_ENTITY(canvas), plain);
+    g_assert_true(_adg_same_rendering(plain, recorded));
+
+    cairo_destroy(plain);
+    cairo_destroy(recorded);
+    cairo_destroy(replayed);
+
+    /* Changing a style after the recording must not reuse it */
+    line_style = adg_line_style_new();
+    adg_entity_set_style(entity, ADG_DRESS_LINE, (AdgStyle *) line_style);
+    g_object_unref(line_style);
+
+    adg_entity_switch_cache(entity, TRUE);
+    recorded = adg_test_cairo_context();
+    adg_entity_render(ADG_ENTITY(canvas), recorded);
+    adg_line_style_set_width(line_style, 5);
+    replayed = adg_test_cairo_context();
+    adg_entity_render(ADG_ENTITY(canvas), replayed);
+    g_assert_false(_adg_same_rendering(recorded, replayed));
+
+    plain = adg_test_cairo_context();
+    adg_entity_switch_cache(entity, FALSE);
+    adg_entity_render(ADG_ENTITY(canvas), plain);
+    g_assert_true(_adg_same_rendering(plain, replayed));
+
+    cairo_destroy(plain);
+    cairo_destroy(recorded);
+    cairo_destroy(replayed);
+    adg_entity_destroy(ADG_ENTITY(canvas));
+}
+
 static void
 _adg_behavior_local(void)
 {
@@ -449,6 +611,8 @@ main(int argc, char *argv[])
     g_test_add_func("/adg/entity/behavior/misc", _adg_behavior_misc);
     g_test_add_func("/adg/entity/behavior/style", _adg_behavior_style);
     g_test_add_func("/adg/entity/behavior/local", _adg_behavior_local);
+    g_test_add_func("/adg/entity/behavior/direct-dispatch", _adg_behavior_direct_dispatch);
+    g_test_add_func("/adg/entity/behavior/cache", _adg_behavior_cache);
 
     g_test_add_func("/adg/entity/property/floating", _adg_property_floating);
     g_test_add_func("/adg/entity/property/parent", _adg_property_parent);
@@ -338,6 +338,59 @@ _adg_property_weight(void)
     g_object_unref(font_style);
 }
 
+static void
+_adg_method_get_scaled_font(void)
+{
+    AdgFontStyle *font_style;
+    cairo_matrix_t ctm;
+    cairo_scaled_font_t *font1, *font2, *font;
+    gint n;
+
+    font_style = adg_font_style_new();
+
+    cairo_matrix_init_identity(&ctm);
+    font1 = adg_font_style_get_scaled_font(font_style, &ctm);
+    g_assert_nonnull(font1);
+
+    /* The translation component is not relevant */
+    cairo_matrix_translate(&ctm, 10, 20);
+    g_assert_true(adg_font_style_get_scaled_font(font_style, &ctm) == font1);
+
+    cairo_matrix_init_rotate(&ctm, G_PI_2);
+    font2 = adg_font_style_get_scaled_font(font_style, &ctm);
+    g_assert_nonnull(font2);
+    g_assert_true(font2 != font1);
+
+    /* Both fonts must be cached */
+    cairo_matrix_init_identity(&ctm);
+    g_assert_true(adg_font_style_get_scaled_font(font_style, &ctm) == font1);
+    cairo_matrix_init_rotate(&ctm, G_PI_2);
+    g_assert_true(adg_font_style_get_scaled_font(font_style, &ctm) == font2);
+
+    /* Fill the cache with other fonts: font2 is the most recently
+     * used one, so it survives while font1 is dropped */
+    cairo_scaled_font_reference(font1);
+    g_assert_cmpuint(cairo_scaled_font_get_reference_count(font1), ==, 2);
+    for (n = 2; n < 5; ++n) {
+        cairo_matrix_init_scale(&ctm, n, n);
+        font = adg_font_style_get_scaled_font(font_style, &ctm);
+        g_assert_nonnull(font);
+    }
+    g_assert_cmpuint(cairo_scaled_font_get_reference_count(font1), ==, 1);
+    cairo_matrix_init_rotate(&ctm, G_PI_2);
+    g_assert_true(adg_font_style_get_scaled_font(font_style, &ctm) == font2);
+    cairo_matrix_init_identity(&ctm);
+    font = adg_font_style_get_scaled_font(font_style, &ctm);
+    g_assert_nonnull(font);
+    cairo_scaled_font_destroy(font1);
+
+    /* Invalid input */
+    g_assert_null(adg_font_style_get_scaled_font(NULL, &ctm));
+    g_assert_null(adg_font_style_get_scaled_font(font_style, NULL));
+
+    g_object_unref(font_style);
+}
+
 
 int
 main(int argc, char *argv[])
@@ -356,5 +409,7 @@ main(int argc, char *argv[])
     g_test_add_func("/adg/font-style/property/subpixel-order", _adg_property_subpixel_order);
     g_test_add_func("/adg/font-style/property/weight", _adg_property_weight);
 
+    g_test_add_func("/adg/font-style/method/get-scaled-font", _adg_method_get_scaled_font);
+
     return g_test_run();
 }
@@ -239,6 +239,48 @@ _adg_property_autozoom(void)
     gtk_widget_destroy(GTK_WIDGET(area));
 }
 
+static void
+_adg_property_tile_cache(void)
+{
+    AdgGtkArea *area;
+    gboolean invalid_boolean;
+    gboolean has_tile_cache;
+
+    area = (AdgGtkArea *) adg_gtk_area_new();
+    invalid_boolean = (gboolean) 1234;
+
+    /* Using the public APIs */
+    has_tile_cache = adg_gtk_area_has_tile_cache(area);
+    g_assert_false(has_tile_cache);
+
+    adg_gtk_area_switch_tile_cache(area, TRUE);
+    has_tile_cache = adg_gtk_area_has_tile_cache(area);
+    g_assert_true(has_tile_cache);
+
+    adg_gtk_area_switch_tile_cache(area, invalid_boolean);
+    has_tile_cache = adg_gtk_area_has_tile_cache(area);
+    g_assert_true(has_tile_cache);
+
+    adg_gtk_area_switch_tile_cache(area, FALSE);
+    has_tile_cache = adg_gtk_area_has_tile_cache(area);
+    g_assert_false(has_tile_cache);
+
+    /* Using GObject property methods */
+    g_object_set(area, "tile-cache", invalid_boolean, NULL);
+    g_object_get(area, "tile-cache", &has_tile_cache, NULL);
+    g_assert_false(has_tile_cache);
+
+    g_object_set(area, "tile-cache", TRUE, NULL);
+    g_object_get(area, "tile-cache", &has_tile_cache, NULL);
+    g_assert_true(has_tile_cache);
+
+    g_object_set(area, "tile-cache", FALSE, NULL);
+    g_object_get(area, "tile-cache", &has_tile_cache, NULL);
+    g_assert_false(has_tile_cache);
+
+    gtk_widget_destroy(GTK_WIDGET(area));
+}
+
 static void
 _adg_property_render_map(void)
 {
@@ -326,6 +368,43 @@ _adg_method_get_extents(void)
     gtk_widget_destroy(GTK_WIDGET(area));
 }
 
+static void
+_adg_method_get_entity_at(void)
+{
+    AdgGtkArea *area;
+    AdgCanvas *canvas;
+    AdgEntity *stroke;
+    GSList *children;
+    cairo_matrix_t map;
+
+    area = ADG_GTK_AREA(adg_gtk_area_new());
+    canvas = adg_test_canvas();
+    children = adg_container_children(ADG_CONTAINER(canvas));
+    stroke = children->data;
+    g_slist_free(children);
+
+    /* Sanity check */
+    g_assert_null(adg_gtk_area_get_entity_at(NULL, 0.5, 0.5));
+
+    /* With no canvas, no entity can be found */
+    g_assert_null(adg_gtk_area_get_entity_at(area, 0.5, 0.5));
+
+    adg_gtk_area_set_canvas(area, canvas);
+    g_object_unref(canvas);
+    adg_gtk_area_get_extents(area);
+
+    g_assert_true(adg_gtk_area_get_entity_at(area, 0.5, 0.5) == stroke);
+    g_assert_null(adg_gtk_area_get_entity_at(area, 5, 5));
+
+    /* The point is in widget space, so the render map must be applied */
+    cairo_matrix_init_scale(&map, 10, 10);
+    adg_gtk_area_set_render_map(area, &map);
+    g_assert_true(adg_gtk_area_get_entity_at(area, 5, 5) == stroke);
+    g_assert_null(adg_gtk_area_get_entity_at(area, 50, 50));
+
+    gtk_widget_destroy(GTK_WIDGET(area));
+}
+
 static void
 _adg_method_get_zoom(void)
 {
@@ -637,8 +716,10 @@ main(int argc, char *argv[])
     g_test_add_func("/adg-gtk/area/property/factor", _adg_property_factor);
     g_test_add_func("/adg-gtk/area/property/autozoom", _adg_property_autozoom);
     g_test_add_func("/adg-gtk/area/property/render-map", _adg_property_render_map);
+    g_test_add_func("/adg-gtk/area/property/tile-cache", _adg_property_tile_cache);
 
     g_test_add_func("/adg-gtk/area/method/get-extents", _adg_method_get_extents);
+    g_test_add_func("/adg-gtk/area/method/get-entity-at", _adg_method_get_entity_at);
     g_test_add_func("/adg-gtk/area/method/get-zoom", _adg_method_get_zoom);
     g_test_add_func("/adg-gtk/area/method/switch-autozoom", _adg_method_switch_autozoom);
     g_test_add_func("/adg-gtk/area/method/reset", _adg_method_reset);
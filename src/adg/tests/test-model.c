@@ -100,10 +100,175 @@ _adg_property_dependency(void)
     dependencies = adg_model_get_dependencies(model);
     g_assert_null(dependencies);
 
+    /* An entity added more than once is listed only once and
+     * must be removed the same number of times */
+    adg_model_add_dependency(model, valid_entity);
+    adg_model_add_dependency(model, valid_entity);
+    dependencies = adg_model_get_dependencies(model);
+    g_assert_nonnull(dependencies);
+    g_assert_true(dependencies->data == valid_entity);
+    g_assert_null(dependencies->next);
+
+    adg_model_remove_dependency(model, valid_entity);
+    dependencies = adg_model_get_dependencies(model);
+    g_assert_nonnull(dependencies);
+    g_assert_true(dependencies->data == valid_entity);
+
+    adg_model_remove_dependency(model, valid_entity);
+    dependencies = adg_model_get_dependencies(model);
+    g_assert_null(dependencies);
+
     g_object_unref(model);
     adg_entity_destroy(valid_entity);
 }
 
+static void
+_adg_count_invalidate(AdgEntity *entity, gpointer user_data)
+{
+    ++ *((gint *) user_data);
+}
+
+static void
+_adg_method_update(void)
+{
+    AdgModel *model1, *model2;
+    AdgEntity *entity;
+    gint n_invalidate;
+
+    model1 = ADG_MODEL(adg_path_new());
+    model2 = ADG_MODEL(adg_path_new());
+    entity = ADG_ENTITY(adg_logo_new());
+    n_invalidate = 0;
+    g_signal_connect(entity, "invalidate",
+                     G_CALLBACK(_adg_count_invalidate), &n_invalidate);
+
+    adg_model_add_dependency(model1, entity);
+    adg_model_add_dependency(model2, entity);
+
+    /* Check sanity */
+    adg_model_begin_update(NULL);
+    adg_model_end_update(NULL);
+    adg_model_end_update(model1);
+
+    /* Outside an update every change invalidates the dependencies */
+    adg_model_changed(model1);
+    adg_model_changed(model2);
+    g_assert_cmpint(n_invalidate, ==, 2);
+
+    /* Inside an update the changes are deferred and coalesced */
+    n_invalidate = 0;
+    adg_model_begin_update(model1);
+    adg_model_begin_update(model2);
+    adg_model_changed(model1);
+    adg_model_changed(model1);
+    adg_model_changed(model2);
+    adg_model_end_update(model2);
+    g_assert_cmpint(n_invalidate, ==, 0);
+    adg_model_end_update(model1);
+    g_assert_cmpint(n_invalidate, ==, 1);
+
+    /* Nested updates are flushed only by the outermost end */
+    n_invalidate = 0;
+    adg_model_begin_update(model1);
+    adg_model_begin_update(model1);
+    adg_model_changed(model1);
+    adg_model_end_update(model1);
+    g_assert_cmpint(n_invalidate, ==, 0);
+    adg_model_end_update(model1);
+    g_assert_cmpint(n_invalidate, ==, 1);
+
+    /* An update without changes does not invalidate anything */
+    n_invalidate = 0;
+    adg_model_begin_update(model2);
+    adg_model_end_update(model2);
+    g_assert_cmpint(n_invalidate, ==, 0);
+
+    adg_model_remove_dependency(model1, entity);
+    adg_model_remove_dependency(model2, entity);
+    g_object_unref(model1);
+    g_object_unref(model2);
+    adg_entity_destroy(entity);
+}
+
+static void
+_adg_method_pair_dependency(void)
+{
+    AdgModel *model;
+    AdgEntity *entity1, *entity2;
+    const GSList *dependencies;
+    gint n_invalidate1, n_invalidate2;
+
+    model = ADG_MODEL(adg_path_new());
+    entity1 = ADG_ENTITY(adg_logo_new());
+    entity2 = ADG_ENTITY(adg_logo_new());
+    n_invalidate1 = n_invalidate2 = 0;
+    g_signal_connect(entity1, "invalidate",
+                     G_CALLBACK(_adg_count_invalidate), &n_invalidate1);
+    g_signal_connect(entity2, "invalidate",
+                     G_CALLBACK(_adg_count_invalidate), &n_invalidate2);
+
+    adg_model_set_named_pair_explicit(model, "A", 0, 0);
+    adg_model_set_named_pair_explicit(model, "B", 1, 1);
+
+    /* Check sanity */
+    adg_model_add_pair_dependency(NULL, "A", entity1);
+    adg_model_add_pair_dependency(model, NULL, entity1);
+    adg_model_add_pair_dependency(model, "A", NULL);
+    adg_model_remove_pair_dependency(model, "A", entity1);
+    g_assert_null(adg_model_get_pair_dependencies(NULL, "A"));
+    g_assert_null(adg_model_get_pair_dependencies(model, NULL));
+    g_assert_null(adg_model_get_pair_dependencies(model, "A"));
+
+    adg_model_add_pair_dependency(model, "A", entity1);
+    adg_model_add_pair_dependency(model, "B", entity2);
+    dependencies = adg_model_get_pair_dependencies(model, "A");
+    g_assert_nonnull(dependencies);
+    g_assert_true(dependencies->data == entity1);
+    g_assert_null(dependencies->next);
+    g_assert_null(adg_model_get_dependencies(model));
+
+    /* Nothing changed */
+    adg_model_changed(model);
+    g_assert_cmpint(n_invalidate1, ==, 0);
+    g_assert_cmpint(n_invalidate2, ==, 0);
+
+    /* Only A changed */
+    adg_model_set_named_pair_explicit(model, "A", 2, 2);
+    adg_model_changed(model);
+    g_assert_cmpint(n_invalidate1, ==, 1);
+    g_assert_cmpint(n_invalidate2, ==, 0);
+
+    /* Redefinition from scratch with the same values */
+    adg_model_reset(model);
+    adg_model_set_named_pair_explicit(model, "A", 2, 2);
+    adg_model_set_named_pair_explicit(model, "B", 1, 1);
+    adg_model_changed(model);
+    g_assert_cmpint(n_invalidate1, ==, 1);
+    g_assert_cmpint(n_invalidate2, ==, 0);
+
+    /* Undefining B is a change */
+    adg_model_set_named_pair(model, "B", NULL);
+    adg_model_changed(model);
+    g_assert_cmpint(n_invalidate1, ==, 1);
+    g_assert_cmpint(n_invalidate2, ==, 1);
+
+    /* A second binding to the same pair does not duplicate it */
+    adg_model_add_pair_dependency(model, "A", entity1);
+    dependencies = adg_model_get_pair_dependencies(model, "A");
+    g_assert_null(dependencies->next);
+    adg_model_remove_pair_dependency(model, "A", entity1);
+    g_assert_nonnull(adg_model_get_pair_dependencies(model, "A"));
+
+    adg_model_remove_pair_dependency(model, "A", entity1);
+    adg_model_remove_pair_dependency(model, "B", entity2);
+    g_assert_null(adg_model_get_pair_dependencies(model, "A"));
+    g_assert_null(adg_model_get_pair_dependencies(model, "B"));
+
+    g_object_unref(model);
+    adg_entity_destroy(entity1);
+    adg_entity_destroy(entity2);
+}
+
 
 int
 main(int argc, char *argv[])
@@ -115,6 +280,8 @@ main(int argc, char *argv[])
 
     g_test_add_func("/adg/model/named-pair", _adg_property_named_pair);
     g_test_add_func("/adg/model/dependency", _adg_property_dependency);
+    g_test_add_func("/adg/model/method/update", _adg_method_update);
+    g_test_add_func("/adg/model/method/pair-dependency", _adg_method_pair_dependency);
 
     return g_test_run();
 }
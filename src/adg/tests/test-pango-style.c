@@ -80,6 +80,48 @@ _adg_method_get_description(void)
     g_object_unref(pango_style);
 }
 
+static void
+_adg_method_put_text_extents(void)
+{
+    AdgPangoStyle *pango_style;
+    PangoRectangle extents, cached;
+    PangoLayout *layout;
+
+    pango_style = adg_pango_style_new();
+
+    /* Sanity checks */
+    g_assert_false(adg_pango_style_put_text_extents(NULL, "Text", &extents));
+    g_assert_false(adg_pango_style_put_text_extents(pango_style, NULL, &extents));
+    g_assert_false(adg_pango_style_put_text_extents(pango_style, "Text", NULL));
+
+    /* The extents must be the same of a layout built from scratch */
+    g_assert_true(adg_pango_style_put_text_extents(pango_style, "Text", &extents));
+    g_assert_cmpint(extents.width, >, 0);
+    g_assert_cmpint(extents.height, >, 0);
+
+    layout = adg_pango_style_new_layout(pango_style, "Text");
+    g_assert_nonnull(layout);
+    pango_layout_get_extents(layout, NULL, &cached);
+    g_assert_cmpint(extents.width, ==, cached.width);
+    g_assert_cmpint(extents.height, ==, cached.height);
+    g_object_unref(layout);
+
+    /* Check the cached value */
+    g_assert_true(adg_pango_style_put_text_extents(pango_style, "Text", &cached));
+    g_assert_cmpint(extents.width, ==, cached.width);
+    g_assert_cmpint(extents.height, ==, cached.height);
+
+    /* A bigger font must invalidate the cache */
+    adg_font_style_set_size(ADG_FONT_STYLE(pango_style),
+                            adg_font_style_get_size(ADG_FONT_STYLE(pango_style)) * 2);
+    g_assert_true(adg_pango_style_put_text_extents(pango_style, "Text", &cached));
+    g_assert_cmpint(cached.width, >, extents.width);
+
+    g_assert_null(adg_pango_style_new_layout(NULL, "Text"));
+
+    g_object_unref(pango_style);
+}
+
 
 int
 main(int argc, char *argv[])
@@ -91,6 +133,7 @@ main(int argc, char *argv[])
     g_test_add_func("/adg/pango-style/property/spacing", _adg_property_spacing);
 
     g_test_add_func("/adg/pango-style/get_description", _adg_method_get_description);
+    g_test_add_func("/adg/pango-style/put_text_extents", _adg_method_put_text_extents);
 
     return g_test_run();
 }
@@ -487,6 +487,31 @@ _adg_method_remove_primitive(void)
     /* Ensure the current point is no more set */
     g_assert_false(adg_path_has_current_point(path));
 
+    /* Remove primitives from a reflected path */
+    adg_path_move_to_explicit(path, 0, 1);
+    adg_path_line_to_explicit(path, 2, 3);
+    adg_path_arc_to_explicit(path, 4, 5, 6, 7);
+    adg_path_reflect(path, NULL);
+    g_assert_cmpint(adg_path_last_primitive(path)->data->header.type, ==, CPML_LINE);
+    g_assert_cmpint(adg_path_over_primitive(path)->data->header.type, ==, CPML_ARC);
+
+    adg_path_remove_primitive(path);
+    g_assert_cmpint(adg_path_last_primitive(path)->data->header.type, ==, CPML_ARC);
+    g_assert_cmpint(adg_path_over_primitive(path)->data->header.type, ==, CPML_ARC);
+    adg_assert_isapprox(adg_path_get_current_point(path)->x, 2);
+    adg_assert_isapprox(adg_path_get_current_point(path)->y, -3);
+
+    adg_path_remove_primitive(path);
+    g_assert_cmpint(adg_path_last_primitive(path)->data->header.type, ==, CPML_ARC);
+    g_assert_cmpint(adg_path_over_primitive(path)->data->header.type, ==, CPML_LINE);
+    adg_assert_isapprox(adg_path_get_current_point(path)->x, 6);
+    adg_assert_isapprox(adg_path_get_current_point(path)->y, 7);
+
+    adg_path_remove_primitive(path);
+    adg_path_remove_primitive(path);
+    g_assert_null(adg_path_last_primitive(path));
+    g_assert_false(adg_path_has_current_point(path));
+
     g_object_unref(path);
 }
 
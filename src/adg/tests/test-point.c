@@ -153,6 +153,25 @@ _adg_behavior_named_pair(void)
     pair = adg_point_get_pair(model_point);
     g_assert_true(cpml_pair_equal(pair, &p1));
     g_free(pair);
+    g_assert_cmpstr(adg_point_get_name(model_point), ==, "named-pair");
+
+    /* Check the binding survives a reset of the model */
+    adg_model_reset(model);
+    adg_point_invalidate(model_point);
+    g_assert_false(adg_point_update(model_point));
+    adg_model_set_named_pair_explicit(model, "named-pair", 78, 90);
+    g_assert_true(adg_point_update(model_point));
+    pair = (CpmlPair *) model_point;
+    adg_assert_isapprox(pair->x, 78);
+    adg_assert_isapprox(pair->y, 90);
+
+    /* Check a modified pair is refreshed after an invalidation */
+    adg_model_set_named_pair_explicit(model, "named-pair", 12, 34);
+    adg_point_invalidate(model_point);
+    g_assert_true(adg_point_update(model_point));
+    pair = (CpmlPair *) model_point;
+    adg_assert_isapprox(pair->x, 12);
+    adg_assert_isapprox(pair->y, 34);
 
     adg_point_destroy(explicit_point);
     adg_point_destroy(model_point);
@@ -145,6 +145,113 @@ _adg_property_spacing(void)
     g_object_unref(ruled_fill);
 }
 
+static void
+_adg_property_vector(void)
+{
+    AdgRuledFill *ruled_fill;
+    gboolean invalid_boolean;
+    gboolean vector;
+
+    ruled_fill = adg_ruled_fill_new();
+    invalid_boolean = (gboolean) 1234;
+
+    /* Using the public APIs */
+    g_assert_false(adg_ruled_fill_has_vector(ruled_fill));
+
+    adg_ruled_fill_switch_vector(ruled_fill, TRUE);
+    g_assert_true(adg_ruled_fill_has_vector(ruled_fill));
+
+    adg_ruled_fill_switch_vector(ruled_fill, invalid_boolean);
+    g_assert_true(adg_ruled_fill_has_vector(ruled_fill));
+
+    adg_ruled_fill_switch_vector(ruled_fill, FALSE);
+    g_assert_false(adg_ruled_fill_has_vector(ruled_fill));
+
+    /* Using GObject property methods */
+    g_object_set(ruled_fill, "vector", TRUE, NULL);
+    g_object_get(ruled_fill, "vector", &vector, NULL);
+    g_assert_true(vector);
+
+    g_object_set(ruled_fill, "vector", invalid_boolean, NULL);
+    g_object_get(ruled_fill, "vector", &vector, NULL);
+    g_assert_true(vector);
+
+    g_object_set(ruled_fill, "vector", FALSE, NULL);
+    g_object_get(ruled_fill, "vector", &vector, NULL);
+    g_assert_false(vector);
+
+    g_object_unref(ruled_fill);
+}
+
+static cairo_t *
+_adg_hatch_render(AdgPath *path)
+{
+    AdgRuledFill *ruled_fill;
+    AdgHatch *hatch;
+    cairo_t *cr;
+
+    /* At 45 degrees this spacing gives the x + y = 10 + 20 * k lines,
+     * as the (10 + 20 * k, 0) and (0, 10 + 20 * k) points are joined */
+    ruled_fill = adg_ruled_fill_new();
+    adg_ruled_fill_set_spacing(ruled_fill, 20 * G_SQRT2);
+    adg_ruled_fill_switch_vector(ruled_fill, TRUE);
+
+    hatch = adg_hatch_new(ADG_TRAIL(path));
+    adg_entity_set_style(ADG_ENTITY(hatch), ADG_DRESS_FILL_HATCH,
+                         (AdgStyle *) ruled_fill);
+    g_object_unref(ruled_fill);
+
+    cr = adg_test_cairo_context();
+    adg_entity_render(ADG_ENTITY(hatch), cr);
+    adg_entity_destroy(ADG_ENTITY(hatch));
+
+    return cr;
+}
+
+static void
+_adg_behavior_vector(void)
+{
+    AdgPath *path;
+    cairo_t *cr;
+
+    /* Rectangle: the x + y = 30 line passes through the (30, 0) corner
+     * and the x + y = 50 line only touches the (30, 20) corner */
+    path = adg_path_new();
+    adg_path_move_to_explicit(path, 0, 0);
+    adg_path_line_to_explicit(path, 30, 0);
+    adg_path_line_to_explicit(path, 30, 20);
+    adg_path_line_to_explicit(path, 0, 20);
+    adg_path_close(path);
+
+    cr = _adg_hatch_render(path);
+    g_assert_true(adg_test_cairo_is_painted(cr, 4, 5));
+    g_assert_true(adg_test_cairo_is_painted(cr, 19, 10));
+    g_assert_false(adg_test_cairo_is_painted(cr, 35, 14));
+    cairo_destroy(cr);
+    g_object_unref(path);
+
+    /* L shape with a fillet in the inner corner: the x + y = 50 line
+     * touches the (40, 10) and (10, 40) corners only, while the
+     * x + y = 30 line passes through both ends of the arc */
+    path = adg_path_new();
+    adg_path_move_to_explicit(path, 0, 0);
+    adg_path_line_to_explicit(path, 40, 0);
+    adg_path_line_to_explicit(path, 40, 10);
+    adg_path_line_to_explicit(path, 20, 10);
+    adg_path_arc_to_explicit(path, 20 - 5 * G_SQRT2, 20 - 5 * G_SQRT2, 10, 20);
+    adg_path_line_to_explicit(path, 10, 40);
+    adg_path_line_to_explicit(path, 0, 40);
+    adg_path_close(path);
+
+    cr = _adg_hatch_render(path);
+    g_assert_true(adg_test_cairo_is_painted(cr, 24, 5));
+    g_assert_true(adg_test_cairo_is_painted(cr, 4, 25));
+    g_assert_false(adg_test_cairo_is_painted(cr, 14, 15));
+    g_assert_false(adg_test_cairo_is_painted(cr, 24, 25));
+    cairo_destroy(cr);
+    g_object_unref(path);
+}
+
 
 int
 main(int argc, char *argv[])
@@ -156,6 +263,9 @@ main(int argc, char *argv[])
     g_test_add_func("/adg/ruled-fill/property/angle", _adg_property_angle);
     g_test_add_func("/adg/ruled-fill/property/line-dress", _adg_property_line_dress);
     g_test_add_func("/adg/ruled-fill/property/spacing", _adg_property_spacing);
+    g_test_add_func("/adg/ruled-fill/property/vector", _adg_property_vector);
+
+    g_test_add_func("/adg/ruled-fill/behavior/vector", _adg_behavior_vector);
 
     return g_test_run();
 }
@@ -162,6 +162,80 @@ _adg_method_put_segment(void)
     g_object_unref(path);
 }
 
+static void
+_adg_method_get_segment_extents(void)
+{
+    AdgPath *path;
+    AdgTrail *trail;
+    const CpmlExtents *extents;
+
+    path = adg_path_new();
+    trail = ADG_TRAIL(path);
+
+    adg_path_move_to_explicit(path, 1, 2);
+    adg_path_line_to_explicit(path, 3, 4);
+    adg_path_move_to_explicit(path, 5, 6);
+    adg_path_line_to_explicit(path, 7, 9);
+
+    /* Sanity checks */
+    g_assert_null(adg_trail_get_segment_extents(NULL, 1));
+    g_assert_null(adg_trail_get_segment_extents(trail, 0));
+    g_assert_null(adg_trail_get_segment_extents(trail, 3));
+
+    extents = adg_trail_get_segment_extents(trail, 2);
+    g_assert_nonnull(extents);
+    g_assert_true(extents->is_defined);
+    adg_assert_isapprox(extents->org.x, 5);
+    adg_assert_isapprox(extents->org.y, 6);
+    adg_assert_isapprox(extents->size.x, 2);
+    adg_assert_isapprox(extents->size.y, 3);
+
+    extents = adg_trail_get_extents(trail);
+    adg_assert_isapprox(extents->org.x, 1);
+    adg_assert_isapprox(extents->size.y, 7);
+
+    /* Appending must invalidate the segment index */
+    adg_path_move_to_explicit(path, -1, 0);
+    adg_path_line_to_explicit(path, 0, 0);
+    g_assert_cmpuint(adg_trail_n_segments(trail), ==, 3);
+    extents = adg_trail_get_segment_extents(trail, 3);
+    g_assert_nonnull(extents);
+    adg_assert_isapprox(extents->org.x, -1);
+    extents = adg_trail_get_extents(trail);
+    adg_assert_isapprox(extents->org.x, -1);
+
+    g_object_unref(path);
+}
+
+static void
+_adg_method_get_segment_length(void)
+{
+    AdgPath *path;
+    AdgTrail *trail;
+
+    path = adg_path_new();
+    trail = ADG_TRAIL(path);
+
+    adg_path_move_to_explicit(path, 0, 0);
+    adg_path_line_to_explicit(path, 3, 4);
+    adg_path_move_to_explicit(path, 0, 0);
+    adg_path_line_to_explicit(path, 0, 2);
+    adg_path_line_to_explicit(path, 1, 2);
+
+    /* Sanity checks */
+    adg_assert_isapprox(adg_trail_get_segment_length(NULL, 1), 0);
+    adg_assert_isapprox(adg_trail_get_segment_length(trail, 0), 0);
+    adg_assert_isapprox(adg_trail_get_segment_length(trail, 3), 0);
+
+    adg_assert_isapprox(adg_trail_get_segment_length(trail, 1), 5);
+    adg_assert_isapprox(adg_trail_get_segment_length(trail, 2), 3);
+
+    /* Check the cached value is returned again */
+    adg_assert_isapprox(adg_trail_get_segment_length(trail, 1), 5);
+
+    g_object_unref(path);
+}
+
 
 int
 main(int argc, char *argv[])
@@ -175,6 +249,8 @@ main(int argc, char *argv[])
 
     g_test_add_func("/adg/trail/method/n-segments", _adg_method_n_segments);
     g_test_add_func("/adg/trail/method/put-segment", _adg_method_put_segment);
+    g_test_add_func("/adg/trail/method/get-segment-extents", _adg_method_get_segment_extents);
+    g_test_add_func("/adg/trail/method/get-segment-length", _adg_method_get_segment_length);
 
     return g_test_run();
 }
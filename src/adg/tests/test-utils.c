@@ -91,6 +91,33 @@ _adg_method_find_file(void)
     g_free(result);
 }
 
+static void
+_adg_method_scale_parse(void)
+{
+    gdouble numerator, denominator;
+
+    g_assert_false(adg_scale_parse(NULL, &numerator, &denominator));
+    g_assert_true(adg_scale_parse("", NULL, NULL));
+
+    g_assert_true(adg_scale_parse("3", &numerator, &denominator));
+    adg_assert_isapprox(numerator, 3);
+    adg_assert_isapprox(denominator, 1);
+
+    g_assert_true(adg_scale_parse(" +5 : 05 garbage", &numerator, &denominator));
+    adg_assert_isapprox(numerator, 5);
+    adg_assert_isapprox(denominator, 5);
+
+    g_assert_true(adg_scale_parse("1.5:0.25", &numerator, &denominator));
+    adg_assert_isapprox(numerator, 1.5);
+    adg_assert_isapprox(denominator, 0.25);
+
+    g_assert_false(adg_scale_parse("1:0", &numerator, &denominator));
+    adg_assert_isapprox(numerator, 1);
+    adg_assert_isapprox(denominator, 0);
+
+    g_assert_false(adg_scale_parse("1:", NULL, NULL));
+}
+
 static void
 _adg_method_scale_factor(void)
 {
@@ -221,6 +248,7 @@ main(int argc, char *argv[])
     g_test_add_func("/adg/method/is-boolean-value", _adg_method_is_boolean_value);
     g_test_add_func("/adg/method/string-replace", _adg_method_string_replace);
     g_test_add_func("/adg/method/find-file", _adg_method_find_file);
+    g_test_add_func("/adg/method/scale-parse", _adg_method_scale_parse);
     g_test_add_func("/adg/method/scale-factor", _adg_method_scale_factor);
     g_test_add_func("/adg/method/type-from-filename", _adg_method_type_from_filename);
     g_test_add_func("/adg/method/clone", _adg_method_clone);
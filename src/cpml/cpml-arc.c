@@ -64,9 +64,7 @@
  * <title>TODO</title>
  * <itemizedlist>
  * <listitem>the <function>get_closest_pos</function> method must be
- *    implemented;</listitem>
- * <listitem>the <function>put_intersections</function> method must
- *    implement arc-arc intersections.</listitem>
+ *    implemented.</listitem>
  * </itemizedlist>
  * </important>
  *
@@ -124,6 +122,11 @@ static int      circle_line             (const CpmlPair         *center,
                                          const CpmlPair         *p1,
                                          const CpmlPair         *p2,
                                          CpmlPair               *dest);
+static int      circle_circle           (const CpmlPair         *center1,
+                                         double                  r1,
+                                         const CpmlPair         *center2,
+                                         double                  r2,
+                                         CpmlPair               *dest);
 
 
 const _CpmlPrimitiveClass *
@@ -410,26 +413,44 @@ static size_t
 put_intersections(const CpmlPrimitive *arc, const CpmlPrimitive *primitive,
                   size_t n_dest, CpmlPair *dest)
 {
-    CpmlPair center;
-    double r;
+    CpmlPair center, center2, pair[2];
+    double r, r2;
+    size_t n;
 
-    cpml_arc_info(arc, &center, &r, NULL, NULL);
+    if (!cpml_arc_info(arc, &center, &r, NULL, NULL))
+        return 0;
 
     switch ((int) cpml_primitive_type(primitive)) {
 
-    case CPML_LINE: {
+    case CPML_LINE:
+    case CPML_CLOSE: {
         CpmlPair p1, p2;
         cpml_primitive_put_point(primitive, 0, &p1);
         cpml_primitive_put_point(primitive, -1, &p2);
-        return circle_line(&center, r, &p1, &p2, dest);
+        n = circle_line(&center, r, &p1, &p2, pair);
+        break;
     }
 
     case CPML_ARC:
-        /* TODO: Not Yet Implemented */
+        if (!cpml_arc_info(primitive, &center2, &r2, NULL, NULL))
+            return 0;
+        n = circle_circle(&center, r, &center2, r2, pair);
+        break;
+
+    default:
         return 0;
     }
 
-    return 0;
+    /* Do not overflow the destination buffer */
+    if (n > n_dest)
+        n = n_dest;
+
+    if (n > 0)
+        cpml_pair_copy(&dest[0], &pair[0]);
+    if (n > 1)
+        cpml_pair_copy(&dest[1], &pair[1]);
+
+    return n;
 }
 
 static void
@@ -615,3 +636,49 @@ circle_line(const CpmlPair *center, double r,
     dest->y = (b*c - a*d) / e + center->y;
     return 2;
 }
+
+static int
+circle_circle(const CpmlPair *center1, double r1,
+              const CpmlPair *center2, double r2,
+              CpmlPair *dest)
+{
+    double dx, dy, d2, d, a, h2, h;
+    CpmlPair middle;
+
+    dx = center2->x - center1->x;
+    dy = center2->y - center1->y;
+    d2 = dx*dx + dy*dy;
+
+    /* Concentric circles: no intersections or infinite ones */
+    if (d2 == 0)
+        return 0;
+
+    d = sqrt(d2);
+
+    /* Circles too far apart or one inside the other */
+    if (d > r1 + r2 || d < fabs(r1 - r2))
+        return 0;
+
+    /* a is the distance from center1 to the chord joining the two
+     * intersections, h is half the length of that chord */
+    a = (r1*r1 - r2*r2 + d2) / (2*d);
+    h2 = r1*r1 - a*a;
+
+    middle.x = center1->x + a*dx/d;
+    middle.y = center1->y + a*dy/d;
+
+    if (h2 <= 0) {
+        /* Only one solution found (tangent circles) */
+        cpml_pair_copy(dest, &middle);
+        return 1;
+    }
+
+    h = sqrt(h2);
+
+    dest->x = middle.x - h*dy/d;
+    dest->y = middle.y + h*dx/d;
+    ++ dest;
+    dest->x = middle.x + h*dy/d;
+    dest->y = middle.y - h*dx/d;
+    return 2;
+}
@@ -29,25 +29,18 @@
  * only when you are sure the <varname>primitive</varname> argument
  * is effectively a cubic Bézier curve.
  *
- * <important>
- * <title>TODO</title>
- * <itemizedlist>
- * <listitem>the <function>get_length</function> method must be
- *           implemented;</listitem>
- * <listitem>actually the <function>put_extents</function> method is
- *           implemented by computing the bounding box of the control
- *           polygon and this will likely include some empty space:
- *           there is room for improvements;</listitem>
- * <listitem>the <function>put_pair_at</function> method must be
- *           implemented;</listitem>
- * <listitem>the <function>put_vector_at</function> method must be
- *           implemented;</listitem>
- * <listitem>the <function>get_closest_pos</function> method must be
- *           implemented;</listitem>
- * <listitem>the <function>put_intersections</function> method must be
- *           implemented;</listitem>
- * </itemizedlist>
- * </important>
+ * Differently from the "time" based APIs provided here, the generic
+ * #CpmlPrimitive methods use an arc-length parameterization: the
+ * position 0.5 passed to cpml_primitive_put_pair_at() is the point
+ * that splits the curve in two halves of the same length. The length
+ * is computed by adaptive Gauss-Legendre quadrature and the "time"
+ * corresponding to a position is then found with a Newton iteration.
+ *
+ * The extents are the tight bounding box of the curve, computed by
+ * finding the roots of the derivative. The intersections with lines
+ * and arcs are found by isolating the roots of the implicit equation
+ * in Bernstein form, the intersections between two curves by
+ * subdivision of the curves that can overlap.
  *
  * Since: 1.0
  **/
@@ -90,29 +83,102 @@
 #include "cpml-segment.h"
 #include "cpml-primitive.h"
 #include "cpml-primitive-private.h"
+#include "cpml-arc.h"
 #include "cpml-curve.h"
+#include <math.h>
 
 #define DEFAULT_ALGORITHM   offset_handcraft
 
+/* Relative tolerance used by the numerical algorithms */
+#define TOLERANCE           1e-10
+
+/* Maximum recursion depth of the subdivision algorithms */
+#define MAX_DEPTH           48
+
+/* Room needed by bernstein_roots() for a polynomial of the given degree:
+ * adjacent intervals of the subdivision can isolate the same root, so
+ * any root can be reported twice */
+#define MAX_ROOTS(degree)   (2 * (degree))
 
+/* Macro to save typing in the numerical algorithms */
+#define VECTOR_LENGTH(v)    sqrt((v).x * (v).x + (v).y * (v).y)
+
+
+static double   get_length              (const CpmlPrimitive    *curve);
 static void     put_extents             (const CpmlPrimitive    *curve,
                                          CpmlExtents            *extents);
+static void     put_pair_at             (const CpmlPrimitive    *curve,
+                                         double                  pos,
+                                         CpmlPair               *pair);
+static void     put_vector_at           (const CpmlPrimitive    *curve,
+                                         double                  pos,
+                                         CpmlVector             *vector);
+static double   get_closest_pos         (const CpmlPrimitive    *curve,
+                                         const CpmlPair         *pair);
+static size_t   put_intersections       (const CpmlPrimitive    *curve,
+                                         const CpmlPrimitive    *primitive,
+                                         size_t                  n_dest,
+                                         CpmlPair               *dest);
 static void     offset_geometrical      (CpmlPrimitive          *curve,
                                          double                  offset);
 static void     offset_handcraft        (CpmlPrimitive          *curve,
                                          double                  offset);
 static void     offset_baioca           (CpmlPrimitive          *curve,
                                          double                  offset);
+static void     get_points              (const CpmlPrimitive    *curve,
+                                         CpmlPair               *p);
+static void     pair_at_time            (const CpmlPair         *p,
+                                         double                  t,
+                                         CpmlPair               *pair);
+static void     vector_at_time          (const CpmlPair         *p,
+                                         double                  t,
+                                         CpmlVector             *vector);
+static double   gauss_length            (const CpmlPair         *p,
+                                         double                  t1,
+                                         double                  t2);
+static double   adaptive_length         (const CpmlPair         *p,
+                                         double                  t1,
+                                         double                  t2,
+                                         double                  whole,
+                                         int                     depth);
+static double   get_partial_length      (const CpmlPair         *p,
+                                         double                  t1,
+                                         double                  t2);
+static double   get_time                (const CpmlPair         *p,
+                                         double                  pos);
+static size_t   bernstein_roots         (const double           *w,
+                                         int                     degree,
+                                         double                  t1,
+                                         double                  t2,
+                                         int                     depth,
+                                         size_t                  n_dest,
+                                         double                 *dest);
+static size_t   curve_roots             (const CpmlPair         *p,
+                                         const double           *w,
+                                         int                     degree,
+                                         size_t                  n_dest,
+                                         CpmlPair               *dest);
+static void     split                   (const CpmlPair         *p,
+                                         CpmlPair               *left,
+                                         CpmlPair               *right);
+static double   flatness                (const CpmlPair         *p);
+static size_t   curve_curve             (const CpmlPair         *p,
+                                         const CpmlPair         *q,
+                                         double                  tolerance,
+                                         int                     depth,
+                                         size_t                  n_dest,
+                                         CpmlPair               *dest,
+                                         size_t                  n);
 
 /* class_data is outside get_class so it can be modified by other methods */
 static _CpmlPrimitiveClass class_data = {
     "curve to", 4,
-    NULL,
+    get_length,
     put_extents,
-    NULL,
-    NULL,
-    NULL,
-    NULL,
+    put_pair_at,
+    put_vector_at,
+    get_closest_pos,
+    put_intersections,
     DEFAULT_ALGORITHM,
     NULL
 };
@@ -136,10 +202,12 @@ _cpml_curve_get_class(void)
  * knowing which is the current algorithm used.
  *
  * <important><para>
- * This function is <emphasis>not thread-safe</emphasis>. If you
- * are changing the algorithm in a thread environment you must
- * ensure by yourself no other threads are calling #CpmlCurve
- * methods in the meantime.
+ * The algorithm is a process-wide setting. Only changing it is
+ * <emphasis>not thread-safe</emphasis>: querying it (by passing
+ * #CPML_CURVE_OFFSET_ALGORITHM_NONE) and offsetting curves can be
+ * freely done from any thread. Select the algorithm once, before
+ * starting any thread that could call #CpmlCurve methods, and do
+ * not change it until they are done.
  * </para></important>
  *
  * Returns: the previous algorithm used.
@@ -150,13 +218,16 @@ CpmlCurveOffsetAlgorithm
 cpml_curve_offset_algorithm(CpmlCurveOffsetAlgorithm new_algorithm)
 {
     CpmlCurveOffsetAlgorithm old_algorithm;
+    void (*offset)(CpmlPrimitive *, double);
 
-    /* Reverse lookup of the algorithm used */
-    if (class_data.offset == offset_handcraft) {
+    /* Reverse lookup of the algorithm used, done on a single read
+     * of the method so a concurrent switch cannot mix the results */
+    offset = class_data.offset;
+    if (offset == offset_handcraft) {
         old_algorithm = CPML_CURVE_OFFSET_ALGORITHM_HANDCRAFT;
-    } else if (class_data.offset == offset_baioca) {
+    } else if (offset == offset_baioca) {
         old_algorithm = CPML_CURVE_OFFSET_ALGORITHM_BAIOCA;
-    } else if (class_data.offset == offset_geometrical) {
+    } else if (offset == offset_geometrical) {
         old_algorithm = CPML_CURVE_OFFSET_ALGORITHM_GEOMETRICAL;
     } else {
         old_algorithm = CPML_CURVE_OFFSET_ALGORITHM_NONE;
@@ -199,24 +270,10 @@ void
 cpml_curve_put_pair_at_time(const CpmlPrimitive *curve, double t,
                             CpmlPair *pair)
 {
-    CpmlPair p1, p2, p3, p4;
-    double t_2, t_3, t1, t1_2, t1_3;
-
-    cpml_primitive_put_point(curve, 0, &p1);
-    cpml_primitive_put_point(curve, 1, &p2);
-    cpml_primitive_put_point(curve, 2, &p3);
-    cpml_primitive_put_point(curve, 3, &p4);
-
-    t_2 = t * t;
-    t_3 = t_2 * t;
-    t1 = 1 - t;
-    t1_2 = t1 * t1;
-    t1_3 = t1_2 * t1;
+    CpmlPair p[4];
 
-    pair->x = t1_3 * p1.x + 3 * t1_2 * t * p2.x
-              + 3 * t1 * t_2 * p3.x + t_3 * p4.x;
-    pair->y = t1_3 * p1.y + 3 * t1_2 * t * p2.y
-              + 3 * t1 * t_2 * p3.y + t_3 * p4.y;
+    get_points(curve, p);
+    pair_at_time(p, t, pair);
 }
 
 /**
@@ -236,28 +293,10 @@ void
 cpml_curve_put_vector_at_time(const CpmlPrimitive *curve,
                               double t, CpmlVector *vector)
 {
-    CpmlPair p1, p2, p3, p4;
-    CpmlPair p21, p32, p43;
-    double t1, t1_2, t_2;
-
-    cpml_primitive_put_point(curve, 0, &p1);
-    cpml_primitive_put_point(curve, 1, &p2);
-    cpml_primitive_put_point(curve, 2, &p3);
-    cpml_primitive_put_point(curve, 3, &p4);
-
-    p21.x = p2.x - p1.x;
-    p21.y = p2.y - p1.y;
-    p32.x = p3.x - p2.x;
-    p32.y = p3.y - p2.y;
-    p43.x = p4.x - p3.x;
-    p43.y = p4.y - p3.y;
-
-    t1 = 1 - t;
-    t1_2 = t1 * t1;
-    t_2 = t * t;
+    CpmlPair p[4];
 
-    vector->x = 3 * t1_2 * p21.x + 6 * t1 * t * p32.x + 3 * t_2 * p43.x;
-    vector->y = 3 * t1_2 * p21.y + 6 * t1 * t * p32.y + 3 * t_2 * p43.y;
+    get_points(curve, p);
+    vector_at_time(p, t, vector);
 }
 
 /**
@@ -293,22 +332,579 @@ cpml_curve_put_offset_at_time(const CpmlPrimitive *curve,
     pair->y += vector.y;
 }
 
+static double
+get_length(const CpmlPrimitive *curve)
+{
+    CpmlPair p[4];
+
+    get_points(curve, p);
+    return get_partial_length(p, 0, 1);
+}
+
 static void
 put_extents(const CpmlPrimitive *curve, CpmlExtents *extents)
 {
-    CpmlPair p1, p2, p3, p4;
+    CpmlPair p[4], pair;
+    double a, b, c, d, t[4];
+    int n, i;
 
     extents->is_defined = 0;
 
-    cpml_primitive_put_point(curve, 0, &p1);
-    cpml_primitive_put_point(curve, 1, &p2);
-    cpml_primitive_put_point(curve, 2, &p3);
-    cpml_primitive_put_point(curve, 3, &p4);
+    get_points(curve, p);
+    cpml_extents_pair_add(extents, &p[0]);
+    cpml_extents_pair_add(extents, &p[3]);
+
+    /* The extremes of B(t) are at the roots of its derivative, that is
+     * a t² + b t + c = 0 for every coordinate */
+    n = 0;
+    for (i = 0; i < 2; ++i) {
+        double p0 = i ? p[0].y : p[0].x;
+        double p1 = i ? p[1].y : p[1].x;
+        double p2 = i ? p[2].y : p[2].x;
+        double p3 = i ? p[3].y : p[3].x;
+
+        a = p3 - p0 + 3 * (p1 - p2);
+        b = 2 * (p0 - 2 * p1 + p2);
+        c = p1 - p0;
+
+        if (fabs(a) <= TOLERANCE * (fabs(b) + fabs(c))) {
+            /* Degenerated to a linear equation */
+            if (b != 0)
+                t[n++] = -c / b;
+        } else {
+            d = b * b - 4 * a * c;
+            if (d >= 0) {
+                d = sqrt(d);
+                t[n++] = (-b + d) / (2 * a);
+                t[n++] = (-b - d) / (2 * a);
+            }
+        }
+    }
+
+    for (i = 0; i < n; ++i) {
+        if (t[i] > 0 && t[i] < 1) {
+            pair_at_time(p, t[i], &pair);
+            cpml_extents_pair_add(extents, &pair);
+        }
+    }
+}
+
+static void
+put_pair_at(const CpmlPrimitive *curve, double pos, CpmlPair *pair)
+{
+    CpmlPair p[4];
+
+    get_points(curve, p);
+
+    if (pos == 0.) {
+        cpml_pair_copy(pair, &p[0]);
+    } else if (pos == 1.) {
+        cpml_pair_copy(pair, &p[3]);
+    } else {
+        pair_at_time(p, get_time(p, pos), pair);
+    }
+}
+
+static void
+put_vector_at(const CpmlPrimitive *curve, double pos, CpmlVector *vector)
+{
+    CpmlPair p[4];
+
+    get_points(curve, p);
+    vector_at_time(p, get_time(p, pos), vector);
+}
+
+static double
+get_closest_pos(const CpmlPrimitive *curve, const CpmlPair *pair)
+{
+    /* Binomial coefficients */
+    static const double c2[] = { 1, 2, 1 };
+    static const double c3[] = { 1, 3, 3, 1 };
+    static const double c5[] = { 1, 5, 10, 10, 5, 1 };
+    CpmlPair p[4], q[4], d[3], b;
+    double w[6], t[MAX_ROOTS(5) + 2], best_t, best, distance, length;
+    size_t n, k;
+    int i, j;
+
+    get_points(curve, p);
+
+    /* The closest point is at a root of (B(t) - pair) · B'(t), a
+     * polynomial of 5th degree expressed here in Bernstein form */
+    for (i = 0; i < 4; ++i) {
+        q[i].x = p[i].x - pair->x;
+        q[i].y = p[i].y - pair->y;
+    }
+    for (j = 0; j < 3; ++j) {
+        d[j].x = p[j+1].x - p[j].x;
+        d[j].y = p[j+1].y - p[j].y;
+    }
+    for (i = 0; i < 6; ++i)
+        w[i] = 0;
+    for (i = 0; i < 4; ++i)
+        for (j = 0; j < 3; ++j)
+            w[i+j] += c3[i] * c2[j] * (q[i].x * d[j].x + q[i].y * d[j].y);
+    for (i = 0; i < 6; ++i)
+        w[i] /= c5[i];
+
+    n = bernstein_roots(w, 5, 0, 1, 0, MAX_ROOTS(5), t);
+
+    /* The end points are always candidates */
+    t[n++] = 0;
+    t[n++] = 1;
+
+    best_t = 0;
+    best = -1;
+    for (k = 0; k < n; ++k) {
+        pair_at_time(p, t[k], &b);
+        distance = cpml_pair_squared_distance(&b, pair);
+        if (best < 0 || distance < best) {
+            best = distance;
+            best_t = t[k];
+        }
+    }
+
+    /* Convert the time to an homogeneous position */
+    length = get_partial_length(p, 0, 1);
+    if (length == 0 || best_t == 0 || best_t == 1)
+        return best_t;
+
+    return get_partial_length(p, 0, best_t) / length;
+}
+
+static size_t
+put_intersections(const CpmlPrimitive *curve, const CpmlPrimitive *primitive,
+                  size_t n_dest, CpmlPair *dest)
+{
+    CpmlPair p[4];
+    double w[7];
+    int i;
+
+    get_points(curve, p);
+
+    switch ((int) cpml_primitive_type(primitive)) {
+
+    case CPML_LINE:
+    case CPML_CLOSE: {
+        CpmlPair p1, p2;
+        CpmlVector v;
+
+        cpml_primitive_put_point(primitive, 0, &p1);
+        cpml_primitive_put_point(primitive, -1, &p2);
+        v.x = p2.x - p1.x;
+        v.y = p2.y - p1.y;
+        if (v.x == 0 && v.y == 0)
+            return 0;
+
+        /* The implicit equation of the line is linear, so the Bernstein
+         * coefficients of f(B(t)) are f() applied to the control points */
+        for (i = 0; i < 4; ++i)
+            w[i] = (p[i].x - p1.x) * v.y - (p[i].y - p1.y) * v.x;
+
+        return curve_roots(p, w, 3, n_dest, dest);
+    }
+
+    case CPML_ARC: {
+        /* Binomial coefficients */
+        static const double c3[] = { 1, 3, 3, 1 };
+        static const double c6[] = { 1, 6, 15, 20, 15, 6, 1 };
+        CpmlPair center, q[4];
+        double r;
+        int j;
+
+        if (!cpml_arc_info(primitive, &center, &r, NULL, NULL))
+            return 0;
+
+        /* The implicit equation of the circle, |B(t) - center|² - r²,
+         * is a polynomial of 6th degree in t */
+        for (i = 0; i < 4; ++i) {
+            q[i].x = p[i].x - center.x;
+            q[i].y = p[i].y - center.y;
+        }
+        for (i = 0; i < 7; ++i)
+            w[i] = 0;
+        for (i = 0; i < 4; ++i)
+            for (j = 0; j < 4; ++j)
+                w[i+j] += c3[i] * c3[j] * (q[i].x * q[j].x + q[i].y * q[j].y);
+        for (i = 0; i < 7; ++i)
+            w[i] = w[i] / c6[i] - r*r;
+
+        return curve_roots(p, w, 6, n_dest, dest);
+    }
+
+    case CPML_CURVE: {
+        CpmlPair q[4];
+        CpmlExtents extents;
+
+        get_points(primitive, q);
+
+        /* Use a tolerance proportional to the size of the curves */
+        extents.is_defined = 0;
+        for (i = 0; i < 4; ++i) {
+            cpml_extents_pair_add(&extents, &p[i]);
+            cpml_extents_pair_add(&extents, &q[i]);
+        }
+
+        return curve_curve(p, q,
+                           TOLERANCE * (extents.size.x + extents.size.y),
+                           0, n_dest, dest, 0);
+    }
+    }
+
+    return 0;
+}
+
+static void
+get_points(const CpmlPrimitive *curve, CpmlPair *p)
+{
+    cpml_pair_from_cairo(&p[0], curve->org);
+    cpml_pair_from_cairo(&p[1], &curve->data[1]);
+    cpml_pair_from_cairo(&p[2], &curve->data[2]);
+    cpml_pair_from_cairo(&p[3], &curve->data[3]);
+}
+
+static void
+pair_at_time(const CpmlPair *p, double t, CpmlPair *pair)
+{
+    double t_2, t_3, t1, t1_2, t1_3;
+
+    t_2 = t * t;
+    t_3 = t_2 * t;
+    t1 = 1 - t;
+    t1_2 = t1 * t1;
+    t1_3 = t1_2 * t1;
+
+    pair->x = t1_3 * p[0].x + 3 * t1_2 * t * p[1].x
+              + 3 * t1 * t_2 * p[2].x + t_3 * p[3].x;
+    pair->y = t1_3 * p[0].y + 3 * t1_2 * t * p[1].y
+              + 3 * t1 * t_2 * p[2].y + t_3 * p[3].y;
+}
+
+static void
+vector_at_time(const CpmlPair *p, double t, CpmlVector *vector)
+{
+    CpmlPair p21, p32, p43;
+    double t1, t1_2, t_2;
+
+    p21.x = p[1].x - p[0].x;
+    p21.y = p[1].y - p[0].y;
+    p32.x = p[2].x - p[1].x;
+    p32.y = p[2].y - p[1].y;
+    p43.x = p[3].x - p[2].x;
+    p43.y = p[3].y - p[2].y;
+
+    t1 = 1 - t;
+    t1_2 = t1 * t1;
+    t_2 = t * t;
+
+    vector->x = 3 * t1_2 * p21.x + 6 * t1 * t * p32.x + 3 * t_2 * p43.x;
+    vector->y = 3 * t1_2 * p21.y + 6 * t1 * t * p32.y + 3 * t_2 * p43.y;
+}
+
+/* 5 points Gauss-Legendre quadrature of the speed |B'(t)| in t1..t2 */
+static double
+gauss_length(const CpmlPair *p, double t1, double t2)
+{
+    static const double x[] = {
+        0., 0.5384693101056831, 0.9061798459386640
+    };
+    static const double w[] = {
+        0.5688888888888889, 0.4786286704993665, 0.2369268850561891
+    };
+    double half, middle, sum;
+    CpmlVector v;
+    int i;
+
+    half = (t2 - t1) / 2;
+    middle = (t1 + t2) / 2;
+
+    vector_at_time(p, middle, &v);
+    sum = w[0] * VECTOR_LENGTH(v);
+
+    for (i = 1; i < 3; ++i) {
+        vector_at_time(p, middle - half * x[i], &v);
+        sum += w[i] * VECTOR_LENGTH(v);
+        vector_at_time(p, middle + half * x[i], &v);
+        sum += w[i] * VECTOR_LENGTH(v);
+    }
+
+    return sum * half;
+}
+
+static double
+adaptive_length(const CpmlPair *p, double t1, double t2,
+                double whole, int depth)
+{
+    double middle, left, right;
+
+    middle = (t1 + t2) / 2;
+    left = gauss_length(p, t1, middle);
+    right = gauss_length(p, middle, t2);
+
+    if (depth >= MAX_DEPTH / 4 ||
+        fabs(left + right - whole) <= TOLERANCE * fabs(left + right))
+        return left + right;
+
+    return adaptive_length(p, t1, middle, left, depth + 1) +
+           adaptive_length(p, middle, t2, right, depth + 1);
+}
+
+static double
+get_partial_length(const CpmlPair *p, double t1, double t2)
+{
+    if (t1 == t2)
+        return 0;
+
+    return adaptive_length(p, t1, t2, gauss_length(p, t1, t2), 0);
+}
+
+/* Converts an homogeneous position into a "time" value, that is
+ * solves get_partial_length(p, 0, t) = pos * length for t */
+static double
+get_time(const CpmlPair *p, double pos)
+{
+    double length, target, current, t, lower, upper, next;
+    CpmlVector v;
+    int n;
+
+    length = get_partial_length(p, 0, 1);
+    if (length == 0)
+        return pos;
+
+    target = pos * length;
+    t = pos;
+    current = get_partial_length(p, 0, t);
+
+    /* Keep a bracket only inside 0..1: outside of it, pos is an
+     * extrapolation and plain Newton is used */
+    lower = 0;
+    upper = 1;
+
+    for (n = 0; n < MAX_DEPTH; ++n) {
+        if (fabs(current - target) <= TOLERANCE * length)
+            break;
+
+        if (pos > 0 && pos < 1) {
+            if (current < target)
+                lower = t;
+            else
+                upper = t;
+        }
+
+        vector_at_time(p, t, &v);
+        next = VECTOR_LENGTH(v);
+        next = next > 0 ? t - (current - target) / next : -1;
+
+        /* Fallback to bisection when Newton goes out of the bracket */
+        if (pos > 0 && pos < 1 && (next <= lower || next >= upper))
+            next = (lower + upper) / 2;
+
+        current += get_partial_length(p, t, next);
+        t = next;
+    }
+
+    return t;
+}
+
+/* Finds the roots in t1..t2 of the polynomial with the Bernstein
+ * coefficients w by recursive subdivision: by the convex hull property
+ * there are no roots when all the coefficients have the same sign */
+static size_t
+bernstein_roots(const double *w, int degree, double t1, double t2,
+                int depth, size_t n_dest, double *dest)
+{
+    double left[7], right[7], tmp[7], min, max, middle;
+    size_t n;
+    int i, j;
+
+    if (n_dest == 0)
+        return 0;
+
+    min = max = w[0];
+    for (i = 1; i <= degree; ++i) {
+        if (w[i] < min)
+            min = w[i];
+        else if (w[i] > max)
+            max = w[i];
+    }
+
+    /* No roots or infinite roots (the polynomial is 0) */
+    if (min > 0 || max < 0 || (min == 0 && max == 0))
+        return 0;
+
+    middle = (t1 + t2) / 2;
+
+    if (depth >= MAX_DEPTH || t2 - t1 <= TOLERANCE) {
+        dest[0] = middle;
+        return 1;
+    }
+
+    /* de Casteljau subdivision at the middle of the interval */
+    for (i = 0; i <= degree; ++i)
+        tmp[i] = w[i];
+    for (i = 0; i <= degree; ++i) {
+        left[i] = tmp[0];
+        right[degree-i] = tmp[degree-i];
+        for (j = 0; j < degree-i; ++j)
+            tmp[j] = (tmp[j] + tmp[j+1]) / 2;
+    }
+
+    n = bernstein_roots(left, degree, t1, middle, depth + 1, n_dest, dest);
+
+    /* Do not report twice a root laying on the middle point */
+    if (n > 0 && left[degree] == 0)
+        -- n;
+
+    return n + bernstein_roots(right, degree, middle, t2, depth + 1,
+                               n_dest - n, dest + n);
+}
+
+/* Finds the points of the p curve where the implicit equation of
+ * another primitive, expressed in Bernstein form by w, is 0 */
+static size_t
+curve_roots(const CpmlPair *p, const double *w, int degree,
+            size_t n_dest, CpmlPair *dest)
+{
+    double t[MAX_ROOTS(6)];
+    size_t n, k, found;
+
+    n = bernstein_roots(w, degree, 0, 1, 0, MAX_ROOTS(degree), t);
+    found = 0;
+
+    for (k = 0; k < n && found < n_dest; ++k) {
+        /* Adjacent intervals can isolate the same root */
+        if (k > 0 && t[k] - t[k-1] <= TOLERANCE * 4)
+            continue;
+        pair_at_time(p, t[k], dest + found);
+        ++ found;
+    }
+
+    return found;
+}
+
+static void
+split(const CpmlPair *p, CpmlPair *left, CpmlPair *right)
+{
+    CpmlPair p12, p23, p34, p123, p234;
+
+    p12.x = (p[0].x + p[1].x) / 2;
+    p12.y = (p[0].y + p[1].y) / 2;
+    p23.x = (p[1].x + p[2].x) / 2;
+    p23.y = (p[1].y + p[2].y) / 2;
+    p34.x = (p[2].x + p[3].x) / 2;
+    p34.y = (p[2].y + p[3].y) / 2;
+    p123.x = (p12.x + p23.x) / 2;
+    p123.y = (p12.y + p23.y) / 2;
+    p234.x = (p23.x + p34.x) / 2;
+    p234.y = (p23.y + p34.y) / 2;
+
+    left[0] = p[0];
+    left[1] = p12;
+    left[2] = p123;
+    left[3].x = (p123.x + p234.x) / 2;
+    left[3].y = (p123.y + p234.y) / 2;
+
+    right[0] = left[3];
+    right[1] = p234;
+    right[2] = p34;
+    right[3] = p[3];
+}
+
+/* Maximum distance of the inner control points from the chord */
+static double
+flatness(const CpmlPair *p)
+{
+    CpmlVector v;
+    double length, d1, d2;
+
+    v.x = p[3].x - p[0].x;
+    v.y = p[3].y - p[0].y;
+    length = VECTOR_LENGTH(v);
+
+    if (length == 0)
+        return fmax(cpml_pair_distance(&p[0], &p[1]),
+                    cpml_pair_distance(&p[0], &p[2]));
+
+    d1 = fabs((p[1].x - p[0].x) * v.y - (p[1].y - p[0].y) * v.x);
+    d2 = fabs((p[2].x - p[0].x) * v.y - (p[2].y - p[0].y) * v.x);
+
+    return fmax(d1, d2) / length;
+}
+
+/* Intersections between two curves by recursive subdivision: only the
+ * portions with overlapping control polygon extents are considered and,
+ * when both portions are flat enough, their chords are intersected.
+ * n is the number of intersections already stored in dest. */
+static size_t
+curve_curve(const CpmlPair *p, const CpmlPair *q, double tolerance,
+            int depth, size_t n_dest, CpmlPair *dest, size_t n)
+{
+    CpmlExtents p_extents, q_extents;
+    CpmlPair left[4], right[4];
+    double p_flatness, q_flatness;
+    int i;
+
+    if (n >= n_dest)
+        return n;
+
+    p_extents.is_defined = q_extents.is_defined = 0;
+    for (i = 0; i < 4; ++i) {
+        cpml_extents_pair_add(&p_extents, &p[i]);
+        cpml_extents_pair_add(&q_extents, &q[i]);
+    }
+
+    if (!cpml_extents_is_intersecting(&p_extents, &q_extents))
+        return n;
+
+    p_flatness = flatness(p);
+    q_flatness = flatness(q);
+
+    if (depth >= MAX_DEPTH ||
+        (p_flatness <= tolerance && q_flatness <= tolerance)) {
+        CpmlVector u, v;
+        CpmlPair pair;
+        double d, s, t, slack;
+        size_t k;
+
+        u.x = p[3].x - p[0].x;
+        u.y = p[3].y - p[0].y;
+        v.x = q[3].x - q[0].x;
+        v.y = q[3].y - q[0].y;
+        d = u.x * v.y - u.y * v.x;
+
+        /* Parallel or degenerated chords */
+        if (d == 0)
+            return n;
+
+        s = ((q[0].x - p[0].x) * v.y - (q[0].y - p[0].y) * v.x) / d;
+        t = ((q[0].x - p[0].x) * u.y - (q[0].y - p[0].y) * u.x) / d;
+
+        /* Accept intersections slightly outside the chords, as the
+         * duplicates got from adjacent portions are filtered below */
+        slack = TOLERANCE * 1000;
+        if (s < -slack || s > 1 + slack || t < -slack || t > 1 + slack)
+            return n;
+
+        pair.x = p[0].x + u.x * s;
+        pair.y = p[0].y + u.y * s;
+
+        for (k = 0; k < n; ++k)
+            if (cpml_pair_distance(dest + k, &pair) <= tolerance * 1000)
+                return n;
+
+        cpml_pair_copy(dest + n, &pair);
+        return n + 1;
+    }
+
+    /* Split the less flat curve */
+    if (p_flatness >= q_flatness) {
+        split(p, left, right);
+        n = curve_curve(left, q, tolerance, depth + 1, n_dest, dest, n);
+        return curve_curve(right, q, tolerance, depth + 1, n_dest, dest, n);
+    }
 
-    cpml_extents_pair_add(extents, &p1);
-    cpml_extents_pair_add(extents, &p2);
-    cpml_extents_pair_add(extents, &p3);
-    cpml_extents_pair_add(extents, &p4);
+    split(q, left, right);
+    n = curve_curve(p, left, tolerance, depth + 1, n_dest, dest, n);
+    return curve_curve(p, right, tolerance, depth + 1, n_dest, dest, n);
 }
 
 static int
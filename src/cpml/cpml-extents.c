@@ -237,6 +237,32 @@ cpml_extents_pair_is_inside(const CpmlExtents *extents, const CpmlPair *src)
     return 1;
 }
 
+/**
+ * cpml_extents_is_intersecting:
+ * @extents: the first #CpmlExtents
+ * @src:     the second #CpmlExtents
+ *
+ * Checks wheter @extents and @src have at least one point in common.
+ * If any of them is undefined, 0 will be returned. The borders are
+ * considered inside, so two extents sharing only one side are
+ * intersecting.
+ *
+ * Returns: (type gboolean): 1 if @extents and @src intersect, 0 otherwise.
+ *
+ * Since: 1.0
+ **/
+int
+cpml_extents_is_intersecting(const CpmlExtents *extents, const CpmlExtents *src)
+{
+    if (extents->is_defined == 0 || src->is_defined == 0)
+        return 0;
+
+    return src->org.x <= extents->org.x + extents->size.x &&
+           src->org.y <= extents->org.y + extents->size.y &&
+           extents->org.x <= src->org.x + src->size.x &&
+           extents->org.y <= src->org.y + src->size.y;
+}
+
 /**
  * cpml_extents_transform:
  * @extents: (inout): the container #CpmlExtents
@@ -54,6 +54,8 @@ int             cpml_extents_is_inside          (const CpmlExtents *extents,
                                                  const CpmlExtents *src);
 int             cpml_extents_pair_is_inside     (const CpmlExtents *extents,
                                                  const CpmlPair    *src);
+int             cpml_extents_is_intersecting    (const CpmlExtents *extents,
+                                                 const CpmlExtents *src);
 void            cpml_extents_transform          (CpmlExtents       *extents,
                                                  const cairo_matrix_t *matrix);
 
@@ -85,6 +85,14 @@ const _CpmlPrimitiveClass * _cpml_arc_get_class   (void);
 const _CpmlPrimitiveClass * _cpml_curve_get_class (void);
 const _CpmlPrimitiveClass * _cpml_close_get_class (void);
 
+size_t          _cpml_primitive_put_intersections_pruned
+                                        (const CpmlPrimitive    *primitive,
+                                         const CpmlExtents      *extents,
+                                         const CpmlSegment      *segment,
+                                         const CpmlExtents      *segment_extents,
+                                         size_t                  n_dest,
+                                         CpmlPair               *dest);
+
 
 CAIRO_END_DECLS
 
@@ -627,6 +627,10 @@ cpml_primitive_put_intersections(const CpmlPrimitive *primitive,
  * intersections. Check that function documentation to know what virtual and
  * real intersections are.
  *
+ * A real intersection must lie inside the extents of both primitives, so
+ * the primitives of @segment whose extents do not overlap the extents of
+ * @primitive are skipped without running the intersection algorithm.
+ *
  * Returns: the number of real intersections found.
  *
  * Since: 1.0
@@ -635,8 +639,43 @@ size_t
 cpml_primitive_put_intersections_with_segment(const CpmlPrimitive *primitive,
                                               const CpmlSegment *segment,
                                               size_t n_dest, CpmlPair *dest)
+{
+    CpmlExtents extents = { 0 };
+
+    cpml_primitive_put_extents(primitive, &extents);
+
+    return _cpml_primitive_put_intersections_pruned(primitive, &extents,
+                                                    segment, NULL,
+                                                    n_dest, dest);
+}
+
+/*
+ * _cpml_primitive_put_intersections_pruned:
+ * @primitive:       a #CpmlPrimitive
+ * @extents:         the extents of @primitive
+ * @segment:         a #CpmlSegment
+ * @segment_extents: (allow-none): the extents of every primitive
+ *                   of @segment, in the same order
+ * @n_dest:          maximum number of intersections to return
+ * @dest:            the destination buffer
+ *
+ * Implementation of cpml_primitive_put_intersections_with_segment()
+ * that avoids computing the same extents over and over. If
+ * @segment_extents is NULL, the extents of the @segment primitives
+ * are computed on the fly (once per primitive).
+ *
+ * Returns: the number of real intersections found.
+ */
+size_t
+_cpml_primitive_put_intersections_pruned(const CpmlPrimitive *primitive,
+                                         const CpmlExtents *extents,
+                                         const CpmlSegment *segment,
+                                         const CpmlExtents *segment_extents,
+                                         size_t n_dest, CpmlPair *dest)
 {
     CpmlPrimitive portion;
+    CpmlExtents portion_extents;
+    const CpmlExtents *current;
     CpmlPair partial[5];
     const CpmlPair *pair;
     size_t found, total;
@@ -645,14 +684,28 @@ cpml_primitive_put_intersections_with_segment(const CpmlPrimitive *primitive,
     total = 0;
 
     while (total < n_dest) {
-        found = cpml_primitive_put_intersections(&portion, primitive, 5, partial);
-
-        /* Store only real intersections */
-        for (pair = partial; found; -- found, ++ pair) {
-            if (cpml_primitive_is_inside(&portion, pair) &&
-                cpml_primitive_is_inside(primitive, pair)) {
-                cpml_pair_copy(dest+total, pair);
-                ++ total;
+        if (segment_extents != NULL) {
+            current = segment_extents;
+            ++ segment_extents;
+        } else {
+            portion_extents.is_defined = 0;
+            cpml_primitive_put_extents(&portion, &portion_extents);
+            current = &portion_extents;
+        }
+
+        /* A real intersection lies inside both extents: skip the
+         * intersection algorithm when they do not overlap */
+        if (cpml_extents_is_intersecting(current, extents)) {
+            found = cpml_primitive_put_intersections(&portion, primitive,
+                                                     5, partial);
+
+            /* Store only real intersections */
+            for (pair = partial; found && total < n_dest; -- found, ++ pair) {
+                if (cpml_extents_pair_is_inside(current, pair) &&
+                    cpml_extents_pair_is_inside(extents, pair)) {
+                    cpml_pair_copy(dest+total, pair);
+                    ++ total;
+                }
             }
         }
 
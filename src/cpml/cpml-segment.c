@@ -69,6 +69,7 @@
 #include "cpml-extents.h"
 #include "cpml-segment.h"
 #include "cpml-primitive.h"
+#include "cpml-primitive-private.h"
 #include "cpml-curve.h"
 #include <string.h>
 
@@ -365,6 +366,11 @@ cpml_segment_put_vector_at(const CpmlSegment *segment, double pos,
  * scanned for intersections with any primitive in @segment2. This
  * means @segment has a higher precedence over @segment2.
  *
+ * The extents of every primitive are computed only once and the
+ * intersection algorithm is run only on pairs of primitives with
+ * overlapping extents, so long segments sharing only a small area
+ * are intersected quickly.
+ *
  * Returns: the number of intersections found
  *
  * Since: 1.0
@@ -375,19 +381,49 @@ cpml_segment_put_intersections(const CpmlSegment *segment,
                                size_t n_dest, CpmlPair *dest)
 {
     CpmlPrimitive portion;
-    size_t partial, total;
+    CpmlExtents extents, extents2, *cache;
+    size_t n, partial, total;
+
+    /* Cache the extents of the primitives of segment2: they would be
+     * otherwise recomputed for every primitive of segment */
+    cpml_primitive_from_segment(&portion, (CpmlSegment *) segment2);
+    n = 1;
+    while (cpml_primitive_next(&portion))
+        ++ n;
+
+    cache = malloc(n * sizeof(CpmlExtents));
+    extents2.is_defined = 0;
+
+    if (cache != NULL) {
+        cpml_primitive_from_segment(&portion, (CpmlSegment *) segment2);
+        n = 0;
+        do {
+            cache[n].is_defined = 0;
+            cpml_primitive_put_extents(&portion, &cache[n]);
+            cpml_extents_add(&extents2, &cache[n]);
+            ++ n;
+        } while (cpml_primitive_next(&portion));
+    }
 
     cpml_primitive_from_segment(&portion, (CpmlSegment *) segment);
     total = 0;
 
     do {
-        partial = cpml_primitive_put_intersections_with_segment(&portion,
-                                                                segment2,
-                                                                n_dest - total,
-                                                                dest + total);
+        extents.is_defined = 0;
+        cpml_primitive_put_extents(&portion, &extents);
+
+        /* Skip the whole segment2 scan if portion is outside its extents */
+        if (cache != NULL && ! cpml_extents_is_intersecting(&extents, &extents2))
+            continue;
+
+        partial = _cpml_primitive_put_intersections_pruned(&portion, &extents,
+                                                           segment2, cache,
+                                                           n_dest - total,
+                                                           dest + total);
         total += partial;
     } while (total < n_dest && cpml_primitive_next(&portion));
 
+    free(cache);
     return total;
 }
 
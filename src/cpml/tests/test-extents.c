@@ -112,6 +112,44 @@ _cpml_method_add(void)
     g_assert_true(is_inside);
 }
 
+static void
+_cpml_method_is_intersecting(void)
+{
+    CpmlExtents extents = { 1, { 0, 0 }, { 2, 2 } };
+    CpmlExtents extents2 = { 1, { 1, 1 }, { 2, 2 } };
+    CpmlExtents undefined = { 0 };
+
+    g_assert_true(cpml_extents_is_intersecting(&extents, &extents2));
+    g_assert_true(cpml_extents_is_intersecting(&extents2, &extents));
+
+    g_test_message("Undefined extents do not intersect anything");
+    g_assert_false(cpml_extents_is_intersecting(&extents, &undefined));
+    g_assert_false(cpml_extents_is_intersecting(&undefined, &extents));
+
+    g_test_message("Touching extents intersect");
+    extents2.org.x = 2;
+    g_assert_true(cpml_extents_is_intersecting(&extents, &extents2));
+
+    extents2.org.x = 2.5;
+    g_assert_false(cpml_extents_is_intersecting(&extents, &extents2));
+    g_assert_false(cpml_extents_is_intersecting(&extents2, &extents));
+
+    extents2.org.x = -3;
+    g_assert_false(cpml_extents_is_intersecting(&extents, &extents2));
+
+    extents2.org.x = -1;
+    extents2.org.y = -3;
+    g_assert_false(cpml_extents_is_intersecting(&extents, &extents2));
+
+    g_test_message("Extents containing other extents intersect");
+    extents2.org.x = -1;
+    extents2.org.y = -1;
+    extents2.size.x = 10;
+    extents2.size.y = 10;
+    g_assert_true(cpml_extents_is_intersecting(&extents, &extents2));
+    g_assert_true(cpml_extents_is_intersecting(&extents2, &extents));
+}
+
 static void
 _cpml_method_transform(void)
 {
@@ -151,6 +189,7 @@ main(int argc, char *argv[])
     g_test_add_func("/cpml/extents/behavior/misc", _cmpl_behavior_misc);
 
     g_test_add_func("/cpml/extents/method/add", _cpml_method_add);
+    g_test_add_func("/cpml/extents/method/is-intersecting", _cpml_method_is_intersecting);
     g_test_add_func("/cpml/extents/method/transform", _cpml_method_transform);
 
     return g_test_run();
@@ -636,15 +636,15 @@ _cpml_method_put_extents(void)
     g_assert_cmpfloat(extents.size.x, >=, 3);
     g_assert_cmpfloat(extents.size.y, >=, 6);
 
-    /* Curve: actually the extents are computed by using the
-     * convex hull (hence the exact coordinates of the points) */
+    /* Curve: the extents are tight, i.e. smaller than the
+     * bounding box of the control polygon */
     cpml_primitive_next(&primitive);
     cpml_primitive_put_extents(&primitive, &extents);
     g_assert_true(extents.is_defined);
     adg_assert_isapprox(extents.org.x, -2);
     adg_assert_isapprox(extents.org.y, 2);
-    adg_assert_isapprox(extents.size.x, 12);
-    adg_assert_isapprox(extents.size.y, 9);
+    adg_assert_isapprox(extents.size.x, 9.512);
+    adg_assert_isapprox(extents.size.y, 6.706);
 
     /* Close */
     cpml_primitive_next(&primitive);
@@ -689,18 +689,17 @@ _cpml_method_put_pair_at(void)
     adg_assert_isapprox(pair.x, 3.669);
     adg_assert_isapprox(pair.y, 4.415);
 
-    /* Close */
+    /* Curve */
     cpml_primitive_next(&primitive);
-    /* TODO: not yet implemented
-     * cpml_primitive_put_pair_at(&primitive, 0, &pair);
-     * adg_assert_isapprox(pair.x, 6);
-     * adg_assert_isapprox(pair.y, 7);
-     * cpml_primitive_put_pair_at(&primitive, 1, &pair);
-     * adg_assert_isapprox(pair.x, -2);
-     * adg_assert_isapprox(pair.y, 2);
-     * cpml_primitive_put_pair_at(&primitive, 0.5, &pair);
-     * adg_assert_isapprox(pair.x, 1);
-     * adg_assert_isapprox(pair.y, 1); */
+    cpml_primitive_put_pair_at(&primitive, 0, &pair);
+    adg_assert_isapprox(pair.x, 6);
+    adg_assert_isapprox(pair.y, 7);
+    cpml_primitive_put_pair_at(&primitive, 1, &pair);
+    adg_assert_isapprox(pair.x, -2);
+    adg_assert_isapprox(pair.y, 2);
+    cpml_primitive_put_pair_at(&primitive, 0.5, &pair);
+    adg_assert_isapprox(pair.x, 3.604);
+    adg_assert_isapprox(pair.y, 6.148);
 
     /* Close */
     cpml_primitive_next(&primitive);
@@ -748,18 +747,17 @@ _cpml_method_put_vector_at(void)
     adg_assert_isapprox(vector.x, 0.447);
     adg_assert_isapprox(vector.y, 0.894);
 
-    /* Close */
+    /* Curve */
     cpml_primitive_next(&primitive);
-    /* TODO: not yet implemented
-     * cpml_primitive_put_vector_at(&primitive, 0, &vector);
-     * adg_assert_isapprox(vector.x, 6);
-     * adg_assert_isapprox(vector.y, 7);
-     * cpml_primitive_put_vector_at(&primitive, 1, &vector);
-     * adg_assert_isapprox(vector.x, -2);
-     * adg_assert_isapprox(vector.y, 2);
-     * cpml_primitive_put_vector_at(&primitive, 0.5, &vector);
-     * adg_assert_isapprox(vector.x, 1);
-     * adg_assert_isapprox(vector.y, 1); */
+    cpml_primitive_put_vector_at(&primitive, 0, &vector);
+    adg_assert_isapprox(vector.x, 6);
+    adg_assert_isapprox(vector.y, 6);
+    cpml_primitive_put_vector_at(&primitive, 1, &vector);
+    adg_assert_isapprox(vector.x, -36);
+    adg_assert_isapprox(vector.y, -27);
+    cpml_primitive_put_vector_at(&primitive, 0.5, &vector);
+    adg_assert_isapprox(vector.x, -20.970);
+    adg_assert_isapprox(vector.y, -15.191);
 
     /* Close */
     cpml_primitive_next(&primitive);
@@ -809,18 +807,16 @@ _cpml_method_get_closest_pos(void)
      * adg_assert_isapprox(cpml_primitive_get_closest_pos(&primitive, &pair), 1);
      */
 
-    /* Close */
+    /* Curve */
     cpml_primitive_next(&primitive);
-    /* TODO: not yet implemented
-     * pair.x = 6; pair.y = 7;
-     * adg_assert_isapprox(cpml_primitive_get_closest_pos(&primitive, &pair), 0);
-     * pair.x = -2; pair.y = 2;
-     * adg_assert_isapprox(cpml_primitive_get_closest_pos(&primitive, &pair), 1);
-     * pair.x = 10; pair.y = 10;
-     * adg_assert_isapprox(cpml_primitive_get_closest_pos(&primitive, &pair), 0);
-     * pair.x = 0; pair.y = 0;
-     * adg_assert_isapprox(cpml_primitive_get_closest_pos(&primitive, &pair), 1);
-     */
+    pair.x = 6; pair.y = 7;
+    adg_assert_isapprox(cpml_primitive_get_closest_pos(&primitive, &pair), 0);
+    pair.x = -2; pair.y = 2;
+    adg_assert_isapprox(cpml_primitive_get_closest_pos(&primitive, &pair), 1);
+    pair.x = 10; pair.y = 10;
+    adg_assert_isapprox(cpml_primitive_get_closest_pos(&primitive, &pair), 0.164);
+    pair.x = -5; pair.y = 0;
+    adg_assert_isapprox(cpml_primitive_get_closest_pos(&primitive, &pair), 1);
 
     /* Close */
     cpml_primitive_next(&primitive);
@@ -1071,8 +1067,12 @@ _cpml_method_put_intersections(void)
 
     cpml_primitive_next(&primitive1);
 
-    /* primitive1 (1.3) does not intersect primitive2 (2.2) */
-    g_assert_cmpuint(cpml_primitive_put_intersections(&primitive1, &primitive2, 2, pair), ==, 0);
+    /* primitive1 (1.3) intersects primitive2 (2.2) outside the boundaries of 2.2 */
+    g_assert_cmpuint(cpml_primitive_put_intersections(&primitive1, &primitive2, 2, pair), ==, 1);
+    adg_assert_isapprox(pair[0].x, 1);
+    adg_assert_isapprox(pair[0].y, 4.237);
+    g_assert_cmpint(cpml_primitive_is_inside(&primitive1, pair), ==, 1);
+    g_assert_cmpint(cpml_primitive_is_inside(&primitive2, pair), ==, 0);
 
     cpml_primitive_next(&primitive1);
 
@@ -1228,6 +1228,218 @@ _cpml_method_put_intersections_circle_line(void)
     adg_assert_isapprox(pair[1].y, 19.587695734);
 }
 
+static void
+_cpml_method_put_intersections_circle_circle(void)
+{
+    /* Destination */
+    CpmlPair pair[2];
+
+    /* Arc PI .. -PI of radius 3 in (0, 0) */
+    cairo_path_data_t arc1_data[] = {
+        { .header = { CPML_MOVE, 2 }},
+        { .point = { 0, 3 }},
+
+        { .header = { CPML_ARC, 3 }},
+        { .point = { 3, 0 }},
+        { .point = { 0, -3 }}
+    };
+    CpmlPrimitive arc1 = {
+        NULL,
+        &arc1_data[1],
+        &arc1_data[2]
+    };
+
+    /* Arc PI .. -PI of radius 3 in (3, 0) */
+    cairo_path_data_t arc2_data[] = {
+        { .header = { CPML_MOVE, 2 }},
+        { .point = { 3, 3 }},
+
+        { .header = { CPML_ARC, 3 }},
+        { .point = { 6, 0 }},
+        { .point = { 3, -3 }}
+    };
+    CpmlPrimitive arc2 = {
+        NULL,
+        &arc2_data[1],
+        &arc2_data[2]
+    };
+
+    g_assert_cmpuint(cpml_primitive_put_intersections(&arc1, &arc2, 2, pair), ==, 2);
+    adg_assert_isapprox(pair[0].x, 1.5);
+    adg_assert_isapprox(pair[0].y, 2.598);
+    adg_assert_isapprox(pair[1].x, 1.5);
+    adg_assert_isapprox(pair[1].y, -2.598);
+
+    /* The destination buffer must not be overflowed */
+    g_assert_cmpuint(cpml_primitive_put_intersections(&arc1, &arc2, 1, pair), ==, 1);
+
+    /* Tangent circles: arc2 is now centered in (6, 0) */
+    arc2_data[1].point.x = arc2_data[4].point.x = 6;
+    arc2_data[3].point.x = 9;
+
+    g_assert_cmpuint(cpml_primitive_put_intersections(&arc2, &arc1, 2, pair), ==, 1);
+    adg_assert_isapprox(pair[0].x, 3);
+    adg_assert_isapprox(pair[0].y, 0);
+
+    /* Distant circles: arc2 is now centered in (7, 0) */
+    arc2_data[1].point.x = arc2_data[4].point.x = 7;
+    arc2_data[3].point.x = 10;
+
+    g_assert_cmpuint(cpml_primitive_put_intersections(&arc1, &arc2, 2, pair), ==, 0);
+
+    /* Concentric circles */
+    arc2_data[1].point.x = arc2_data[4].point.x = 0;
+    arc2_data[3].point.x = 3;
+
+    g_assert_cmpuint(cpml_primitive_put_intersections(&arc1, &arc2, 2, pair), ==, 0);
+}
+
+static void
+_cpml_method_put_intersections_curve(void)
+{
+    /* Destination */
+    CpmlPair pair[4];
+
+    /* Curve (1, 1) .. (3, 5), symmetric around (2, 3) */
+    cairo_path_data_t curve_data[] = {
+        { .header = { CPML_MOVE, 2 }},
+        { .point = { 1, 1 }},
+
+        { .header = { CPML_CURVE, 4 }},
+        { .point = { 1, 3 }},
+        { .point = { 3, 3 }},
+        { .point = { 3, 5 }}
+    };
+    CpmlPrimitive curve = {
+        NULL,
+        &curve_data[1],
+        &curve_data[2]
+    };
+
+    /* Line (0, 3) .. (4, 3) */
+    cairo_path_data_t line_data[] = {
+        { .header = { CPML_MOVE, 2 }},
+        { .point = { 0, 3 }},
+
+        { .header = { CPML_LINE, 2 }},
+        { .point = { 4, 3 }}
+    };
+    CpmlPrimitive line = {
+        NULL,
+        &line_data[1],
+        &line_data[2]
+    };
+
+    /* Circle of radius 1 in (2, 3) */
+    cairo_path_data_t arc_data[] = {
+        { .header = { CPML_MOVE, 2 }},
+        { .point = { 1, 3 }},
+
+        { .header = { CPML_ARC, 3 }},
+        { .point = { 3, 3 }},
+        { .point = { 1, 3 }}
+    };
+    CpmlPrimitive arc = {
+        NULL,
+        &arc_data[1],
+        &arc_data[2]
+    };
+
+    /* Mirrored curve (3, 1) .. (1, 5) */
+    cairo_path_data_t curve2_data[] = {
+        { .header = { CPML_MOVE, 2 }},
+        { .point = { 3, 1 }},
+
+        { .header = { CPML_CURVE, 4 }},
+        { .point = { 3, 3 }},
+        { .point = { 1, 3 }},
+        { .point = { 1, 5 }}
+    };
+    CpmlPrimitive curve2 = {
+        NULL,
+        &curve2_data[1],
+        &curve2_data[2]
+    };
+
+    /* Curve and line */
+    g_assert_cmpuint(cpml_primitive_put_intersections(&line, &curve, 4, pair), ==, 1);
+    adg_assert_isapprox(pair[0].x, 2);
+    adg_assert_isapprox(pair[0].y, 3);
+
+    /* Curve and arc: the intersections are on both primitives */
+    g_assert_cmpuint(cpml_primitive_put_intersections(&curve, &arc, 4, pair), ==, 2);
+    adg_assert_isapprox(pair[0].x, 1.347);
+    adg_assert_isapprox(pair[0].y, 2.243);
+    adg_assert_isapprox(pair[1].x, 2.653);
+    adg_assert_isapprox(pair[1].y, 3.757);
+
+    /* Curve and curve */
+    g_assert_cmpuint(cpml_primitive_put_intersections(&curve, &curve2, 4, pair), ==, 1);
+    adg_assert_isapprox(pair[0].x, 2);
+    adg_assert_isapprox(pair[0].y, 3);
+
+    /* Check that the intersection is not returned when not requested */
+    g_assert_cmpuint(cpml_primitive_put_intersections(&curve, &curve2, 0, pair), ==, 0);
+}
+
+static void
+_cpml_method_put_intersections_curve_circle(void)
+{
+    /* Destination */
+    CpmlPair pair[8];
+
+    /* Curve (3, 4) .. (-3, -4), symmetric around (0, 0), that goes
+     * back and forth the circle below: its distance from (0, 0) is
+     * 5, 0.72, 5.79, 0, 5.79, 0.72 and 5 at its extremes */
+    cairo_path_data_t curve_data[] = {
+        { .header = { CPML_MOVE, 2 }},
+        { .point = { 3, 4 }},
+
+        { .header = { CPML_CURVE, 4 }},
+        { .point = { -17, -22 }},
+        { .point = { 17, 22 }},
+        { .point = { -3, -4 }}
+    };
+    CpmlPrimitive curve = {
+        NULL,
+        &curve_data[1],
+        &curve_data[2]
+    };
+
+    /* Circle of radius 2.5 in (0, 0) */
+    cairo_path_data_t arc_data[] = {
+        { .header = { CPML_MOVE, 2 }},
+        { .point = { -2.5, 0 }},
+
+        { .header = { CPML_ARC, 3 }},
+        { .point = { 2.5, 0 }},
+        { .point = { -2.5, 0 }}
+    };
+    CpmlPrimitive arc = {
+        NULL,
+        &arc_data[1],
+        &arc_data[2]
+    };
+
+    /* A cubic curve can cross a circle up to 6 times */
+    g_assert_cmpuint(cpml_primitive_put_intersections(&curve, &arc, 8, pair), ==, 6);
+    adg_assert_isapprox(pair[0].x, 1.476);
+    adg_assert_isapprox(pair[0].y, 2.018);
+    adg_assert_isapprox(pair[1].x, -1.569);
+    adg_assert_isapprox(pair[1].y, -1.946);
+    adg_assert_isapprox(pair[2].x, -1.535);
+    adg_assert_isapprox(pair[2].y, -1.973);
+    adg_assert_isapprox(pair[3].x, 1.535);
+    adg_assert_isapprox(pair[3].y, 1.973);
+    adg_assert_isapprox(pair[4].x, 1.569);
+    adg_assert_isapprox(pair[4].y, 1.946);
+    adg_assert_isapprox(pair[5].x, -1.476);
+    adg_assert_isapprox(pair[5].y, -2.018);
+
+    /* The destination buffer must not be overflowed */
+    g_assert_cmpuint(cpml_primitive_put_intersections(&curve, &arc, 5, pair), ==, 5);
+}
+
 static void
 _cpml_method_put_intersections_with_segment(void)
 {
@@ -1517,6 +1729,9 @@ main(int argc, char *argv[])
     g_test_add_func("/cpml/primitive/method/put-point", _cpml_method_put_point);
     g_test_add_func("/cpml/primitive/method/put-intersections", _cpml_method_put_intersections);
     g_test_add_func("/cpml/primitive/method/put-intersections/circle-line", _cpml_method_put_intersections_circle_line);
+    g_test_add_func("/cpml/primitive/method/put-intersections/circle-circle", _cpml_method_put_intersections_circle_circle);
+    g_test_add_func("/cpml/primitive/method/put-intersections/curve", _cpml_method_put_intersections_curve);
+    g_test_add_func("/cpml/primitive/method/put-intersections/curve-circle", _cpml_method_put_intersections_curve_circle);
     g_test_add_func("/cpml/primitive/method/put-intersections-with-segment", _cpml_method_put_intersections_with_segment);
     g_test_add_func("/cpml/primitive/method/offset", _cpml_method_offset);
     g_test_add_func("/cpml/primitive/method/join", _cpml_method_join);
@@ -381,8 +381,7 @@ _cpml_method_get_length(void)
     cpml_segment_next(&segment);
 
     /* Third segment */
-    /* TODO: Bézier curve length not yet implemented
-     * g_assert_cmpfloat(cpml_segment_get_length(&segment), >, 0); */
+    g_assert_cmpfloat(cpml_segment_get_length(&segment), >, 0);
 
     cpml_segment_next(&segment);
 
@@ -416,6 +415,57 @@ _cpml_method_put_intersections(void)
     g_assert_cmpuint(cpml_segment_put_intersections(&segment1, &segment2, 10, pair), ==, 0);
 }
 
+static void
+_cpml_method_put_intersections_pruned(void)
+{
+    cairo_path_data_t zigzag_data[42], line_data[4];
+    cairo_path_t zigzag = { CAIRO_STATUS_SUCCESS, zigzag_data, 42 };
+    cairo_path_t line = { CAIRO_STATUS_SUCCESS, line_data, 4 };
+    CpmlSegment segment1, segment2;
+    CpmlPair pair[30];
+    gint n;
+
+    /* A zigzag of 20 lines crossing y = 1 */
+    for (n = 0; n <= 20; ++n) {
+        zigzag_data[n*2].header.type = n == 0 ? CPML_MOVE : CPML_LINE;
+        zigzag_data[n*2].header.length = 2;
+        zigzag_data[n*2+1].point.x = n;
+        zigzag_data[n*2+1].point.y = n % 2 ? 2 : 0;
+    }
+
+    line_data[0].header.type = CPML_MOVE;
+    line_data[0].header.length = 2;
+    line_data[1].point.x = -1;
+    line_data[1].point.y = 1;
+    line_data[2].header.type = CPML_LINE;
+    line_data[2].header.length = 2;
+    line_data[3].point.x = 5.2;
+    line_data[3].point.y = 1;
+
+    cpml_segment_from_cairo(&segment1, &zigzag);
+    cpml_segment_from_cairo(&segment2, &line);
+
+    /* Only the first 5 zigzag lines are crossed, in order */
+    g_assert_cmpuint(cpml_segment_put_intersections(&segment1, &segment2, 30, pair), ==, 5);
+    for (n = 0; n < 5; ++n) {
+        adg_assert_isapprox(pair[n].x, n + 0.5);
+        adg_assert_isapprox(pair[n].y, 1);
+    }
+
+    /* Same result swapping the segments */
+    g_assert_cmpuint(cpml_segment_put_intersections(&segment2, &segment1, 30, pair), ==, 5);
+    adg_assert_isapprox(pair[4].x, 4.5);
+
+    /* The destination buffer must not be overflowed */
+    g_assert_cmpuint(cpml_segment_put_intersections(&segment1, &segment2, 3, pair), ==, 3);
+    adg_assert_isapprox(pair[2].x, 2.5);
+
+    /* Extend the line to cross the whole zigzag */
+    line_data[3].point.x = 30;
+    g_assert_cmpuint(cpml_segment_put_intersections(&segment1, &segment2, 30, pair), ==, 20);
+    adg_assert_isapprox(pair[19].x, 19.5);
+}
+
 static void
 _cpml_method_offset(void)
 {
@@ -595,6 +645,7 @@ main(int argc, char *argv[])
     g_test_add_func("/cpml/segment/method/copy-data", _cpml_method_copy_data);
     g_test_add_func("/cpml/segment/method/get-length", _cpml_method_get_length);
     g_test_add_func("/cpml/segment/method/put-intersections", _cpml_method_put_intersections);
+    g_test_add_func("/cpml/segment/method/put-intersections-pruned", _cpml_method_put_intersections_pruned);
     g_test_add_func("/cpml/segment/method/offset", _cpml_method_offset);
     g_test_add_func("/cpml/segment/method/transform", _cpml_method_transform);
     g_test_add_func("/cpml/segment/method/reverse", _cpml_method_reverse);
@@ -97,6 +97,20 @@ adg_test_cairo_context(void)
     return cr;
 }
 
+gboolean
+adg_test_cairo_is_painted(cairo_t *cr, int x, int y)
+{
+    cairo_surface_t *surface = cairo_get_target(cr);
+    const guint32 *row;
+
+    /* Checks the alpha of the (x, y) pixel of an ARGB32 target */
+    cairo_surface_flush(surface);
+    row = (const guint32 *) (cairo_image_surface_get_data(surface) +
+                             y * cairo_image_surface_get_stride(surface));
+
+    return (row[x] >> 24) != 0;
+}
+
 int
 adg_test_cairo_num_data(cairo_t *cr)
 {
@@ -115,6 +115,9 @@ void            adg_test_init                   (int            *p_argc,
                                                  char          **p_argv[]);
 const gpointer  adg_test_invalid_pointer        (void);
 cairo_t *       adg_test_cairo_context          (void);
+gboolean        adg_test_cairo_is_painted       (cairo_t        *cr,
+                                                 int             x,
+                                                 int             y);
 int             adg_test_cairo_num_data         (cairo_t        *cr);
 const cairo_path_t *
                 adg_test_path                   (void);